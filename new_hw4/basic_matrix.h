@@ -0,0 +1,411 @@
+#ifndef BASIC_MATRIX_H
+#define BASIC_MATRIX_H
+
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <initializer_list>
+#include <type_traits>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include "aligned_allocator.h"
+#include "matrix_expr.h"
+#include "gemm.h"
+#include "elementwise.h"
+
+// Matrix of any arithmetic element type: BasicMatrix<float> for
+// single-precision work, BasicMatrix<int> and friends for integer data.
+//
+// Matrix is BasicMatrix<double>, an explicit specialization (matrix.h)
+// that adds expression templates, views and the linear solvers on top of
+// the interface below. The generic version provides the core Matrix
+// operations with eager arithmetic; the class is separate, but for float
+// the work runs in the same kernels Matrix uses. +, -, scaling and
+// negation take the float versions of the SIMD element-wise kernels, and
+// products run the blocked GEMM engine in the mode chosen with
+// kernels::setFloatAccumulation: accumulated in double by default
+// (gemmMixed, double speed) or in float (gemmFloat, float speed).
+template <typename T>
+class BasicMatrix {
+private:
+    static_assert(std::is_arithmetic<T>::value, "Matrix elements must be arithmetic");
+
+    std::vector<T, AlignedAllocator<T>> data_;
+    size_t num_rows_;
+    size_t num_cols_;
+
+    // Tolerance of operator== for floating-point elements (integers
+    // compare exactly)
+    static constexpr double EPSILON = sizeof(T) < sizeof(double) ? 1e-5 : 1e-9;
+
+    // Helper function for floating-point comparison
+    static bool almostEqual(T a, T b);
+
+    // Helper function for checking operand shapes
+    void requireSameShape(const BasicMatrix& other, const char* message) const;
+
+public:
+    using value_type = T;
+
+    // ========== CONSTRUCTORS ==========
+
+    BasicMatrix();
+    BasicMatrix(size_t rows, size_t cols);
+    BasicMatrix(size_t rows, size_t cols, T value);
+    BasicMatrix(std::initializer_list<std::initializer_list<T>> list);
+
+    // ========== ELEMENT ACCESS ==========
+
+    T& operator()(size_t row, size_t col) { return data_[row * num_cols_ + col]; }
+    const T& operator()(size_t row, size_t col) const { return data_[row * num_cols_ + col]; }
+
+    // Access with bounds checking (throw std::out_of_range)
+    T& at(size_t row, size_t col);
+    const T& at(size_t row, size_t col) const;
+
+    // Row-major element storage
+    T* data() { return data_.data(); }
+    const T* data() const { return data_.data(); }
+
+    // ========== SIZE AND PROPERTIES ==========
+
+    size_t rows() const { return num_rows_; }
+    size_t cols() const { return num_cols_; }
+    bool isEmpty() const { return num_rows_ == 0 || num_cols_ == 0; }
+    bool isSquare() const { return num_rows_ == num_cols_ && num_rows_ > 0; }
+
+    // ========== ARITHMETIC OPERATORS ==========
+
+    BasicMatrix operator+(const BasicMatrix& other) const;
+    BasicMatrix operator-(const BasicMatrix& other) const;
+    BasicMatrix operator*(const BasicMatrix& other) const;
+    BasicMatrix operator*(T scalar) const;
+    BasicMatrix operator/(T scalar) const;
+    BasicMatrix operator-() const;
+
+    friend BasicMatrix operator*(T scalar, const BasicMatrix& m) {
+        return m * scalar;
+    }
+
+    // ========== COMPOUND ASSIGNMENT OPERATORS ==========
+
+    BasicMatrix& operator+=(const BasicMatrix& other);
+    BasicMatrix& operator-=(const BasicMatrix& other);
+    BasicMatrix& operator*=(const BasicMatrix& other);
+    BasicMatrix& operator*=(T scalar);
+    BasicMatrix& operator/=(T scalar);
+
+    // ========== COMPARISON OPERATORS ==========
+
+    bool operator==(const BasicMatrix& other) const;
+    bool operator!=(const BasicMatrix& other) const;
+
+    // ========== MATRIX OPERATIONS ==========
+
+    BasicMatrix transpose() const;
+    T trace() const;
+    void fill(T value);
+
+    // Frobenius norm, accumulated in double
+    double norm() const;
+
+    // ========== STATIC FACTORY METHODS ==========
+
+    static BasicMatrix identity(size_t n);
+    static BasicMatrix zeros(size_t rows, size_t cols);
+    static BasicMatrix ones(size_t rows, size_t cols);
+
+    // ========== STREAM OPERATORS ==========
+
+    friend std::ostream& operator<<(std::ostream& os, const BasicMatrix& m) {
+        os << "[";
+        for (size_t i = 0; i < m.num_rows_; ++i) {
+            if (i > 0) os << " ";
+            os << "[";
+            for (size_t j = 0; j < m.num_cols_; ++j) {
+                os << +m(i, j);
+                if (j < m.num_cols_ - 1) os << ", ";
+            }
+            os << "]";
+            if (i < m.num_rows_ - 1) os << "\n";
+        }
+        os << "]";
+        return os;
+    }
+};
+
+using FloatMatrix = BasicMatrix<float>;
+
+// Convert between element types (including to and from Matrix), rounding
+// or truncating each element as static_cast does
+template <typename To, typename From>
+BasicMatrix<To> matrix_cast(const BasicMatrix<From>& m) {
+    BasicMatrix<To> result(m.rows(), m.cols());
+    const From* in = m.data();
+    To* out = result.data();
+    for (size_t i = 0; i < m.rows() * m.cols(); ++i) {
+        out[i] = static_cast<To>(in[i]);
+    }
+    return result;
+}
+
+// ========== IMPLEMENTATION ==========
+
+template <typename T>
+bool BasicMatrix<T>::almostEqual(T a, T b) {
+    if (std::is_integral<T>::value) {
+        return a == b;
+    }
+    return std::abs(static_cast<double>(a) - static_cast<double>(b)) < EPSILON;
+}
+
+template <typename T>
+void BasicMatrix<T>::requireSameShape(const BasicMatrix& other, const char* message) const {
+    if (num_rows_ != other.num_rows_ || num_cols_ != other.num_cols_) {
+        throw std::invalid_argument(message);
+    }
+}
+
+template <typename T>
+BasicMatrix<T>::BasicMatrix() : num_rows_(0), num_cols_(0) {}
+
+template <typename T>
+BasicMatrix<T>::BasicMatrix(size_t rows, size_t cols)
+    : data_(rows * cols, T()), num_rows_(rows), num_cols_(cols) {}
+
+template <typename T>
+BasicMatrix<T>::BasicMatrix(size_t rows, size_t cols, T value)
+    : data_(rows * cols, value), num_rows_(rows), num_cols_(cols) {}
+
+template <typename T>
+BasicMatrix<T>::BasicMatrix(std::initializer_list<std::initializer_list<T>> list)
+    : num_rows_(list.size()), num_cols_(list.size() == 0 ? 0 : list.begin()->size()) {
+    data_.reserve(num_rows_ * num_cols_);
+    for (const auto& row : list) {
+        if (row.size() != num_cols_) {
+            throw std::invalid_argument("All rows must have the same number of columns");
+        }
+        data_.insert(data_.end(), row.begin(), row.end());
+    }
+}
+
+template <typename T>
+T& BasicMatrix<T>::at(size_t row, size_t col) {
+    if (row >= num_rows_ || col >= num_cols_) {
+        throw std::out_of_range("Matrix index out of range");
+    }
+    return (*this)(row, col);
+}
+
+template <typename T>
+const T& BasicMatrix<T>::at(size_t row, size_t col) const {
+    if (row >= num_rows_ || col >= num_cols_) {
+        throw std::out_of_range("Matrix index out of range");
+    }
+    return (*this)(row, col);
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::operator+(const BasicMatrix& other) const {
+    BasicMatrix result(*this);
+    result += other;
+    return result;
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::operator-(const BasicMatrix& other) const {
+    BasicMatrix result(*this);
+    result -= other;
+    return result;
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::operator*(const BasicMatrix& other) const {
+    if (num_cols_ != other.num_rows_) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    BasicMatrix result(num_rows_, other.num_cols_);
+    if constexpr (std::is_same<T, float>::value) {
+        if (kernels::floatAccumulation() == kernels::FloatAccumulation::Single) {
+            kernels::gemmFloat(num_rows_, other.num_cols_, num_cols_, 1.0f,
+                               data(), num_cols_, 1, other.data(), other.num_cols_, 1,
+                               result.data(), result.num_cols_);
+        } else {
+            kernels::gemmMixed(num_rows_, other.num_cols_, num_cols_, 1.0,
+                               data(), num_cols_, 1, other.data(), other.num_cols_, 1,
+                               result.data(), result.num_cols_);
+        }
+    } else {
+        // i-k-j order keeps the inner loop on contiguous rows
+        for (size_t i = 0; i < num_rows_; ++i) {
+            T* c_row = result.data() + i * result.num_cols_;
+            for (size_t p = 0; p < num_cols_; ++p) {
+                T a_ip = (*this)(i, p);
+                const T* b_row = other.data() + p * other.num_cols_;
+                for (size_t j = 0; j < other.num_cols_; ++j) {
+                    c_row[j] += a_ip * b_row[j];
+                }
+            }
+        }
+    }
+    return result;
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::operator*(T scalar) const {
+    BasicMatrix result(*this);
+    result *= scalar;
+    return result;
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::operator/(T scalar) const {
+    BasicMatrix result(*this);
+    result /= scalar;
+    return result;
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::operator-() const {
+    BasicMatrix result(num_rows_, num_cols_);
+    if constexpr (std::is_same<T, float>::value) {
+        kernels::scale(data_.size(), -1.0f, data_.data(), result.data_.data());
+        return result;
+    }
+    for (size_t i = 0; i < data_.size(); ++i) {
+        result.data_[i] = -data_[i];
+    }
+    return result;
+}
+
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator+=(const BasicMatrix& other) {
+    requireSameShape(other, "Matrix dimensions must match for addition");
+    if constexpr (std::is_same<T, float>::value) {
+        kernels::add(data_.size(), data_.data(), other.data_.data(), data_.data());
+        return *this;
+    }
+    for (size_t i = 0; i < data_.size(); ++i) {
+        data_[i] += other.data_[i];
+    }
+    return *this;
+}
+
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator-=(const BasicMatrix& other) {
+    requireSameShape(other, "Matrix dimensions must match for subtraction");
+    if constexpr (std::is_same<T, float>::value) {
+        kernels::subtract(data_.size(), data_.data(), other.data_.data(), data_.data());
+        return *this;
+    }
+    for (size_t i = 0; i < data_.size(); ++i) {
+        data_[i] -= other.data_[i];
+    }
+    return *this;
+}
+
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator*=(const BasicMatrix& other) {
+    *this = (*this) * other;
+    return *this;
+}
+
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator*=(T scalar) {
+    if constexpr (std::is_same<T, float>::value) {
+        kernels::scale(data_.size(), scalar, data_.data(), data_.data());
+        return *this;
+    }
+    for (T& value : data_) {
+        value *= scalar;
+    }
+    return *this;
+}
+
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator/=(T scalar) {
+    if (almostEqual(scalar, T())) {
+        throw std::invalid_argument("Division by zero");
+    }
+    for (T& value : data_) {
+        value /= scalar;
+    }
+    return *this;
+}
+
+template <typename T>
+bool BasicMatrix<T>::operator==(const BasicMatrix& other) const {
+    if (num_rows_ != other.num_rows_ || num_cols_ != other.num_cols_) {
+        return false;
+    }
+    for (size_t i = 0; i < data_.size(); ++i) {
+        if (!almostEqual(data_[i], other.data_[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+bool BasicMatrix<T>::operator!=(const BasicMatrix& other) const {
+    return !(*this == other);
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::transpose() const {
+    BasicMatrix result(num_cols_, num_rows_);
+    for (size_t i = 0; i < num_rows_; ++i) {
+        for (size_t j = 0; j < num_cols_; ++j) {
+            result(j, i) = (*this)(i, j);
+        }
+    }
+    return result;
+}
+
+template <typename T>
+T BasicMatrix<T>::trace() const {
+    if (!isSquare()) {
+        throw std::logic_error("Trace requires square matrix");
+    }
+    T sum = T();
+    for (size_t i = 0; i < num_rows_; ++i) {
+        sum += (*this)(i, i);
+    }
+    return sum;
+}
+
+template <typename T>
+void BasicMatrix<T>::fill(T value) {
+    std::fill(data_.begin(), data_.end(), value);
+}
+
+template <typename T>
+double BasicMatrix<T>::norm() const {
+    double sum = 0.0;
+    for (T value : data_) {
+        sum += static_cast<double>(value) * static_cast<double>(value);
+    }
+    return std::sqrt(sum);
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::identity(size_t n) {
+    BasicMatrix result(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        result(i, i) = T(1);
+    }
+    return result;
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::zeros(size_t rows, size_t cols) {
+    return BasicMatrix(rows, cols);
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::ones(size_t rows, size_t cols) {
+    return BasicMatrix(rows, cols, T(1));
+}
+
+#endif // BASIC_MATRIX_H
@@ -0,0 +1,214 @@
+#include "batched.h"
+#include "gemm.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <functional>
+
+namespace kernels {
+
+namespace {
+
+size_t ceilDiv(size_t value, size_t divisor) {
+    return (value + divisor - 1) / divisor;
+}
+
+// Run fn(begin, end) over [0, count) units of work_per_unit multiply-adds
+// each, split across the global pool when the total is big enough
+void forEachRange(size_t count, size_t work_per_unit,
+                  const std::function<void(size_t, size_t)>& fn) {
+    size_t threads = numThreads();
+    if (threads <= 1 || count < 2 || count * work_per_unit < gemmParallelThreshold()) {
+        fn(0, count);
+        return;
+    }
+
+    // A few ranges per thread so uneven progress evens out
+    size_t chunk = ceilDiv(count, std::min(count, 4 * threads));
+    ThreadPool::global().parallelFor(ceilDiv(count, chunk), [&](size_t t) {
+        fn(t * chunk, std::min(count, (t + 1) * chunk));
+    });
+}
+
+// ========== CONTIGUOUS KERNELS ==========
+
+// Compile-time bounds let the compiler unroll every loop; __restrict
+// lets it keep rows of C in registers instead of reloading after stores
+template <size_t M, size_t N, size_t K>
+void contiguousFixed(const double* __restrict A, const double* __restrict B,
+                     double* __restrict C, size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+        const double* a = A + b * M * K;
+        const double* bm = B + b * K * N;
+        double* c = C + b * M * N;
+        for (size_t i = 0; i < M; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                c[i * N + j] = 0.0;
+            }
+            for (size_t p = 0; p < K; ++p) {
+                double a_ip = a[i * K + p];
+                for (size_t j = 0; j < N; ++j) {
+                    c[i * N + j] += a_ip * bm[p * N + j];
+                }
+            }
+        }
+    }
+}
+
+void contiguousGeneric(size_t m, size_t n, size_t k, const double* A, const double* B,
+                       double* C, size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+        const double* a = A + b * m * k;
+        const double* bm = B + b * k * n;
+        double* c = C + b * m * n;
+        std::fill(c, c + m * n, 0.0);
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t p = 0; p < k; ++p) {
+                double a_ip = a[i * k + p];
+                for (size_t j = 0; j < n; ++j) {
+                    c[i * n + j] += a_ip * bm[p * n + j];
+                }
+            }
+        }
+    }
+}
+
+// ========== INTERLEAVED KERNELS ==========
+
+// Each element of C is accumulated for a whole pack at once; the lane
+// loop is unit-stride and becomes one vector operation per step
+template <size_t M, size_t N, size_t K>
+void interleavedFixed(const double* A, const double* B, double* C,
+                      size_t first_pack, size_t end_pack) {
+    for (size_t pack = first_pack; pack < end_pack; ++pack) {
+        const double* a = A + pack * M * K * BATCH_LANES;
+        const double* bm = B + pack * K * N * BATCH_LANES;
+        double* c = C + pack * M * N * BATCH_LANES;
+        for (size_t i = 0; i < M; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                double acc[BATCH_LANES] = {};
+                for (size_t p = 0; p < K; ++p) {
+                    const double* a_ip = a + (i * K + p) * BATCH_LANES;
+                    const double* b_pj = bm + (p * N + j) * BATCH_LANES;
+                    for (size_t l = 0; l < BATCH_LANES; ++l) {
+                        acc[l] += a_ip[l] * b_pj[l];
+                    }
+                }
+                std::copy(acc, acc + BATCH_LANES, c + (i * N + j) * BATCH_LANES);
+            }
+        }
+    }
+}
+
+void interleavedGeneric(size_t m, size_t n, size_t k, const double* A, const double* B,
+                        double* C, size_t first_pack, size_t end_pack) {
+    for (size_t pack = first_pack; pack < end_pack; ++pack) {
+        const double* a = A + pack * m * k * BATCH_LANES;
+        const double* bm = B + pack * k * n * BATCH_LANES;
+        double* c = C + pack * m * n * BATCH_LANES;
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                double acc[BATCH_LANES] = {};
+                for (size_t p = 0; p < k; ++p) {
+                    const double* a_ip = a + (i * k + p) * BATCH_LANES;
+                    const double* b_pj = bm + (p * n + j) * BATCH_LANES;
+                    for (size_t l = 0; l < BATCH_LANES; ++l) {
+                        acc[l] += a_ip[l] * b_pj[l];
+                    }
+                }
+                std::copy(acc, acc + BATCH_LANES, c + (i * n + j) * BATCH_LANES);
+            }
+        }
+    }
+}
+
+// ========== DISPATCH ==========
+
+struct FixedKernels {
+    void (*contiguous)(const double*, const double*, double*, size_t, size_t);
+    void (*interleaved)(const double*, const double*, double*, size_t, size_t);
+};
+
+template <size_t S>
+const FixedKernels* squareKernels() {
+    static const FixedKernels kernels = {contiguousFixed<S, S, S>, interleavedFixed<S, S, S>};
+    return &kernels;
+}
+
+// Unrolled kernels for the shape, or nullptr for the generic loops
+const FixedKernels* fixedKernels(size_t m, size_t n, size_t k) {
+    if (m != n || n != k) {
+        return nullptr;
+    }
+    switch (m) {
+        case 2: return squareKernels<2>();
+        case 3: return squareKernels<3>();
+        case 4: return squareKernels<4>();
+        case 6: return squareKernels<6>();
+        case 8: return squareKernels<8>();
+        default: return nullptr;
+    }
+}
+
+} // namespace
+
+// ========== BATCH LAYOUTS ==========
+
+size_t interleavedSize(size_t batch, size_t rows, size_t cols) {
+    return ceilDiv(batch, BATCH_LANES) * BATCH_LANES * rows * cols;
+}
+
+void interleave(size_t batch, size_t rows, size_t cols, const double* src, double* dst) {
+    size_t size = rows * cols;
+    size_t padded = ceilDiv(batch, BATCH_LANES) * BATCH_LANES;
+    for (size_t b = 0; b < padded; ++b) {
+        double* pack = dst + (b / BATCH_LANES) * size * BATCH_LANES + b % BATCH_LANES;
+        for (size_t e = 0; e < size; ++e) {
+            pack[e * BATCH_LANES] = b < batch ? src[b * size + e] : 0.0;
+        }
+    }
+}
+
+void deinterleave(size_t batch, size_t rows, size_t cols, const double* src, double* dst) {
+    size_t size = rows * cols;
+    for (size_t b = 0; b < batch; ++b) {
+        const double* pack = src + (b / BATCH_LANES) * size * BATCH_LANES + b % BATCH_LANES;
+        for (size_t e = 0; e < size; ++e) {
+            dst[b * size + e] = pack[e * BATCH_LANES];
+        }
+    }
+}
+
+// ========== BATCHED MULTIPLY ==========
+
+void batchedMultiply(size_t batch, size_t m, size_t n, size_t k,
+                     const double* A, const double* B, double* C) {
+    if (batch == 0 || m == 0 || n == 0) {
+        return;
+    }
+    const FixedKernels* fixed = fixedKernels(m, n, k);
+    forEachRange(batch, m * n * k, [&](size_t begin, size_t end) {
+        if (fixed) {
+            fixed->contiguous(A, B, C, begin, end);
+        } else {
+            contiguousGeneric(m, n, k, A, B, C, begin, end);
+        }
+    });
+}
+
+void batchedMultiplyInterleaved(size_t batch, size_t m, size_t n, size_t k,
+                                const double* A, const double* B, double* C) {
+    if (batch == 0 || m == 0 || n == 0) {
+        return;
+    }
+    const FixedKernels* fixed = fixedKernels(m, n, k);
+    size_t packs = ceilDiv(batch, BATCH_LANES);
+    forEachRange(packs, m * n * k * BATCH_LANES, [&](size_t begin, size_t end) {
+        if (fixed) {
+            fixed->interleaved(A, B, C, begin, end);
+        } else {
+            interleavedGeneric(m, n, k, A, B, C, begin, end);
+        }
+    });
+}
+
+} // namespace kernels
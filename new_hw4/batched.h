@@ -0,0 +1,61 @@
+#ifndef BATCHED_H
+#define BATCHED_H
+
+#include <cstddef>
+
+namespace kernels {
+
+// ========== BATCHED PARAMETERS ==========
+
+// Matrices the interleaved layout stores side by side, one per SIMD lane
+// (a full AVX-512 register of doubles, or two AVX2 registers)
+constexpr size_t BATCH_LANES = 8;
+
+// ========== BATCH LAYOUTS ==========
+
+// A batch of `batch` rows x cols matrices is stored in one array in one of
+// two layouts:
+//
+//   contiguous:  matrix b is row-major at [b * rows * cols, (b + 1) * rows * cols)
+//   interleaved: matrices are grouped in packs of BATCH_LANES; element
+//                (i, j) of matrix b is at
+//                (b / BATCH_LANES) * rows * cols * BATCH_LANES
+//                    + (i * cols + j) * BATCH_LANES + b % BATCH_LANES
+//
+// Interleaving puts the same element of neighbouring matrices side by
+// side, so the multiply vectorizes across the batch however small the
+// matrices are, and each pack stays contiguous in cache. The last pack is
+// padded to full width.
+
+// Doubles needed to hold a batch in the interleaved layout
+size_t interleavedSize(size_t batch, size_t rows, size_t cols);
+
+// Convert a batch from the contiguous to the interleaved layout (dst holds
+// interleavedSize() doubles; padding lanes are set to zero)
+void interleave(size_t batch, size_t rows, size_t cols, const double* src, double* dst);
+
+// Convert a batch from the interleaved to the contiguous layout
+void deinterleave(size_t batch, size_t rows, size_t cols, const double* src, double* dst);
+
+// ========== BATCHED MULTIPLY ==========
+
+// C_b = A_b * B_b for every b in [0, batch), with every A_b m x k and
+// every B_b k x n. C is overwritten, not accumulated into, and must not
+// overlap A or B. Square 2x2, 3x3, 4x4, 6x6 and 8x8 products use fully
+// unrolled kernels; other shapes use a generic loop. Batches whose total
+// m * n * k * batch reaches gemmParallelThreshold() are split across the
+// global thread pool.
+
+// Both operands and C in the contiguous layout
+void batchedMultiply(size_t batch, size_t m, size_t n, size_t k,
+                     const double* A, const double* B, double* C);
+
+// Both operands and C in the interleaved layout (padding lanes are
+// multiplied along with the rest). Every shape vectorizes fully here; the
+// contiguous kernels do well up to 4x4 but are ~3x slower at 8x8.
+void batchedMultiplyInterleaved(size_t batch, size_t m, size_t n, size_t k,
+                                const double* A, const double* B, double* C);
+
+} // namespace kernels
+
+#endif // BATCHED_H
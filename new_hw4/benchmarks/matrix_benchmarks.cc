@@ -0,0 +1,590 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+#include "matrix.h"
+#include "batched.h"
+#include "fixed_matrix.h"
+#include "vector.h"
+#include "shared_matrix.h"
+#include "eigen.h"
+#include "svd.h"
+#include "krylov.h"
+#include "tiled_matrix.h"
+#include "thread_pool.h"
+#include "strassen.h"
+
+// Built by `make bench` at -O3 without the sanitizer; see the Makefile.
+// Every benchmark takes the matrix dimension n as its argument and reports
+// bytes/s (memory-bound operations) or FLOP/s (multiply).
+
+namespace {
+
+// n x n matrix with deterministic non-trivial values
+Matrix benchMatrix(size_t n, double seed) {
+    Matrix m(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            m(i, j) = std::sin(seed + 0.37 * i + 0.11 * j);
+        }
+    }
+    return m;
+}
+
+// Symmetric n x n matrix of full rank (benchMatrix has rank 2, which
+// would let the decompositions deflate almost immediately)
+Matrix symmetricBenchMatrix(size_t n) {
+    Matrix m(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            m(i, j) = std::sin(0.37 * (i + j) + 0.13 * i * j);
+        }
+    }
+    return m;
+}
+
+// 5-point Laplacian on a grid x grid mesh
+SparseMatrix poissonBenchMatrix(size_t grid) {
+    std::vector<SparseMatrix::Triplet> triplets;
+    for (size_t i = 0; i < grid; ++i) {
+        for (size_t j = 0; j < grid; ++j) {
+            size_t row = i * grid + j;
+            triplets.push_back({row, row, 4.0});
+            if (i > 0) triplets.push_back({row, row - grid, -1.0});
+            if (i + 1 < grid) triplets.push_back({row, row + grid, -1.0});
+            if (j > 0) triplets.push_back({row, row - 1, -1.0});
+            if (j + 1 < grid) triplets.push_back({row, row + 1, -1.0});
+        }
+    }
+    return SparseMatrix::fromTriplets(grid * grid, grid * grid, triplets);
+}
+
+// Bytes moved per iteration for `matrices` passes over an n x n matrix
+void setBytes(benchmark::State& state, size_t n, size_t matrices) {
+    state.SetBytesProcessed(int64_t(state.iterations()) *
+                            int64_t(matrices * n * n * sizeof(double)));
+}
+
+void setFlops(benchmark::State& state, double flops_per_iteration) {
+    state.counters["FLOP/s"] = benchmark::Counter(
+        flops_per_iteration, benchmark::Counter::kIsIterationInvariantRate,
+        benchmark::Counter::OneK::kIs1000);
+}
+
+} // namespace
+
+// ========== CONSTRUCTION ==========
+
+static void BM_ConstructZeros(benchmark::State& state) {
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        Matrix m(n, n);
+        benchmark::DoNotOptimize(m.data());
+    }
+    setBytes(state, n, 1);
+}
+BENCHMARK(BM_ConstructZeros)->RangeMultiplier(4)->Range(16, 1024);
+
+static void BM_CopyConstruct(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0);
+    for (auto _ : state) {
+        Matrix m(a);
+        benchmark::DoNotOptimize(m.data());
+    }
+    setBytes(state, n, 2);
+}
+BENCHMARK(BM_CopyConstruct)->RangeMultiplier(4)->Range(16, 1024);
+
+// Copy-on-write copy: a reference count increment regardless of size
+static void BM_CopyShared(benchmark::State& state) {
+    size_t n = state.range(0);
+    SharedMatrix a(benchMatrix(n, 1.0));
+    for (auto _ : state) {
+        SharedMatrix m(a);
+        benchmark::DoNotOptimize(m.data());
+    }
+}
+BENCHMARK(BM_CopyShared)->RangeMultiplier(4)->Range(16, 1024);
+
+// ========== ELEMENT ACCESS ==========
+
+// Sum every element through operator() (unchecked)
+static void BM_AccessOperator(benchmark::State& state) {
+    size_t n = state.range(0);
+    const Matrix a = benchMatrix(n, 1.0);
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                sum += a(i, j);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    setBytes(state, n, 1);
+}
+BENCHMARK(BM_AccessOperator)->RangeMultiplier(4)->Range(16, 1024);
+
+// The same loop through at(), which checks bounds on every access
+static void BM_AccessAt(benchmark::State& state) {
+    size_t n = state.range(0);
+    const Matrix a = benchMatrix(n, 1.0);
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                sum += a.at(i, j);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    setBytes(state, n, 1);
+}
+BENCHMARK(BM_AccessAt)->RangeMultiplier(4)->Range(16, 1024);
+
+// ========== ELEMENT-WISE OPERATIONS ==========
+
+static void BM_Add(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0), b = benchMatrix(n, 2.0), c(n, n);
+    for (auto _ : state) {
+        c = a + b;
+        benchmark::DoNotOptimize(c.data());
+    }
+    setBytes(state, n, 3);
+}
+BENCHMARK(BM_Add)->RangeMultiplier(4)->Range(16, 1024);
+
+static void BM_AddAssign(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0), b = benchMatrix(n, 2.0);
+    for (auto _ : state) {
+        a += b;
+        benchmark::DoNotOptimize(a.data());
+    }
+    setBytes(state, n, 3);
+}
+BENCHMARK(BM_AddAssign)->RangeMultiplier(4)->Range(16, 1024);
+
+static void BM_Scale(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0), c(n, n);
+    for (auto _ : state) {
+        c = a * 1.5;
+        benchmark::DoNotOptimize(c.data());
+    }
+    setBytes(state, n, 2);
+}
+BENCHMARK(BM_Scale)->RangeMultiplier(4)->Range(16, 1024);
+
+// Three-operand expression evaluated in one fused pass
+static void BM_FusedExpression(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0), b = benchMatrix(n, 2.0), c = benchMatrix(n, 3.0);
+    Matrix d(n, n);
+    for (auto _ : state) {
+        d = a + 2.0 * b - c;
+        benchmark::DoNotOptimize(d.data());
+    }
+    setBytes(state, n, 4);
+}
+BENCHMARK(BM_FusedExpression)->RangeMultiplier(4)->Range(16, 1024);
+
+// ========== TRANSPOSE ==========
+
+static void BM_Transpose(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0);
+    for (auto _ : state) {
+        Matrix t = a.transpose();
+        benchmark::DoNotOptimize(t.data());
+    }
+    setBytes(state, n, 2);
+}
+BENCHMARK(BM_Transpose)->RangeMultiplier(4)->Range(16, 4096);
+
+static void BM_TransposeInPlace(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0);
+    for (auto _ : state) {
+        a.transposeInPlace();
+        benchmark::DoNotOptimize(a.data());
+    }
+    setBytes(state, n, 2);
+}
+BENCHMARK(BM_TransposeInPlace)->RangeMultiplier(4)->Range(16, 4096);
+
+// ========== MULTIPLY ==========
+
+static void BM_Multiply(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0), b = benchMatrix(n, 2.0);
+    for (auto _ : state) {
+        Matrix c = a * b;
+        benchmark::DoNotOptimize(c.data());
+    }
+    setFlops(state, 2.0 * n * n * n);
+}
+BENCHMARK(BM_Multiply)->RangeMultiplier(2)->Range(8, 1024)->Unit(benchmark::kMicrosecond);
+
+// Into preallocated storage, so the timing excludes the allocation
+static void BM_MultiplyInto(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0), b = benchMatrix(n, 2.0), c(n, n);
+    for (auto _ : state) {
+        multiply_into(a, b, c);
+        benchmark::DoNotOptimize(c.data());
+    }
+    setFlops(state, 2.0 * n * n * n);
+}
+BENCHMARK(BM_MultiplyInto)->RangeMultiplier(2)->Range(8, 1024)->Unit(benchmark::kMicrosecond);
+
+// Parallel scaling at a fixed size; the second argument is the thread count
+static void BM_MultiplyThreads(benchmark::State& state) {
+    size_t n = state.range(0);
+    size_t saved = kernels::numThreads();
+    kernels::setNumThreads(state.range(1));
+    Matrix a = benchMatrix(n, 1.0), b = benchMatrix(n, 2.0), c(n, n);
+    for (auto _ : state) {
+        multiply_into(a, b, c);
+        benchmark::DoNotOptimize(c.data());
+    }
+    kernels::setNumThreads(saved);
+    setFlops(state, 2.0 * n * n * n);
+}
+BENCHMARK(BM_MultiplyThreads)
+    ->ArgsProduct({{1024}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Strassen against the threaded GEMM at the same thread count: arguments
+// are size, thread count and 1 for Strassen (threshold = size)
+static void BM_StrassenThreads(benchmark::State& state) {
+    size_t n = state.range(0);
+    size_t saved = kernels::numThreads();
+    size_t saved_threshold = kernels::strassenThreshold();
+    kernels::setNumThreads(state.range(1));
+    kernels::setStrassenThreshold(state.range(2) ? n : 0);
+    Matrix a = benchMatrix(n, 1.0), b = benchMatrix(n, 2.0), c(n, n);
+    for (auto _ : state) {
+        multiply_into(a, b, c);
+        benchmark::DoNotOptimize(c.data());
+    }
+    kernels::setStrassenThreshold(saved_threshold);
+    kernels::setNumThreads(saved);
+    setFlops(state, 2.0 * n * n * n);
+}
+BENCHMARK(BM_StrassenThreads)
+    ->ArgsProduct({{2048, 4096}, {1, 4, 8, 16, 32}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// FloatMatrix products: the second argument is 0 for double accumulation
+// (gemmMixed) and 1 for float accumulation (gemmFloat)
+static void BM_FloatMultiply(benchmark::State& state) {
+    size_t n = state.range(0);
+    kernels::setFloatAccumulation(state.range(1) ? kernels::FloatAccumulation::Single
+                                                 : kernels::FloatAccumulation::Double);
+    FloatMatrix a = matrix_cast<float>(benchMatrix(n, 1.0));
+    FloatMatrix b = matrix_cast<float>(benchMatrix(n, 2.0));
+    for (auto _ : state) {
+        FloatMatrix c = a * b;
+        benchmark::DoNotOptimize(c.data());
+    }
+    kernels::setFloatAccumulation(kernels::FloatAccumulation::Double);
+    setFlops(state, 2.0 * n * n * n);
+}
+BENCHMARK(BM_FloatMultiply)
+    ->ArgsProduct({{256, 1024}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_FloatAdd(benchmark::State& state) {
+    size_t n = state.range(0);
+    FloatMatrix a = matrix_cast<float>(benchMatrix(n, 1.0));
+    FloatMatrix b = matrix_cast<float>(benchMatrix(n, 2.0));
+    for (auto _ : state) {
+        a += b;
+        benchmark::DoNotOptimize(a.data());
+    }
+    // Half the bytes of setBytes(state, n, 3): two reads and a write of floats
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(3 * n * n * sizeof(float)));
+}
+BENCHMARK(BM_FloatAdd)->RangeMultiplier(4)->Range(16, 1024);
+
+// C = C + 2 * A * B through the operators, then as one fused gemm call
+static void BM_AccumulateOperators(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0), b = benchMatrix(n, 2.0), c(n, n);
+    for (auto _ : state) {
+        c = c + 2.0 * (a * b);
+        benchmark::DoNotOptimize(c.data());
+    }
+    setFlops(state, 2.0 * n * n * n);
+}
+BENCHMARK(BM_AccumulateOperators)->RangeMultiplier(4)->Range(16, 1024)->Unit(benchmark::kMicrosecond);
+
+static void BM_AccumulateGemm(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0), b = benchMatrix(n, 2.0), c(n, n);
+    for (auto _ : state) {
+        gemm(2.0, a, false, b, false, 1.0, c);
+        benchmark::DoNotOptimize(c.data());
+    }
+    setFlops(state, 2.0 * n * n * n);
+}
+BENCHMARK(BM_AccumulateGemm)->RangeMultiplier(4)->Range(16, 1024)->Unit(benchmark::kMicrosecond);
+
+// ========== MATRIX-VECTOR PRODUCTS ==========
+
+// Bytes/s counts the matrix only, which dominates the traffic
+static void BM_MatrixTimesColumn(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0), x = benchMatrix(n, 2.0).col(0);
+    for (auto _ : state) {
+        Matrix y = a * x;
+        benchmark::DoNotOptimize(y.data());
+    }
+    setBytes(state, n, 1);
+}
+BENCHMARK(BM_MatrixTimesColumn)->RangeMultiplier(4)->Range(64, 4096);
+
+static void BM_Gemv(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0);
+    Vector x(benchMatrix(n, 2.0).col(0)), y(n);
+    for (auto _ : state) {
+        multiply_into(a, x, y);
+        benchmark::DoNotOptimize(y.data());
+    }
+    setBytes(state, n, 1);
+}
+BENCHMARK(BM_Gemv)->RangeMultiplier(4)->Range(64, 4096);
+
+static void BM_GemvTransposed(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0);
+    Vector x(benchMatrix(n, 2.0).col(0)), y(n);
+    for (auto _ : state) {
+        multiply_transposed_into(a, x, y);
+        benchmark::DoNotOptimize(y.data());
+    }
+    setBytes(state, n, 1);
+}
+BENCHMARK(BM_GemvTransposed)->RangeMultiplier(4)->Range(64, 4096);
+
+// ========== BATCHED MULTIPLY ==========
+
+// BATCH_SIZE independent n x n products: one Matrix product per pair, then
+// the contiguous and interleaved batched kernels
+constexpr size_t BATCH_SIZE = 4096;
+
+static void BM_BatchOfMatrices(benchmark::State& state) {
+    size_t n = state.range(0);
+    std::vector<Matrix> a(BATCH_SIZE, benchMatrix(n, 1.0));
+    std::vector<Matrix> b(BATCH_SIZE, benchMatrix(n, 2.0));
+    std::vector<Matrix> c(BATCH_SIZE);
+    for (auto _ : state) {
+        for (size_t t = 0; t < BATCH_SIZE; ++t) {
+            c[t] = a[t] * b[t];
+        }
+        benchmark::DoNotOptimize(c.data());
+    }
+    setFlops(state, 2.0 * n * n * n * BATCH_SIZE);
+}
+BENCHMARK(BM_BatchOfMatrices)->Arg(3)->Arg(4)->Arg(8)->Unit(benchmark::kMicrosecond);
+
+static void BM_BatchedContiguous(benchmark::State& state) {
+    size_t n = state.range(0);
+    std::vector<double> a(BATCH_SIZE * n * n, 0.5), b(BATCH_SIZE * n * n, 0.25);
+    std::vector<double> c(BATCH_SIZE * n * n);
+    for (auto _ : state) {
+        kernels::batchedMultiply(BATCH_SIZE, n, n, n, a.data(), b.data(), c.data());
+        benchmark::DoNotOptimize(c.data());
+    }
+    setFlops(state, 2.0 * n * n * n * BATCH_SIZE);
+}
+BENCHMARK(BM_BatchedContiguous)->Arg(3)->Arg(4)->Arg(8)->Unit(benchmark::kMicrosecond);
+
+static void BM_BatchedInterleaved(benchmark::State& state) {
+    size_t n = state.range(0);
+    std::vector<double> a(BATCH_SIZE * n * n, 0.5), b(BATCH_SIZE * n * n, 0.25);
+    std::vector<double> c(BATCH_SIZE * n * n);
+    for (auto _ : state) {
+        kernels::batchedMultiplyInterleaved(BATCH_SIZE, n, n, n, a.data(), b.data(), c.data());
+        benchmark::DoNotOptimize(c.data());
+    }
+    setFlops(state, 2.0 * n * n * n * BATCH_SIZE);
+}
+BENCHMARK(BM_BatchedInterleaved)->Arg(3)->Arg(4)->Arg(8)->Unit(benchmark::kMicrosecond);
+
+// ========== FIXED-SIZE MATRICES ==========
+
+// Chained 4x4 transforms: x = x * t + t, dynamic vs fixed-size
+static void BM_SmallTransformMatrix(benchmark::State& state) {
+    Matrix t = benchMatrix(4, 1.0) * 0.25;
+    Matrix x = Matrix::identity(4);
+    for (auto _ : state) {
+        x = x * t + t;
+        benchmark::DoNotOptimize(x.data());
+    }
+    setFlops(state, 2.0 * 4 * 4 * 4 + 4 * 4);
+}
+BENCHMARK(BM_SmallTransformMatrix);
+
+static void BM_SmallTransformFixed(benchmark::State& state) {
+    FixedMatrix<4, 4> t(benchMatrix(4, 1.0) * 0.25);
+    FixedMatrix<4, 4> x = FixedMatrix<4, 4>::identity();
+    for (auto _ : state) {
+        x = x * t + t;
+        benchmark::DoNotOptimize(x.data());
+    }
+    setFlops(state, 2.0 * 4 * 4 * 4 + 4 * 4);
+}
+BENCHMARK(BM_SmallTransformFixed);
+
+// ========== NORM AND REDUCTIONS ==========
+
+static void BM_Norm(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.norm());
+    }
+    setBytes(state, n, 1);
+}
+BENCHMARK(BM_Norm)->RangeMultiplier(4)->Range(16, 4096);
+
+static void BM_Sum(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.sum());
+    }
+    setBytes(state, n, 1);
+}
+BENCHMARK(BM_Sum)->RangeMultiplier(4)->Range(16, 4096);
+
+static void BM_RowSums(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0);
+    for (auto _ : state) {
+        Matrix sums = a.rowSums();
+        benchmark::DoNotOptimize(sums.data());
+    }
+    setBytes(state, n, 1);
+}
+BENCHMARK(BM_RowSums)->RangeMultiplier(4)->Range(64, 4096);
+
+static void BM_ColumnSums(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = benchMatrix(n, 1.0);
+    for (auto _ : state) {
+        Matrix sums = a.columnSums();
+        benchmark::DoNotOptimize(sums.data());
+    }
+    setBytes(state, n, 1);
+}
+BENCHMARK(BM_ColumnSums)->RangeMultiplier(4)->Range(64, 4096);
+
+// ========== DECOMPOSITIONS ==========
+
+static void BM_SymmetricEigenvalues(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = symmetricBenchMatrix(n);
+    for (auto _ : state) {
+        SymmetricEigenDecomposition eig(a, false);
+        benchmark::DoNotOptimize(eig.eigenvalues().data());
+    }
+}
+BENCHMARK(BM_SymmetricEigenvalues)->RangeMultiplier(4)->Range(64, 1024)->Unit(benchmark::kMillisecond);
+
+static void BM_SymmetricEigenvectors(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = symmetricBenchMatrix(n);
+    for (auto _ : state) {
+        SymmetricEigenDecomposition eig(a);
+        benchmark::DoNotOptimize(eig.eigenvectors().data());
+    }
+}
+BENCHMARK(BM_SymmetricEigenvectors)->RangeMultiplier(4)->Range(64, 1024)->Unit(benchmark::kMillisecond);
+
+static void BM_SingularValueDecomposition(benchmark::State& state) {
+    size_t n = state.range(0);
+    Matrix a = symmetricBenchMatrix(n);
+    for (auto _ : state) {
+        SingularValueDecomposition svd(a);
+        benchmark::DoNotOptimize(svd.u().data());
+    }
+}
+BENCHMARK(BM_SingularValueDecomposition)->RangeMultiplier(4)->Range(64, 1024)->Unit(benchmark::kMillisecond);
+
+// ========== ITERATIVE SOLVERS ==========
+
+// Poisson problem on an n x n grid; the second argument picks the
+// preconditioner (0 none, 1 Jacobi, 2 ILU(0)). Reports solver iterations.
+static void BM_ConjugateGradient(benchmark::State& state) {
+    SparseMatrix a = poissonBenchMatrix(state.range(0));
+    Vector b(a.rows(), 1.0);
+    JacobiPreconditioner jacobi(a);
+    ILU0Preconditioner ilu(a);
+    SolverOptions options;
+    options.tolerance = 1e-8;
+    options.max_iterations = 10000;
+    options.preconditioner = state.range(1) == 1 ? static_cast<const Preconditioner*>(&jacobi)
+                           : state.range(1) == 2 ? &ilu : nullptr;
+
+    ConjugateGradientSolver cg;
+    Vector x;
+    size_t iterations = 0;
+    for (auto _ : state) {
+        x.fill(0.0);
+        iterations = cg.solve(a, b, x, options).iterations;
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.counters["iterations"] = double(iterations);
+}
+BENCHMARK(BM_ConjugateGradient)->ArgsProduct({{64, 256}, {0, 1, 2}})->Unit(benchmark::kMillisecond);
+
+static void BM_GMRES(benchmark::State& state) {
+    SparseMatrix a = poissonBenchMatrix(state.range(0));
+    Vector b(a.rows(), 1.0);
+    ILU0Preconditioner ilu(a);
+    SolverOptions options;
+    options.tolerance = 1e-8;
+    options.max_iterations = 10000;
+    options.preconditioner = state.range(1) ? &ilu : nullptr;
+
+    GMRESSolver gmres;
+    Vector x;
+    size_t iterations = 0;
+    for (auto _ : state) {
+        x.fill(0.0);
+        iterations = gmres.solve(a, b, x, options).iterations;
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.counters["iterations"] = double(iterations);
+}
+BENCHMARK(BM_GMRES)->Args({64, 0})->Args({64, 1})->Args({256, 1})->Unit(benchmark::kMillisecond);
+
+// ========== OUT-OF-CORE ==========
+
+// 1024 x 1024 tiled multiply with 256 x 256 tiles and a budget of eight
+// tiles, so most tiles are re-read from the file; the second argument
+// turns prefetching on
+static void BM_TiledMultiply(benchmark::State& state) {
+    size_t n = state.range(0);
+    TiledMatrixOptions options;
+    options.tile_size = 256;
+    options.memory_budget = 8 * 256 * 256 * sizeof(double);
+    options.prefetch = state.range(1) != 0;
+    TiledMatrix a = TiledMatrix::fromMatrix(benchMatrix(n, 0.1), "", options);
+    TiledMatrix b = TiledMatrix::fromMatrix(benchMatrix(n, 0.2), "", options);
+    for (auto _ : state) {
+        TiledMatrix c = a * b;
+        c.flush();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(2 * n * n * n));
+}
+BENCHMARK(BM_TiledMultiply)->Args({1024, 0})->Args({1024, 1})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,114 @@
+#include "cholesky.h"
+#include "gemm.h"
+#include "triangular.h"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+// ========== FACTORIZATION ==========
+
+CholeskyDecomposition::CholeskyDecomposition(Matrix a) : l_(std::move(a)) {
+    if (l_.rows() != l_.cols()) {
+        throw std::logic_error("Cholesky decomposition requires square matrix");
+    }
+    factor();
+}
+
+void CholeskyDecomposition::factor() {
+    size_t n = l_.rows();
+    double* a = l_.data();
+
+    for (size_t k0 = 0; k0 < n; k0 += CHOLESKY_BLOCK) {
+        size_t k1 = std::min(k0 + CHOLESKY_BLOCK, n);
+
+        // Unblocked factorization of the diagonal block A11 = L11 * L11^T
+        for (size_t j = k0; j < k1; ++j) {
+            double d = a[j * n + j];
+            for (size_t p = k0; p < j; ++p) {
+                d -= a[j * n + p] * a[j * n + p];
+            }
+            if (!(d > 0.0)) {
+                throw std::runtime_error("Matrix is not positive definite");
+            }
+            double l_jj = std::sqrt(d);
+            a[j * n + j] = l_jj;
+            for (size_t i = j + 1; i < k1; ++i) {
+                double s = a[i * n + j];
+                for (size_t p = k0; p < j; ++p) {
+                    s -= a[i * n + p] * a[j * n + p];
+                }
+                a[i * n + j] = s / l_jj;
+            }
+        }
+
+        if (k1 == n) {
+            break;
+        }
+
+        // L21 = A21 * L11^-T, one row at a time (each row is a forward
+        // substitution against L11, reading contiguous rows)
+        for (size_t i = k1; i < n; ++i) {
+            double* row = a + i * n;
+            for (size_t j = k0; j < k1; ++j) {
+                double s = row[j];
+                const double* l_row = a + j * n;
+                for (size_t p = k0; p < j; ++p) {
+                    s -= row[p] * l_row[p];
+                }
+                row[j] = s / l_row[j];
+            }
+        }
+
+        // A22 -= L21 * L21^T, lower part only: for each block column of the
+        // trailing matrix, update the block-trapezoid from its diagonal
+        // block down with one GEMM call
+        size_t kb = k1 - k0;
+        for (size_t j0 = k1; j0 < n; j0 += CHOLESKY_BLOCK) {
+            size_t jb = std::min(CHOLESKY_BLOCK, n - j0);
+            kernels::gemm(n - j0, jb, kb, -1.0,
+                          a + j0 * n + k0, n, 1,
+                          a + j0 * n + k0, 1, n,
+                          a + j0 * n + j0, n);
+        }
+    }
+
+    // Clear the untouched upper triangle so l_ is exactly L
+    for (size_t i = 0; i < n; ++i) {
+        std::fill(a + i * n + i + 1, a + (i + 1) * n, 0.0);
+    }
+}
+
+// ========== SOLVES ==========
+
+void CholeskyDecomposition::solveInPlace(Matrix& b) const {
+    if (b.rows() != l_.rows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for solve");
+    }
+    size_t n = l_.rows();
+
+    // L * Y = B, then L^T * X = Y (L^T is L viewed with swapped strides)
+    kernels::solveLower(l_, b, false);
+    kernels::solveUpper(ConstMatrixView(l_.data(), n, n, 1, n), b, false);
+}
+
+Matrix CholeskyDecomposition::solve(const Matrix& b) const {
+    Matrix x(b);
+    solveInPlace(x);
+    return x;
+}
+
+double CholeskyDecomposition::determinant() const {
+    double det = 1.0;
+    for (size_t i = 0; i < l_.rows(); ++i) {
+        det *= l_(i, i);
+    }
+    return det * det;
+}
+
+size_t CholeskyDecomposition::size() const {
+    return l_.rows();
+}
+
+const Matrix& CholeskyDecomposition::lower() const {
+    return l_;
+}
@@ -0,0 +1,44 @@
+#ifndef CHOLESKY_H
+#define CHOLESKY_H
+
+#include <vector>
+#include <cstddef>
+#include "matrix.h"
+
+// Cholesky decomposition of a symmetric positive definite matrix:
+// A = L * L^T with L lower triangular.
+//
+// The factorization overwrites the matrix it is given (pass an rvalue to
+// avoid the copy) and only reads its lower triangle. It is blocked and
+// right-looking: after each panel, the lower part of the trailing matrix
+// is updated block column by block column with the GEMM kernel.
+class CholeskyDecomposition {
+private:
+    Matrix l_;
+    
+    void factor();
+
+public:
+    // Panel width of the blocked factorization
+    static constexpr size_t CHOLESKY_BLOCK = 64;
+    
+    // Factor a square SPD matrix. Throws std::logic_error if a is not
+    // square and std::runtime_error if it is not positive definite.
+    explicit CholeskyDecomposition(Matrix a);
+    
+    // Solve A * X = B (B may have any number of columns)
+    Matrix solve(const Matrix& b) const;
+    
+    // Overwrite B with the solution of A * X = B
+    void solveInPlace(Matrix& b) const;
+    
+    // det(A) = prod(L_ii)^2
+    double determinant() const;
+    
+    size_t size() const;
+    
+    // Lower-triangular factor L (zeros above the diagonal)
+    const Matrix& lower() const;
+};
+
+#endif // CHOLESKY_H
@@ -0,0 +1,419 @@
+#include "eigen.h"
+#include "gemm.h"
+#include "gemv.h"
+#include "elementwise.h"
+#include "thread_pool.h"
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <stdexcept>
+
+using kernels::ThreadPool;
+
+namespace {
+
+// QL iterations allowed per eigenvalue before giving up
+constexpr int MAX_QL_ITERATIONS = 60;
+
+// Rotations times columns at or above which a sweep's rotations are
+// applied to the eigenvectors in parallel
+constexpr size_t ROTATION_PARALLEL_THRESHOLD = 1 << 16;
+
+// Columns of the eigenvectors each thread rotates at a time (a few rows of
+// this width stay in L1 through a whole sweep)
+constexpr size_t ROTATION_COLUMN_BLOCK = 256;
+
+size_t ceilDiv(size_t value, size_t divisor) {
+    return (value + divisor - 1) / divisor;
+}
+
+// Exponent e with max |a| = f * 2^e, f in [0.5, 1), after dividing a by
+// 2^e (exact, being a power of two). Working on entries of magnitude at
+// most 1 keeps the squared norms from overflowing or underflowing.
+// Returns 0 and leaves a unchanged if it is zero or not finite.
+int normalizeScale(Matrix& a) {
+    size_t count = a.rows() * a.cols();
+    double lo, hi;
+    kernels::minMax(count, a.data(), &lo, &hi);
+    double largest = std::max(std::abs(lo), std::abs(hi));
+    if (count == 0 || largest == 0.0 || !std::isfinite(largest)) {
+        return 0;
+    }
+    int exponent;
+    std::frexp(largest, &exponent);
+    double* data = a.data();
+    for (size_t i = 0; i < count; ++i) {
+        data[i] = std::ldexp(data[i], -exponent);
+    }
+    return exponent;
+}
+
+// One plane rotation of rows i and i + 1 recorded during a QL sweep
+struct Rotation {
+    size_t row;
+    double c;
+    double s;
+};
+
+// ========== TRIDIAGONAL REDUCTION ==========
+
+// Reduce the n x n symmetric matrix a (both triangles stored) to
+// tridiagonal form: diagonal d, off-diagonal e (e[j] couples j and j + 1).
+// Reflector j is H(j) = I - tau[j] * v * v^T with v stored in column j
+// below the diagonal, v[j + 1] = 1 included.
+void tridiagonalize(Matrix& a, std::vector<double>& d, std::vector<double>& e,
+                    std::vector<double>& tau) {
+    const size_t NB = SymmetricEigenDecomposition::EIGEN_BLOCK;
+    size_t n = a.rows();
+    double* A = a.data();
+    d.assign(n, 0.0);
+    e.assign(n, 0.0);
+    tau.assign(n, 0.0);
+    if (n == 0) {
+        return;
+    }
+
+    // Panel reflectors V and the matching W of the rank-2k update
+    // A22 -= V * W^T + W * V^T, one column per reflector (row-major, ld NB)
+    Matrix v(n, NB);
+    Matrix w(n, NB);
+    std::vector<double> column(n), x(n), y(n), y1(NB), y2(NB);
+
+    size_t steps = n - 1;
+    for (size_t k0 = 0; k0 < steps; k0 += NB) {
+        size_t k1 = std::min(k0 + NB, steps);
+        v.fill(0.0);
+        w.fill(0.0);
+
+        for (size_t j = k0; j < k1; ++j) {
+            size_t c = j - k0;
+
+            // Bring column j up to date with the panel's earlier reflectors
+            for (size_t r = j; r < n; ++r) {
+                column[r] = A[r * n + j];
+            }
+            for (size_t p = 0; p < c; ++p) {
+                double w_jp = w(j, p);
+                double v_jp = v(j, p);
+                for (size_t r = j; r < n; ++r) {
+                    column[r] -= v(r, p) * w_jp + w(r, p) * v_jp;
+                }
+            }
+            d[j] = column[j];
+            A[j * n + j] = column[j];
+
+            // Reflector mapping column[j+1:n] onto e[j] * e1
+            // (the norm below alpha scaled as in dlarfg)
+            double alpha = column[j + 1];
+            size_t len = n - j - 1;
+            double x_norm = kernels::nrm2(len - 1, column.data() + j + 2);
+            x[0] = 1.0;
+            if (x_norm == 0.0) {
+                e[j] = alpha;
+                std::fill(x.begin() + 1, x.begin() + len, 0.0);
+            } else {
+                double beta = -std::copysign(std::hypot(alpha, x_norm), alpha);
+                tau[j] = (beta - alpha) / beta;
+                double pivot = alpha - beta;
+                for (size_t r = j + 2; r < n; ++r) {
+                    x[r - j - 1] = column[r] / pivot;
+                }
+                e[j] = beta;
+            }
+            for (size_t r = j + 1; r < n; ++r) {
+                A[r * n + j] = x[r - j - 1];
+                v(r, c) = x[r - j - 1];
+            }
+            if (tau[j] == 0.0) {
+                continue;
+            }
+
+            // w = tau * A22 * v, with A22 the trailing matrix as updated by
+            // the panel so far: the stored (stale) A22 times v, corrected
+            // by -(V * W^T + W * V^T) * v
+            const double* a22 = A + (j + 1) * n + (j + 1);
+            kernels::gemv(len, len, 1.0, a22, n, x.data(), 0.0, y.data());
+            if (c > 0) {
+                const double* v_rows = v.data() + (j + 1) * NB;
+                const double* w_rows = w.data() + (j + 1) * NB;
+                kernels::gemvTransposed(len, c, 1.0, w_rows, NB, x.data(), 0.0, y1.data());
+                kernels::gemvTransposed(len, c, 1.0, v_rows, NB, x.data(), 0.0, y2.data());
+                kernels::gemv(len, c, -1.0, v_rows, NB, y1.data(), 1.0, y.data());
+                kernels::gemv(len, c, -1.0, w_rows, NB, y2.data(), 1.0, y.data());
+            }
+            kernels::scale(len, tau[j], y.data(), y.data());
+
+            // w -= (tau / 2) (w . v) v makes the update a symmetric rank-2
+            double correction = -0.5 * tau[j] * kernels::dot(len, y.data(), x.data());
+            kernels::axpy(len, correction, x.data(), y.data());
+            for (size_t r = j + 1; r < n; ++r) {
+                w(r, c) = y[r - j - 1];
+            }
+        }
+
+        // A22 -= V * W^T + W * V^T for the rows and columns after the panel
+        size_t t = n - k1;
+        size_t kb = k1 - k0;
+        double* a22 = A + k1 * n + k1;
+        const double* v_rows = v.data() + k1 * NB;
+        const double* w_rows = w.data() + k1 * NB;
+        kernels::gemm(t, t, kb, -1.0, v_rows, NB, 1, w_rows, 1, NB, a22, n);
+        kernels::gemm(t, t, kb, -1.0, w_rows, NB, 1, v_rows, 1, NB, a22, n);
+    }
+    d[n - 1] = A[(n - 1) * n + (n - 1)];
+}
+
+// ========== BACK-TRANSFORMATION ==========
+
+// Q = H(0) * H(1) * ... * H(n-2), accumulated backwards a block of
+// reflectors at a time: with the block written as I - V * T * V^T (LAPACK
+// larft), each block is two GEMM calls on the trailing part of Q
+Matrix formQ(const Matrix& a, const std::vector<double>& tau) {
+    const size_t NB = SymmetricEigenDecomposition::EIGEN_BLOCK;
+    size_t n = a.rows();
+    Matrix q = Matrix::identity(n);
+    if (n < 2) {
+        return q;
+    }
+
+    size_t steps = n - 1;
+    Matrix v(n, NB);
+    Matrix t(NB, NB);
+    Matrix work(NB, n);
+    std::vector<double> dots(NB);
+    for (size_t k0 = (steps - 1) / NB * NB;; k0 -= NB) {
+        size_t k1 = std::min(k0 + NB, steps);
+        size_t kb = k1 - k0;
+
+        // Reflectors of the block act on rows and columns o..n-1
+        size_t o = k0 + 1;
+        size_t mq = n - o;
+        for (size_t i = 0; i < mq; ++i) {
+            for (size_t c = 0; c < kb; ++c) {
+                size_t j = k0 + c;
+                v(i, c) = o + i >= j + 1 ? a(o + i, j) : 0.0;
+            }
+        }
+
+        // T(0:c, c) = -tau_c * T(0:c, 0:c) * V(:, 0:c)^T * v_c
+        for (size_t c = 0; c < kb; ++c) {
+            double tau_c = tau[k0 + c];
+            t(c, c) = tau_c;
+            for (size_t r = 0; r < c; ++r) {
+                double s = 0.0;
+                for (size_t i = c; i < mq; ++i) {
+                    s += v(i, r) * v(i, c);
+                }
+                t(r, c) = -tau_c * s;
+            }
+            for (size_t r = 0; r < c; ++r) {
+                double s = 0.0;
+                for (size_t p = r; p < c; ++p) {
+                    s += t(r, p) * t(p, c);
+                }
+                dots[r] = s;
+            }
+            for (size_t r = 0; r < c; ++r) {
+                t(r, c) = dots[r];
+            }
+        }
+
+        // Q22 -= V * (T * (V^T * Q22))
+        double* q22 = q.data() + o * n + o;
+        std::fill(work.data(), work.data() + kb * n, 0.0);
+        kernels::gemm(kb, mq, mq, 1.0, v.data(), 1, NB, q22, n, 1, work.data(), n);
+
+        // work = T * work in place: row r only needs rows >= r
+        for (size_t r = 0; r < kb; ++r) {
+            double* work_r = work.data() + r * n;
+            kernels::scale(mq, t(r, r), work_r, work_r);
+            for (size_t p = r + 1; p < kb; ++p) {
+                kernels::axpy(mq, t(r, p), work.data() + p * n, work_r);
+            }
+        }
+        kernels::gemm(mq, mq, kb, -1.0, v.data(), NB, 1, work.data(), n, 1, q22, n);
+
+        if (k0 == 0) {
+            break;
+        }
+    }
+    return q;
+}
+
+// ========== IMPLICIT QL ==========
+
+// Apply rotations in order to rows of z (rows i and i + 1 of each), the
+// columns split into blocks that are rotated independently
+void applyRotations(const std::vector<Rotation>& rotations, Matrix& z) {
+    size_t n = z.cols();
+    auto rotateColumns = [&](size_t begin, size_t end) {
+        for (const Rotation& rot : rotations) {
+            double* upper = z.data() + rot.row * n;
+            double* lower = upper + n;
+            for (size_t k = begin; k < end; ++k) {
+                double f = lower[k];
+                lower[k] = rot.s * upper[k] + rot.c * f;
+                upper[k] = rot.c * upper[k] - rot.s * f;
+            }
+        }
+    };
+
+    size_t blocks = ceilDiv(n, ROTATION_COLUMN_BLOCK);
+    if (kernels::numThreads() <= 1 || blocks < 2 ||
+        rotations.size() * n < ROTATION_PARALLEL_THRESHOLD) {
+        for (size_t b = 0; b < blocks; ++b) {
+            rotateColumns(b * ROTATION_COLUMN_BLOCK, std::min(n, (b + 1) * ROTATION_COLUMN_BLOCK));
+        }
+        return;
+    }
+    ThreadPool::global().parallelFor(blocks, [&](size_t b) {
+        rotateColumns(b * ROTATION_COLUMN_BLOCK, std::min(n, (b + 1) * ROTATION_COLUMN_BLOCK));
+    });
+}
+
+// Eigenvalues of the symmetric tridiagonal (d, e) by implicit QL with
+// Wilkinson shifts (tql2). When z is given, its rows are rotated along, so
+// rows of Q^T become the eigenvectors.
+void tridiagonalQL(std::vector<double>& d, std::vector<double>& e, Matrix* z) {
+    size_t n = d.size();
+    const double eps = std::numeric_limits<double>::epsilon();
+    std::vector<Rotation> rotations;
+
+    for (size_t l = 0; l < n; ++l) {
+        int iterations = 0;
+        size_t m;
+        do {
+            // Find a negligible off-diagonal element to split at
+            for (m = l; m + 1 < n; ++m) {
+                double dd = std::abs(d[m]) + std::abs(d[m + 1]);
+                if (std::abs(e[m]) <= eps * dd) {
+                    break;
+                }
+            }
+            if (m == l) {
+                break;
+            }
+            if (++iterations > MAX_QL_ITERATIONS) {
+                throw std::runtime_error("Eigenvalue iteration did not converge");
+            }
+
+            // Shift from the leading 2 x 2 block, then chase the bulge up
+            double g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+            double r = std::hypot(g, 1.0);
+            g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+            double s = 1.0, c = 1.0, p = 0.0;
+            bool deflated = false;
+            rotations.clear();
+            for (size_t i = m; i-- > l;) {
+                double f = s * e[i];
+                double b = c * e[i];
+                r = std::hypot(f, g);
+                e[i + 1] = r;
+                if (r == 0.0) {
+                    // Underflow: the matrix has split early
+                    d[i + 1] -= p;
+                    e[m] = 0.0;
+                    deflated = true;
+                    break;
+                }
+                s = f / r;
+                c = g / r;
+                g = d[i + 1] - p;
+                r = (d[i] - g) * s + 2.0 * c * b;
+                p = s * r;
+                d[i + 1] = g + p;
+                g = c * r - b;
+                if (z != nullptr) {
+                    rotations.push_back(Rotation{i, c, s});
+                }
+            }
+            if (z != nullptr) {
+                applyRotations(rotations, *z);
+            }
+            if (!deflated) {
+                d[l] -= p;
+                e[l] = g;
+                e[m] = 0.0;
+            }
+        } while (m != l);
+    }
+}
+
+} // namespace
+
+// ========== DECOMPOSITION ==========
+
+SymmetricEigenDecomposition::SymmetricEigenDecomposition(Matrix a, bool compute_vectors)
+    : has_vectors_(compute_vectors) {
+    if (a.rows() != a.cols()) {
+        throw std::logic_error("Eigendecomposition requires square matrix");
+    }
+    compute(std::move(a));
+}
+
+void SymmetricEigenDecomposition::compute(Matrix a) {
+    size_t n = a.rows();
+
+    // Mirror the lower triangle so the reduction can use full-storage GEMV
+    // and GEMM calls
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            a(i, j) = a(j, i);
+        }
+    }
+
+    int exponent = normalizeScale(a);
+
+    std::vector<double> d, e, tau;
+    tridiagonalize(a, d, e, tau);
+
+    if (!has_vectors_) {
+        tridiagonalQL(d, e, nullptr);
+        for (double& value : d) {
+            value = std::ldexp(value, exponent);
+        }
+        std::sort(d.begin(), d.end());
+        eigenvalues_ = std::move(d);
+        return;
+    }
+
+    // Rows of z = Q^T are rotated into eigenvectors
+    Matrix z;
+    transpose_into(formQ(a, tau), z);
+    tridiagonalQL(d, e, &z);
+
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t i, size_t j) { return d[i] < d[j]; });
+    eigenvalues_.resize(n);
+    eigenvectors_ = Matrix(n, n);
+    for (size_t k = 0; k < n; ++k) {
+        eigenvalues_[k] = std::ldexp(d[order[k]], exponent);
+        const double* row = z.data() + order[k] * n;
+        for (size_t i = 0; i < n; ++i) {
+            eigenvectors_(i, k) = row[i];
+        }
+    }
+}
+
+// ========== RESULTS ==========
+
+const std::vector<double>& SymmetricEigenDecomposition::eigenvalues() const {
+    return eigenvalues_;
+}
+
+const Matrix& SymmetricEigenDecomposition::eigenvectors() const {
+    if (!has_vectors_) {
+        throw std::logic_error("Eigenvectors were not computed");
+    }
+    return eigenvectors_;
+}
+
+bool SymmetricEigenDecomposition::hasEigenvectors() const {
+    return has_vectors_;
+}
+
+size_t SymmetricEigenDecomposition::size() const {
+    return eigenvalues_.size();
+}
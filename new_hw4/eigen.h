@@ -0,0 +1,49 @@
+#ifndef EIGEN_H
+#define EIGEN_H
+
+#include <vector>
+#include <cstddef>
+#include "matrix.h"
+
+// Eigendecomposition of a symmetric matrix: A = V * diag(w) * V^T with V
+// orthogonal.
+//
+// Only the lower triangle of A is read. A is first reduced to tridiagonal
+// form T = Q^T * A * Q by Householder reflectors, blocked as in LAPACK
+// (sytrd/latrd): each panel's reflectors are accumulated and the trailing
+// matrix is updated with GEMM calls, and the matrix-vector products inside
+// the panel use the threaded GEMV kernel. The eigenvalues of T are found by
+// the implicit QL algorithm with Wilkinson shifts. Eigenvectors start from
+// Q, formed with blocked WY updates, and each QL sweep's plane rotations
+// are applied to them in parallel over column ranges.
+class SymmetricEigenDecomposition {
+private:
+    std::vector<double> eigenvalues_;
+    Matrix eigenvectors_;
+    bool has_vectors_;
+
+    void compute(Matrix a);
+
+public:
+    // Panel width of the blocked tridiagonal reduction
+    static constexpr size_t EIGEN_BLOCK = 32;
+
+    // Decompose a square matrix (std::logic_error otherwise), reading its
+    // lower triangle. Pass compute_vectors = false when only eigenvalues
+    // are needed; this skips forming Q and applying rotations. Throws
+    // std::runtime_error if the QL iteration fails to converge (e.g. for
+    // non-finite input).
+    explicit SymmetricEigenDecomposition(Matrix a, bool compute_vectors = true);
+
+    // Eigenvalues in ascending order
+    const std::vector<double>& eigenvalues() const;
+
+    // Orthonormal eigenvectors as columns, column k belonging to
+    // eigenvalues()[k] (std::logic_error if they were not computed)
+    const Matrix& eigenvectors() const;
+
+    bool hasEigenvectors() const;
+    size_t size() const;
+};
+
+#endif // EIGEN_H
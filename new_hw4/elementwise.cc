@@ -0,0 +1,678 @@
+#include "elementwise.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ELEMENTWISE_X86 1
+#endif
+
+namespace kernels {
+
+namespace {
+
+// ========== PORTABLE LOOPS ==========
+
+// Used for the tails the vector loops leave over and on non-x86 targets
+
+void addScalar(size_t n, const double* a, const double* b, double* out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+void subtractScalar(size_t n, const double* a, const double* b, double* out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = a[i] - b[i];
+    }
+}
+
+void scaleScalar(size_t n, double alpha, const double* a, double* out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = alpha * a[i];
+    }
+}
+
+void fillScalar(size_t n, double value, double* out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = value;
+    }
+}
+
+double sumOfSquaresScalar(size_t n, const double* a) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += a[i] * a[i];
+    }
+    return sum;
+}
+
+double sumScalar(size_t n, const double* a) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += a[i];
+    }
+    return sum;
+}
+
+void minMaxScalar(size_t n, const double* a, double* lo, double* hi) {
+    double low = *lo, high = *hi;
+    bool nan = false;
+    for (size_t i = 0; i < n; ++i) {
+        double x = a[i];
+        low = x < low ? x : low;
+        high = x > high ? x : high;
+        nan |= x != x;
+    }
+    if (nan) {
+        low = high = NAN;
+    }
+    *lo = low;
+    *hi = high;
+}
+
+double dotScalar(size_t n, const double* a, const double* b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+void axpyScalar(size_t n, double alpha, const double* x, double* y) {
+    for (size_t i = 0; i < n; ++i) {
+        y[i] += alpha * x[i];
+    }
+}
+
+void addScalar(size_t n, const float* a, const float* b, float* out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+void subtractScalar(size_t n, const float* a, const float* b, float* out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = a[i] - b[i];
+    }
+}
+
+void scaleScalar(size_t n, float alpha, const float* a, float* out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = alpha * a[i];
+    }
+}
+
+#ifdef ELEMENTWISE_X86
+
+// Loads and stores are unaligned: Matrix storage is 64-byte aligned, but
+// views and rows of odd-width matrices are not, and unaligned
+// instructions cost nothing extra on aligned data
+
+// ========== SSE2 ==========
+
+void addSse2(size_t n, const double* a, const double* b, double* out) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    }
+    addScalar(n - i, a + i, b + i, out + i);
+}
+
+void subtractSse2(size_t n, const double* a, const double* b, double* out) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    }
+    subtractScalar(n - i, a + i, b + i, out + i);
+}
+
+void scaleSse2(size_t n, double alpha, const double* a, double* out) {
+    __m128d factor = _mm_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, _mm_mul_pd(factor, _mm_loadu_pd(a + i)));
+    }
+    scaleScalar(n - i, alpha, a + i, out + i);
+}
+
+void fillSse2(size_t n, double value, double* out) {
+    __m128d v = _mm_set1_pd(value);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, v);
+    }
+    fillScalar(n - i, value, out + i);
+}
+
+double sumOfSquaresSse2(size_t n, const double* a) {
+    // Two accumulators hide the latency of the adds
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d x0 = _mm_loadu_pd(a + i);
+        __m128d x1 = _mm_loadu_pd(a + i + 2);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(x0, x0));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(x1, x1));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    return lanes[0] + lanes[1] + sumOfSquaresScalar(n - i, a + i);
+}
+
+double sumSse2(size_t n, const double* a) {
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(a + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(a + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    return lanes[0] + lanes[1] + sumScalar(n - i, a + i);
+}
+
+// minpd drops a NaN operand, so NaNs are tracked in a separate mask
+void minMaxSse2(size_t n, const double* a, double* lo, double* hi) {
+    __m128d low = _mm_set1_pd(*lo);
+    __m128d high = _mm_set1_pd(*hi);
+    __m128d nan = _mm_cmpunord_pd(low, high);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(a + i);
+        low = _mm_min_pd(x, low);
+        high = _mm_max_pd(x, high);
+        nan = _mm_or_pd(nan, _mm_cmpunord_pd(x, x));
+    }
+    double lows[2], highs[2];
+    _mm_storeu_pd(lows, low);
+    _mm_storeu_pd(highs, high);
+    *lo = std::min(lows[0], lows[1]);
+    *hi = std::max(highs[0], highs[1]);
+    if (_mm_movemask_pd(nan) != 0) {
+        *lo = *hi = NAN;
+    }
+    minMaxScalar(n - i, a + i, lo, hi);
+}
+
+double dotSse2(size_t n, const double* a, const double* b) {
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    return lanes[0] + lanes[1] + dotScalar(n - i, a + i, b + i);
+}
+
+void axpySse2(size_t n, double alpha, const double* x, double* y) {
+    __m128d factor = _mm_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d sum = _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(factor, _mm_loadu_pd(x + i)));
+        _mm_storeu_pd(y + i, sum);
+    }
+    axpyScalar(n - i, alpha, x + i, y + i);
+}
+
+void addSse2(size_t n, const float* a, const float* b, float* out) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    addScalar(n - i, a + i, b + i, out + i);
+}
+
+void subtractSse2(size_t n, const float* a, const float* b, float* out) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(out + i, _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    subtractScalar(n - i, a + i, b + i, out + i);
+}
+
+void scaleSse2(size_t n, float alpha, const float* a, float* out) {
+    __m128 factor = _mm_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(out + i, _mm_mul_ps(factor, _mm_loadu_ps(a + i)));
+    }
+    scaleScalar(n - i, alpha, a + i, out + i);
+}
+
+// ========== AVX2 ==========
+
+__attribute__((target("avx2")))
+void addAvx2(size_t n, const double* a, const double* b, double* out) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    addScalar(n - i, a + i, b + i, out + i);
+}
+
+__attribute__((target("avx2")))
+void subtractAvx2(size_t n, const double* a, const double* b, double* out) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    subtractScalar(n - i, a + i, b + i, out + i);
+}
+
+__attribute__((target("avx2")))
+void scaleAvx2(size_t n, double alpha, const double* a, double* out) {
+    __m256d factor = _mm256_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(factor, _mm256_loadu_pd(a + i)));
+    }
+    scaleScalar(n - i, alpha, a + i, out + i);
+}
+
+__attribute__((target("avx2")))
+void fillAvx2(size_t n, double value, double* out) {
+    __m256d v = _mm256_set1_pd(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, v);
+    }
+    fillScalar(n - i, value, out + i);
+}
+
+__attribute__((target("avx2,fma")))
+double sumOfSquaresAvx2(size_t n, const double* a) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d x0 = _mm256_loadu_pd(a + i);
+        __m256d x1 = _mm256_loadu_pd(a + i + 4);
+        acc0 = _mm256_fmadd_pd(x0, x0, acc0);
+        acc1 = _mm256_fmadd_pd(x1, x1, acc1);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sumOfSquaresScalar(n - i, a + i);
+}
+
+__attribute__((target("avx2")))
+double sumAvx2(size_t n, const double* a) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(a + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(a + i + 4));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sumScalar(n - i, a + i);
+}
+
+__attribute__((target("avx2")))
+void minMaxAvx2(size_t n, const double* a, double* lo, double* hi) {
+    __m256d low = _mm256_set1_pd(*lo);
+    __m256d high = _mm256_set1_pd(*hi);
+    __m256d nan = _mm256_cmp_pd(low, high, _CMP_UNORD_Q);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(a + i);
+        low = _mm256_min_pd(x, low);
+        high = _mm256_max_pd(x, high);
+        nan = _mm256_or_pd(nan, _mm256_cmp_pd(x, x, _CMP_UNORD_Q));
+    }
+    double lows[4], highs[4];
+    _mm256_storeu_pd(lows, low);
+    _mm256_storeu_pd(highs, high);
+    *lo = std::min(std::min(lows[0], lows[1]), std::min(lows[2], lows[3]));
+    *hi = std::max(std::max(highs[0], highs[1]), std::max(highs[2], highs[3]));
+    if (_mm256_movemask_pd(nan) != 0) {
+        *lo = *hi = NAN;
+    }
+    minMaxScalar(n - i, a + i, lo, hi);
+}
+
+__attribute__((target("avx2,fma")))
+double dotAvx2(size_t n, const double* a, const double* b) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + dotScalar(n - i, a + i, b + i);
+}
+
+__attribute__((target("avx2,fma")))
+void axpyAvx2(size_t n, double alpha, const double* x, double* y) {
+    __m256d factor = _mm256_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(factor, _mm256_loadu_pd(x + i),
+                                                _mm256_loadu_pd(y + i)));
+    }
+    axpyScalar(n - i, alpha, x + i, y + i);
+}
+
+__attribute__((target("avx2")))
+void addAvx2(size_t n, const float* a, const float* b, float* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    addScalar(n - i, a + i, b + i, out + i);
+}
+
+__attribute__((target("avx2")))
+void subtractAvx2(size_t n, const float* a, const float* b, float* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    subtractScalar(n - i, a + i, b + i, out + i);
+}
+
+__attribute__((target("avx2")))
+void scaleAvx2(size_t n, float alpha, const float* a, float* out) {
+    __m256 factor = _mm256_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(factor, _mm256_loadu_ps(a + i)));
+    }
+    scaleScalar(n - i, alpha, a + i, out + i);
+}
+
+// ========== AVX-512 ==========
+
+// Horizontal reductions go through memory, as for AVX2, and min/max use
+// the full-mask forms: GCC 12's _mm512_reduce_*_pd and unmasked
+// _mm512_min_pd/_mm512_max_pd pass an undefined vector through, which
+// trips -Wmaybe-uninitialized at -O3. Both compile to the same code.
+
+__attribute__((target("avx512f")))
+double addLanes(__m512d v) {
+    double lanes[8];
+    _mm512_storeu_pd(lanes, v);
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+           ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+__attribute__((target("avx512f")))
+void addAvx512(size_t n, const double* a, const double* b, double* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    }
+    addScalar(n - i, a + i, b + i, out + i);
+}
+
+__attribute__((target("avx512f")))
+void subtractAvx512(size_t n, const double* a, const double* b, double* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i, _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    }
+    subtractScalar(n - i, a + i, b + i, out + i);
+}
+
+__attribute__((target("avx512f")))
+void scaleAvx512(size_t n, double alpha, const double* a, double* out) {
+    __m512d factor = _mm512_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i, _mm512_mul_pd(factor, _mm512_loadu_pd(a + i)));
+    }
+    scaleScalar(n - i, alpha, a + i, out + i);
+}
+
+__attribute__((target("avx512f")))
+void fillAvx512(size_t n, double value, double* out) {
+    __m512d v = _mm512_set1_pd(value);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i, v);
+    }
+    fillScalar(n - i, value, out + i);
+}
+
+__attribute__((target("avx512f")))
+double sumOfSquaresAvx512(size_t n, const double* a) {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d x0 = _mm512_loadu_pd(a + i);
+        __m512d x1 = _mm512_loadu_pd(a + i + 8);
+        acc0 = _mm512_fmadd_pd(x0, x0, acc0);
+        acc1 = _mm512_fmadd_pd(x1, x1, acc1);
+    }
+    return addLanes(_mm512_add_pd(acc0, acc1)) + sumOfSquaresScalar(n - i, a + i);
+}
+
+__attribute__((target("avx512f")))
+double sumAvx512(size_t n, const double* a) {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_add_pd(acc0, _mm512_loadu_pd(a + i));
+        acc1 = _mm512_add_pd(acc1, _mm512_loadu_pd(a + i + 8));
+    }
+    return addLanes(_mm512_add_pd(acc0, acc1)) + sumScalar(n - i, a + i);
+}
+
+__attribute__((target("avx512f")))
+void minMaxAvx512(size_t n, const double* a, double* lo, double* hi) {
+    __m512d low = _mm512_set1_pd(*lo);
+    __m512d high = _mm512_set1_pd(*hi);
+    __mmask8 nan = _mm512_cmp_pd_mask(low, high, _CMP_UNORD_Q);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d x = _mm512_loadu_pd(a + i);
+        low = _mm512_mask_min_pd(low, 0xFF, x, low);
+        high = _mm512_mask_max_pd(high, 0xFF, x, high);
+        nan |= _mm512_cmp_pd_mask(x, x, _CMP_UNORD_Q);
+    }
+    double lows[8], highs[8];
+    _mm512_storeu_pd(lows, low);
+    _mm512_storeu_pd(highs, high);
+    *lo = *std::min_element(lows, lows + 8);
+    *hi = *std::max_element(highs, highs + 8);
+    if (nan != 0) {
+        *lo = *hi = NAN;
+    }
+    minMaxScalar(n - i, a + i, lo, hi);
+}
+
+__attribute__((target("avx512f")))
+double dotAvx512(size_t n, const double* a, const double* b) {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), acc1);
+    }
+    return addLanes(_mm512_add_pd(acc0, acc1)) + dotScalar(n - i, a + i, b + i);
+}
+
+__attribute__((target("avx512f")))
+void axpyAvx512(size_t n, double alpha, const double* x, double* y) {
+    __m512d factor = _mm512_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(y + i, _mm512_fmadd_pd(factor, _mm512_loadu_pd(x + i),
+                                                _mm512_loadu_pd(y + i)));
+    }
+    axpyScalar(n - i, alpha, x + i, y + i);
+}
+
+__attribute__((target("avx512f")))
+void addAvx512(size_t n, const float* a, const float* b, float* out) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(out + i, _mm512_add_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    }
+    addScalar(n - i, a + i, b + i, out + i);
+}
+
+__attribute__((target("avx512f")))
+void subtractAvx512(size_t n, const float* a, const float* b, float* out) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(out + i, _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    }
+    subtractScalar(n - i, a + i, b + i, out + i);
+}
+
+__attribute__((target("avx512f")))
+void scaleAvx512(size_t n, float alpha, const float* a, float* out) {
+    __m512 factor = _mm512_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(out + i, _mm512_mul_ps(factor, _mm512_loadu_ps(a + i)));
+    }
+    scaleScalar(n - i, alpha, a + i, out + i);
+}
+
+#endif // ELEMENTWISE_X86
+
+// ========== DISPATCH ==========
+
+struct KernelTable {
+    const char* level;
+    void (*add)(size_t, const double*, const double*, double*);
+    void (*subtract)(size_t, const double*, const double*, double*);
+    void (*scale)(size_t, double, const double*, double*);
+    void (*fill)(size_t, double, double*);
+    double (*sumOfSquares)(size_t, const double*);
+    double (*sum)(size_t, const double*);
+    void (*minMax)(size_t, const double*, double*, double*);
+    double (*dot)(size_t, const double*, const double*);
+    void (*axpy)(size_t, double, const double*, double*);
+    void (*addFloat)(size_t, const float*, const float*, float*);
+    void (*subtractFloat)(size_t, const float*, const float*, float*);
+    void (*scaleFloat)(size_t, float, const float*, float*);
+};
+
+KernelTable selectKernels() {
+#ifdef ELEMENTWISE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {"avx512", addAvx512, subtractAvx512, scaleAvx512, fillAvx512,
+                sumOfSquaresAvx512, sumAvx512, minMaxAvx512, dotAvx512, axpyAvx512,
+                addAvx512, subtractAvx512, scaleAvx512};
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return {"avx2", addAvx2, subtractAvx2, scaleAvx2, fillAvx2, sumOfSquaresAvx2,
+                sumAvx2, minMaxAvx2, dotAvx2, axpyAvx2,
+                addAvx2, subtractAvx2, scaleAvx2};
+    }
+    return {"sse2", addSse2, subtractSse2, scaleSse2, fillSse2, sumOfSquaresSse2,
+            sumSse2, minMaxSse2, dotSse2, axpySse2,
+                addSse2, subtractSse2, scaleSse2};
+#else
+    return {"scalar", addScalar, subtractScalar, scaleScalar, fillScalar,
+            sumOfSquaresScalar, sumScalar, minMaxScalar, dotScalar, axpyScalar,
+                addScalar, subtractScalar, scaleScalar};
+#endif
+}
+
+// Chosen on first use (thread-safe static initialization)
+const KernelTable& activeKernels() {
+    static const KernelTable table = selectKernels();
+    return table;
+}
+
+} // namespace
+
+// ========== ELEMENT-WISE KERNELS ==========
+
+void add(size_t n, const double* a, const double* b, double* out) {
+    activeKernels().add(n, a, b, out);
+}
+
+void subtract(size_t n, const double* a, const double* b, double* out) {
+    activeKernels().subtract(n, a, b, out);
+}
+
+void scale(size_t n, double alpha, const double* a, double* out) {
+    activeKernels().scale(n, alpha, a, out);
+}
+
+void fill(size_t n, double value, double* out) {
+    activeKernels().fill(n, value, out);
+}
+
+double sumOfSquares(size_t n, const double* a) {
+    return activeKernels().sumOfSquares(n, a);
+}
+
+double sum(size_t n, const double* a) {
+    return activeKernels().sum(n, a);
+}
+
+void minMax(size_t n, const double* a, double* lo, double* hi) {
+    activeKernels().minMax(n, a, lo, hi);
+}
+
+void add(size_t n, const float* a, const float* b, float* out) {
+    activeKernels().addFloat(n, a, b, out);
+}
+
+void subtract(size_t n, const float* a, const float* b, float* out) {
+    activeKernels().subtractFloat(n, a, b, out);
+}
+
+void scale(size_t n, float alpha, const float* a, float* out) {
+    activeKernels().scaleFloat(n, alpha, a, out);
+}
+
+const char* simdLevel() {
+    return activeKernels().level;
+}
+
+// ========== LEVEL-1 ROUTINES ==========
+
+double dot(size_t n, const double* a, const double* b) {
+    return activeKernels().dot(n, a, b);
+}
+
+void axpy(size_t n, double alpha, const double* x, double* y) {
+    activeKernels().axpy(n, alpha, x, y);
+}
+
+double nrm2(size_t n, const double* x) {
+    double sum = sumOfSquares(n, x);
+    if ((sum > DBL_MIN && sum < DBL_MAX) || std::isnan(sum)) {
+        return std::sqrt(sum);
+    }
+    
+    // Squares overflowed or underflowed (or x is zero): divide by the
+    // largest magnitude first, as reference BLAS does
+    double largest = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        largest = std::max(largest, std::abs(x[i]));
+    }
+    if (largest == 0.0 || !std::isfinite(largest)) {
+        return largest;
+    }
+    double scaled = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double r = x[i] / largest;
+        scaled += r * r;
+    }
+    return largest * std::sqrt(scaled);
+}
+
+} // namespace kernels
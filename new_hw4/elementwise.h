@@ -0,0 +1,61 @@
+#ifndef ELEMENTWISE_H
+#define ELEMENTWISE_H
+
+#include <cstddef>
+
+namespace kernels {
+
+// ========== ELEMENT-WISE KERNELS ==========
+
+// Vectorized loops over n contiguous doubles. Each routine has AVX-512,
+// AVX2 and SSE2 versions; the widest one the CPU supports is picked once,
+// at first use. out may be the same array as an input (but must not
+// partially overlap one).
+
+// out = a + b
+void add(size_t n, const double* a, const double* b, double* out);
+
+// out = a - b
+void subtract(size_t n, const double* a, const double* b, double* out);
+
+// out = alpha * a
+void scale(size_t n, double alpha, const double* a, double* out);
+
+// out = value
+void fill(size_t n, double value, double* out);
+
+// Sum of a[i]^2
+double sumOfSquares(size_t n, const double* a);
+
+// Sum of a[i]
+double sum(size_t n, const double* a);
+
+// Widen [*lo, *hi] to cover a[0 .. n). Start from +inf and -inf for the
+// extremes of a alone. A NaN element (or bound) makes both results NaN.
+void minMax(size_t n, const double* a, double* lo, double* hi);
+
+// Single-precision versions for BasicMatrix<float>, twice as many
+// elements per vector
+void add(size_t n, const float* a, const float* b, float* out);
+void subtract(size_t n, const float* a, const float* b, float* out);
+void scale(size_t n, float alpha, const float* a, float* out);
+
+// Instruction set the kernels run with: "avx512", "avx2", "sse2" or
+// "scalar" on non-x86 targets
+const char* simdLevel();
+
+// ========== LEVEL-1 ROUTINES ==========
+
+// Sum of a[i] * b[i]
+double dot(size_t n, const double* a, const double* b);
+
+// y += alpha * x
+void axpy(size_t n, double alpha, const double* x, double* y);
+
+// Euclidean norm sqrt(sum x[i]^2). Takes the sumOfSquares fast path and
+// only rescales (a second pass) when the squares overflow or underflow.
+double nrm2(size_t n, const double* x);
+
+} // namespace kernels
+
+#endif // ELEMENTWISE_H
@@ -0,0 +1,282 @@
+#ifndef FIXED_MATRIX_H
+#define FIXED_MATRIX_H
+
+#include <array>
+#include <iostream>
+#include <stdexcept>
+#include <initializer_list>
+#include <utility>
+#include <cmath>
+#include <cstddef>
+#include "matrix.h"
+#include "matrix_view.h"
+
+// R x C matrix of doubles whose shape is part of its type, for small
+// fixed-size work such as geometric transforms.
+//
+// Elements live inline (no heap allocation), so FixedMatrix is trivially
+// copyable and can sit on the stack or inside other objects. Operators only
+// accept operands of matching shape, so a mismatch is a compile error
+// rather than a runtime check, and every loop is expanded over its
+// compile-time bounds. Convert to and from Matrix at the boundary with
+// dynamic code; view() lets a FixedMatrix be passed where a ConstMatrixView
+// is expected.
+template <size_t R, size_t C>
+class FixedMatrix {
+private:
+    static_assert(R > 0 && C > 0, "FixedMatrix dimensions must be positive");
+
+    std::array<double, R * C> data_;
+
+    static constexpr double EPSILON = 1e-9;
+
+    // Call f(0), f(1), ..., f(N - 1) with each index as a compile-time
+    // constant, so the loop is expanded in the source rather than left to
+    // the optimizer
+    template <typename F, size_t... I>
+    static constexpr void unrolledImpl(F&& f, std::index_sequence<I...>) {
+        (f(std::integral_constant<size_t, I>()), ...);
+    }
+
+    template <size_t N, typename F>
+    static constexpr void unrolled(F&& f) {
+        unrolledImpl(f, std::make_index_sequence<N>());
+    }
+
+    template <size_t, size_t>
+    friend class FixedMatrix;
+
+public:
+    // ========== CONSTRUCTORS ==========
+
+    // Zero-initialized
+    constexpr FixedMatrix() : data_() {}
+
+    // Every element set to value
+    explicit constexpr FixedMatrix(double value) : data_() {
+        unrolled<R * C>([&](auto i) { data_[i] = value; });
+    }
+
+    // From a nested initializer list; the list must be exactly R x C
+    // (std::invalid_argument)
+    FixedMatrix(std::initializer_list<std::initializer_list<double>> list) : data_() {
+        if (list.size() != R) {
+            throw std::invalid_argument("Initializer list has the wrong number of rows");
+        }
+        size_t i = 0;
+        for (const auto& row : list) {
+            if (row.size() != C) {
+                throw std::invalid_argument("Initializer list has the wrong number of columns");
+            }
+            std::copy(row.begin(), row.end(), data_.begin() + i * C);
+            ++i;
+        }
+    }
+
+    // From a dynamic matrix or view of shape R x C (std::invalid_argument
+    // otherwise)
+    explicit FixedMatrix(ConstMatrixView m) : data_() {
+        if (m.rows() != R || m.cols() != C) {
+            throw std::invalid_argument("Matrix dimensions do not match FixedMatrix");
+        }
+        for (size_t i = 0; i < R; ++i) {
+            for (size_t j = 0; j < C; ++j) {
+                data_[i * C + j] = m(i, j);
+            }
+        }
+    }
+
+    // ========== CONVERSION ==========
+
+    Matrix toMatrix() const {
+        Matrix result(R, C);
+        std::copy(data_.begin(), data_.end(), result.data());
+        return result;
+    }
+
+    // Read-only view of the elements, valid while this object lives
+    ConstMatrixView view() const {
+        return ConstMatrixView(data_.data(), R, C, C);
+    }
+
+    // ========== ELEMENT ACCESS ==========
+
+    constexpr double& operator()(size_t row, size_t col) { return data_[row * C + col]; }
+    constexpr const double& operator()(size_t row, size_t col) const { return data_[row * C + col]; }
+
+    // Access with bounds checking (throw std::out_of_range)
+    double& at(size_t row, size_t col) {
+        if (row >= R || col >= C) {
+            throw std::out_of_range("Matrix index out of range");
+        }
+        return (*this)(row, col);
+    }
+
+    const double& at(size_t row, size_t col) const {
+        if (row >= R || col >= C) {
+            throw std::out_of_range("Matrix index out of range");
+        }
+        return (*this)(row, col);
+    }
+
+    // Row-major element storage
+    constexpr double* data() { return data_.data(); }
+    constexpr const double* data() const { return data_.data(); }
+
+    // ========== SIZE AND PROPERTIES ==========
+
+    static constexpr size_t rows() { return R; }
+    static constexpr size_t cols() { return C; }
+    static constexpr bool isSquare() { return R == C; }
+
+    // ========== ARITHMETIC OPERATORS ==========
+
+    constexpr FixedMatrix operator+(const FixedMatrix& other) const {
+        FixedMatrix result(*this);
+        result += other;
+        return result;
+    }
+
+    constexpr FixedMatrix operator-(const FixedMatrix& other) const {
+        FixedMatrix result(*this);
+        result -= other;
+        return result;
+    }
+
+    // (R x C) * (C x K); an operand with the wrong number of rows does not
+    // compile
+    template <size_t K>
+    constexpr FixedMatrix<R, K> operator*(const FixedMatrix<C, K>& other) const {
+        FixedMatrix<R, K> result;
+        unrolled<R>([&](auto i) {
+            unrolled<C>([&](auto p) {
+                double a_ip = data_[i * C + p];
+                unrolled<K>([&](auto j) {
+                    result.data_[i * K + j] += a_ip * other.data_[p * K + j];
+                });
+            });
+        });
+        return result;
+    }
+
+    constexpr FixedMatrix operator*(double scalar) const {
+        FixedMatrix result(*this);
+        result *= scalar;
+        return result;
+    }
+
+    FixedMatrix operator/(double scalar) const {
+        FixedMatrix result(*this);
+        result /= scalar;
+        return result;
+    }
+
+    constexpr FixedMatrix operator-() const {
+        FixedMatrix result;
+        unrolled<R * C>([&](auto i) { result.data_[i] = -data_[i]; });
+        return result;
+    }
+
+    friend constexpr FixedMatrix operator*(double scalar, const FixedMatrix& m) {
+        return m * scalar;
+    }
+
+    // ========== COMPOUND ASSIGNMENT OPERATORS ==========
+
+    constexpr FixedMatrix& operator+=(const FixedMatrix& other) {
+        unrolled<R * C>([&](auto i) { data_[i] += other.data_[i]; });
+        return *this;
+    }
+
+    constexpr FixedMatrix& operator-=(const FixedMatrix& other) {
+        unrolled<R * C>([&](auto i) { data_[i] -= other.data_[i]; });
+        return *this;
+    }
+
+    // Only square right-hand sides keep the shape
+    constexpr FixedMatrix& operator*=(const FixedMatrix<C, C>& other) {
+        *this = (*this) * other;
+        return *this;
+    }
+
+    constexpr FixedMatrix& operator*=(double scalar) {
+        unrolled<R * C>([&](auto i) { data_[i] *= scalar; });
+        return *this;
+    }
+
+    FixedMatrix& operator/=(double scalar) {
+        if (std::abs(scalar) < EPSILON) {
+            throw std::invalid_argument("Division by zero");
+        }
+        return *this *= 1.0 / scalar;
+    }
+
+    // ========== COMPARISON OPERATORS ==========
+
+    // Element-wise within EPSILON, as for Matrix
+    bool operator==(const FixedMatrix& other) const {
+        bool equal = true;
+        unrolled<R * C>([&](auto i) {
+            equal = equal && std::abs(data_[i] - other.data_[i]) < EPSILON;
+        });
+        return equal;
+    }
+
+    bool operator!=(const FixedMatrix& other) const {
+        return !(*this == other);
+    }
+
+    // ========== MATRIX OPERATIONS ==========
+
+    constexpr FixedMatrix<C, R> transpose() const {
+        FixedMatrix<C, R> result;
+        unrolled<R>([&](auto i) {
+            unrolled<C>([&](auto j) { result.data_[j * R + i] = data_[i * C + j]; });
+        });
+        return result;
+    }
+
+    constexpr double trace() const {
+        static_assert(R == C, "Trace requires square matrix");
+        double sum = 0.0;
+        unrolled<R>([&](auto i) { sum += data_[i * C + i]; });
+        return sum;
+    }
+
+    constexpr void fill(double value) {
+        unrolled<R * C>([&](auto i) { data_[i] = value; });
+    }
+
+    // Frobenius norm
+    double norm() const {
+        double sum = 0.0;
+        unrolled<R * C>([&](auto i) { sum += data_[i] * data_[i]; });
+        return std::sqrt(sum);
+    }
+
+    // ========== STATIC FACTORY METHODS ==========
+
+    static constexpr FixedMatrix identity() {
+        static_assert(R == C, "Identity requires square matrix");
+        FixedMatrix result;
+        unrolled<R>([&](auto i) { result.data_[i * C + i] = 1.0; });
+        return result;
+    }
+
+    static constexpr FixedMatrix zeros() {
+        return FixedMatrix();
+    }
+
+    static constexpr FixedMatrix ones() {
+        return FixedMatrix(1.0);
+    }
+
+    // ========== STREAM OPERATORS ==========
+
+    // Same format as Matrix
+    friend std::ostream& operator<<(std::ostream& os, const FixedMatrix& m) {
+        return os << m.toMatrix();
+    }
+};
+
+#endif // FIXED_MATRIX_H
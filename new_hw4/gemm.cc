@@ -0,0 +1,315 @@
+#include "gemm.h"
+#include "thread_pool.h"
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace kernels {
+
+namespace {
+
+// ========== PACKING ==========
+
+// Pack an mc x kc block of A into MR-row slivers. Within a sliver the
+// MR values of one column are contiguous, so the micro-kernel reads A
+// with unit stride. Rows past mc are zero-padded.
+template <typename T>
+void packA(size_t mc, size_t kc, const T* A, size_t rsA, size_t csA, T* packed) {
+    for (size_t ir = 0; ir < mc; ir += GEMM_MR) {
+        size_t mr = std::min(GEMM_MR, mc - ir);
+        for (size_t p = 0; p < kc; ++p) {
+            for (size_t i = 0; i < mr; ++i) {
+                packed[i] = A[(ir + i) * rsA + p * csA];
+            }
+            for (size_t i = mr; i < GEMM_MR; ++i) {
+                packed[i] = T(0);
+            }
+            packed += GEMM_MR;
+        }
+    }
+}
+
+// Pack a kc x nc block of B into NR-column slivers, one row of NR values
+// after another. Columns past nc are zero-padded.
+template <typename T, size_t NR>
+void packB(size_t kc, size_t nc, const T* B, size_t rsB, size_t csB, T* packed) {
+    for (size_t jr = 0; jr < nc; jr += NR) {
+        size_t nr = std::min(NR, nc - jr);
+        for (size_t p = 0; p < kc; ++p) {
+            const T* row = B + p * rsB + jr * csB;
+            for (size_t j = 0; j < nr; ++j) {
+                packed[j] = row[j * csB];
+            }
+            for (size_t j = nr; j < NR; ++j) {
+                packed[j] = T(0);
+            }
+            packed += NR;
+        }
+    }
+}
+
+// ========== MICRO-KERNEL ==========
+
+// Multiply one packed MR x kc sliver of A by one packed kc x NR sliver of B
+// into an MR x NR register tile, then add alpha times the tile into the
+// mr x nr corner of C that actually exists.
+template <typename T, size_t NR>
+void microKernel(size_t kc, T alpha, const T* a, const T* b,
+                 T* C, size_t rsC, size_t mr, size_t nr) {
+    T acc[GEMM_MR][NR] = {};
+
+    for (size_t p = 0; p < kc; ++p) {
+        for (size_t i = 0; i < GEMM_MR; ++i) {
+            T a_ip = a[i];
+            for (size_t j = 0; j < NR; ++j) {
+                acc[i][j] += a_ip * b[j];
+            }
+        }
+        a += GEMM_MR;
+        b += NR;
+    }
+
+    for (size_t i = 0; i < mr; ++i) {
+        T* c_row = C + i * rsC;
+        for (size_t j = 0; j < nr; ++j) {
+            c_row[j] += alpha * acc[i][j];
+        }
+    }
+}
+
+size_t roundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+size_t ceilDiv(size_t value, size_t divisor) {
+    return (value + divisor - 1) / divisor;
+}
+
+std::atomic<size_t> g_parallel_threshold(GEMM_DEFAULT_PARALLEL_THRESHOLD);
+std::atomic<FloatAccumulation> g_float_accumulation(FloatAccumulation::Double);
+
+// ========== ENGINES ==========
+
+// Shared by the double and float entry points; only the register tile
+// width NR depends on the element type
+
+template <typename T>
+void smallLoop(size_t m, size_t n, size_t k, T alpha,
+               const T* A, size_t rsA, size_t csA,
+               const T* B, size_t rsB, size_t csB,
+               T* C, size_t rsC) {
+    for (size_t i = 0; i < m; ++i) {
+        T* c_row = C + i * rsC;
+        for (size_t p = 0; p < k; ++p) {
+            T a_ip = alpha * A[i * rsA + p * csA];
+            const T* b_row = B + p * rsB;
+            for (size_t j = 0; j < n; ++j) {
+                c_row[j] += a_ip * b_row[j * csB];
+            }
+        }
+    }
+}
+
+template <typename T, size_t NR>
+void blockedEngine(size_t m, size_t n, size_t k, T alpha,
+                   const T* A, size_t rsA, size_t csA,
+                   const T* B, size_t rsB, size_t csB,
+                   T* C, size_t rsC) {
+    // Packing buffers are reused across calls so steady-state multiplies
+    // do not touch the allocator
+    thread_local std::vector<T> packed_a;
+    thread_local std::vector<T> packed_b;
+    packed_a.resize(GEMM_MC * GEMM_KC);
+    packed_b.resize(GEMM_KC * roundUp(std::min(n, GEMM_NC), NR));
+
+    for (size_t jc = 0; jc < n; jc += GEMM_NC) {
+        size_t nc = std::min(GEMM_NC, n - jc);
+
+        for (size_t pc = 0; pc < k; pc += GEMM_KC) {
+            size_t kc = std::min(GEMM_KC, k - pc);
+            packB<T, NR>(kc, nc, B + pc * rsB + jc * csB, rsB, csB, packed_b.data());
+
+            for (size_t ic = 0; ic < m; ic += GEMM_MC) {
+                size_t mc = std::min(GEMM_MC, m - ic);
+                packA(mc, kc, A + ic * rsA + pc * csA, rsA, csA, packed_a.data());
+
+                for (size_t jr = 0; jr < nc; jr += NR) {
+                    size_t nr = std::min(NR, nc - jr);
+                    const T* b_sliver = packed_b.data() + jr * kc;
+
+                    for (size_t ir = 0; ir < mc; ir += GEMM_MR) {
+                        size_t mr = std::min(GEMM_MR, mc - ir);
+                        const T* a_sliver = packed_a.data() + ir * kc;
+                        microKernel<T, NR>(kc, alpha, a_sliver, b_sliver,
+                                           C + (ic + ir) * rsC + jc + jr, rsC, mr, nr);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename T, size_t NR>
+void parallelEngine(size_t m, size_t n, size_t k, T alpha,
+                    const T* A, size_t rsA, size_t csA,
+                    const T* B, size_t rsB, size_t csB,
+                    T* C, size_t rsC) {
+    ThreadPool& pool = ThreadPool::global();
+
+    // Aim for a few tiles per thread so uneven tiles still balance, and
+    // split the longer side of C more finely to keep tiles roughly square.
+    // Tiles never straddle a register tile, so no two tasks write the
+    // same element of C.
+    size_t target_tiles = 4 * pool.size();
+    double aspect = static_cast<double>(m) / static_cast<double>(n);
+    size_t row_parts = static_cast<size_t>(std::lround(std::sqrt(target_tiles * aspect)));
+    row_parts = std::min(std::max<size_t>(row_parts, 1), ceilDiv(m, GEMM_MR));
+    size_t col_parts = std::min(ceilDiv(target_tiles, row_parts), ceilDiv(n, NR));
+
+    size_t tile_rows = roundUp(ceilDiv(m, row_parts), GEMM_MR);
+    size_t tile_cols = roundUp(ceilDiv(n, col_parts), NR);
+    row_parts = ceilDiv(m, tile_rows);
+    col_parts = ceilDiv(n, tile_cols);
+
+    pool.parallelFor(row_parts * col_parts, [&](size_t tile) {
+        size_t i0 = (tile / col_parts) * tile_rows;
+        size_t j0 = (tile % col_parts) * tile_cols;
+        size_t mt = std::min(tile_rows, m - i0);
+        size_t nt = std::min(tile_cols, n - j0);
+        blockedEngine<T, NR>(mt, nt, k, alpha,
+                             A + i0 * rsA, rsA, csA,
+                             B + j0 * csB, rsB, csB,
+                             C + i0 * rsC + j0, rsC);
+    });
+}
+
+// Size dispatch shared by gemm and gemmFloat
+template <typename T, size_t NR>
+void dispatch(size_t m, size_t n, size_t k, T alpha,
+              const T* A, size_t rsA, size_t csA,
+              const T* B, size_t rsB, size_t csB,
+              T* C, size_t rsC) {
+    if (m == 0 || n == 0 || k == 0 || alpha == T(0)) {
+        return;
+    }
+    size_t flops = m * n * k;
+    if (flops <= GEMM_SMALL_THRESHOLD) {
+        smallLoop(m, n, k, alpha, A, rsA, csA, B, rsB, csB, C, rsC);
+    } else if (flops >= g_parallel_threshold.load() && numThreads() > 1) {
+        parallelEngine<T, NR>(m, n, k, alpha, A, rsA, csA, B, rsB, csB, C, rsC);
+    } else {
+        blockedEngine<T, NR>(m, n, k, alpha, A, rsA, csA, B, rsB, csB, C, rsC);
+    }
+}
+
+} // namespace
+
+// ========== GEMM CONFIGURATION ==========
+
+void setGemmParallelThreshold(size_t flops) {
+    g_parallel_threshold.store(flops);
+}
+
+size_t gemmParallelThreshold() {
+    return g_parallel_threshold.load();
+}
+
+// ========== GEMM ENTRY POINTS ==========
+
+void gemm(size_t m, size_t n, size_t k, double alpha,
+          const double* A, size_t rsA, size_t csA,
+          const double* B, size_t rsB, size_t csB,
+          double* C, size_t rsC) {
+    dispatch<double, GEMM_NR>(m, n, k, alpha, A, rsA, csA, B, rsB, csB, C, rsC);
+}
+
+void gemmSmall(size_t m, size_t n, size_t k, double alpha,
+               const double* A, size_t rsA, size_t csA,
+               const double* B, size_t rsB, size_t csB,
+               double* C, size_t rsC) {
+    smallLoop(m, n, k, alpha, A, rsA, csA, B, rsB, csB, C, rsC);
+}
+
+void gemmBlocked(size_t m, size_t n, size_t k, double alpha,
+                 const double* A, size_t rsA, size_t csA,
+                 const double* B, size_t rsB, size_t csB,
+                 double* C, size_t rsC) {
+    blockedEngine<double, GEMM_NR>(m, n, k, alpha, A, rsA, csA, B, rsB, csB, C, rsC);
+}
+
+void gemmParallel(size_t m, size_t n, size_t k, double alpha,
+                  const double* A, size_t rsA, size_t csA,
+                  const double* B, size_t rsB, size_t csB,
+                  double* C, size_t rsC) {
+    parallelEngine<double, GEMM_NR>(m, n, k, alpha, A, rsA, csA, B, rsB, csB, C, rsC);
+}
+
+// ========== SINGLE PRECISION ==========
+
+void setFloatAccumulation(FloatAccumulation mode) {
+    g_float_accumulation.store(mode);
+}
+
+FloatAccumulation floatAccumulation() {
+    return g_float_accumulation.load();
+}
+
+void gemmFloat(size_t m, size_t n, size_t k, float alpha,
+               const float* A, size_t rsA, size_t csA,
+               const float* B, size_t rsB, size_t csB,
+               float* C, size_t rsC) {
+    dispatch<float, GEMM_FLOAT_NR>(m, n, k, alpha, A, rsA, csA, B, rsB, csB, C, rsC);
+}
+
+void gemmMixed(size_t m, size_t n, size_t k, double alpha,
+               const float* A, size_t rsA, size_t csA,
+               const float* B, size_t rsB, size_t csB,
+               float* C, size_t rsC) {
+    if (m == 0 || n == 0 || k == 0 || alpha == 0.0) {
+        return;
+    }
+    thread_local std::vector<double> wide_a;
+    thread_local std::vector<double> wide_b;
+    thread_local std::vector<double> acc;
+
+    for (size_t jc = 0; jc < n; jc += GEMM_MIXED_NC) {
+        size_t nc = std::min(GEMM_MIXED_NC, n - jc);
+
+        for (size_t ic = 0; ic < m; ic += GEMM_MIXED_MC) {
+            size_t mc = std::min(GEMM_MIXED_MC, m - ic);
+            acc.assign(mc * nc, 0.0);
+
+            // The whole k dimension is summed in double before rounding
+            for (size_t pc = 0; pc < k; pc += GEMM_KC) {
+                size_t kc = std::min(GEMM_KC, k - pc);
+                wide_a.resize(mc * kc);
+                wide_b.resize(kc * nc);
+                for (size_t i = 0; i < mc; ++i) {
+                    const float* a_row = A + (ic + i) * rsA + pc * csA;
+                    for (size_t p = 0; p < kc; ++p) {
+                        wide_a[i * kc + p] = a_row[p * csA];
+                    }
+                }
+                for (size_t p = 0; p < kc; ++p) {
+                    const float* b_row = B + (pc + p) * rsB + jc * csB;
+                    for (size_t j = 0; j < nc; ++j) {
+                        wide_b[p * nc + j] = b_row[j * csB];
+                    }
+                }
+                gemm(mc, nc, kc, 1.0, wide_a.data(), kc, 1, wide_b.data(), nc, 1,
+                     acc.data(), nc);
+            }
+
+            for (size_t i = 0; i < mc; ++i) {
+                float* c_row = C + (ic + i) * rsC + jc;
+                const double* acc_row = acc.data() + i * nc;
+                for (size_t j = 0; j < nc; ++j) {
+                    c_row[j] = static_cast<float>(c_row[j] + alpha * acc_row[j]);
+                }
+            }
+        }
+    }
+}
+
+} // namespace kernels
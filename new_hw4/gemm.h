@@ -0,0 +1,105 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include <cstddef>
+
+namespace kernels {
+
+// ========== GEMM BLOCKING PARAMETERS ==========
+
+// Register tile computed by the micro-kernel (MR rows x NR columns of C)
+constexpr size_t GEMM_MR = 6;
+constexpr size_t GEMM_NR = 8;
+
+// Cache blocks: an MC x KC panel of A stays in L2, a KC x NC panel of B in L3,
+// and one KC x NR sliver of B is streamed through L1 by the micro-kernel
+constexpr size_t GEMM_MC = 96;
+constexpr size_t GEMM_KC = 256;
+constexpr size_t GEMM_NC = 2048;
+
+// Products with m * n * k at or below this use the unpacked scalar loop
+constexpr size_t GEMM_SMALL_THRESHOLD = 64 * 64 * 64;
+
+// Default m * n * k at or above which gemm splits C across the thread pool
+constexpr size_t GEMM_DEFAULT_PARALLEL_THRESHOLD = 128 * 128 * 128;
+
+// ========== GEMM CONFIGURATION ==========
+
+// Products with m * n * k below the threshold stay on the calling thread;
+// the thread count itself is set with kernels::setNumThreads
+void setGemmParallelThreshold(size_t flops);
+size_t gemmParallelThreshold();
+
+// ========== GEMM ENTRY POINTS ==========
+
+// All routines compute C (m x n) += alpha * A (m x k) * B (k x n).
+// Element (i, j) of A lives at A[i * rsA + j * csA] (likewise for B), so
+// transposed or strided operands need no copy. C is row-major with row
+// stride rsC.
+
+// Size-dispatching entry point: small shapes take gemmSmall, large ones
+// gemmParallel, and the rest run the blocked engine on the calling thread
+void gemm(size_t m, size_t n, size_t k, double alpha,
+          const double* A, size_t rsA, size_t csA,
+          const double* B, size_t rsB, size_t csB,
+          double* C, size_t rsC);
+
+// Scalar i-k-j loop with no packing overhead
+void gemmSmall(size_t m, size_t n, size_t k, double alpha,
+               const double* A, size_t rsA, size_t csA,
+               const double* B, size_t rsB, size_t csB,
+               double* C, size_t rsC);
+
+// Packed, L1/L2/L3-blocked engine built around an MR x NR micro-kernel
+void gemmBlocked(size_t m, size_t n, size_t k, double alpha,
+                 const double* A, size_t rsA, size_t csA,
+                 const double* B, size_t rsB, size_t csB,
+                 double* C, size_t rsC);
+
+// Partition C into tiles and run gemmBlocked on each tile in parallel on
+// the global thread pool
+void gemmParallel(size_t m, size_t n, size_t k, double alpha,
+                  const double* A, size_t rsA, size_t csA,
+                  const double* B, size_t rsB, size_t csB,
+                  double* C, size_t rsC);
+
+// ========== SINGLE PRECISION ==========
+
+// Register tile width of the float engine: two AVX-512 vectors per row of
+// C, so the MR x NR tile fills 12 vector registers. (GCC 12 vectorizes a
+// 16-wide float tile across rows with narrow shuffles instead.)
+constexpr size_t GEMM_FLOAT_NR = 32;
+
+// How BasicMatrix<float> products accumulate. Double (the default) goes
+// through gemmMixed: every sum is accumulated in double, but the
+// arithmetic runs at double speed. Single uses gemmFloat, which runs the
+// same blocked engine on float vectors at twice the throughput, with
+// rounding error growing with k as in any float GEMM.
+enum class FloatAccumulation { Double, Single };
+void setFloatAccumulation(FloatAccumulation mode);
+FloatAccumulation floatAccumulation();
+
+// Same dispatch, packing and threading as gemm, accumulating in float
+void gemmFloat(size_t m, size_t n, size_t k, float alpha,
+               const float* A, size_t rsA, size_t csA,
+               const float* B, size_t rsB, size_t csB,
+               float* C, size_t rsC);
+
+// ========== MIXED PRECISION ==========
+
+// Row and column block of C accumulated in double by gemmMixed
+constexpr size_t GEMM_MIXED_MC = 192;
+constexpr size_t GEMM_MIXED_NC = 512;
+
+// C += alpha * A * B for float operands with every sum accumulated in
+// double: blocks of A and B are widened to double, multiplied by the
+// double GEMM (so large products are blocked and threaded as usual), and
+// the finished sums are rounded to float once
+void gemmMixed(size_t m, size_t n, size_t k, double alpha,
+               const float* A, size_t rsA, size_t csA,
+               const float* B, size_t rsB, size_t csB,
+               float* C, size_t rsC);
+
+} // namespace kernels
+
+#endif // GEMM_H
@@ -0,0 +1,103 @@
+#include "gemv.h"
+#include "elementwise.h"
+#include "thread_pool.h"
+#include <algorithm>
+
+namespace kernels {
+
+namespace {
+
+size_t ceilDiv(size_t value, size_t divisor) {
+    return (value + divisor - 1) / divisor;
+}
+
+// y = beta * y, never reading y when beta is zero
+void scaleOutput(size_t n, double beta, double* y) {
+    if (beta == 0.0) {
+        fill(n, 0.0, y);
+    } else if (beta != 1.0) {
+        scale(n, beta, y, y);
+    }
+}
+
+// Rows [begin, end) of y = alpha * A * x + beta * y
+void gemvRows(size_t begin, size_t end, size_t n, double alpha, const double* A,
+              size_t lda, const double* x, double beta, double* y) {
+    for (size_t i = begin; i < end; ++i) {
+        double sum = alpha * dot(n, A + i * lda, x);
+        y[i] = beta == 0.0 ? sum : sum + beta * y[i];
+    }
+}
+
+// Columns [begin, end) of y = alpha * A^T * x, y already scaled by beta.
+// Rows with x[i] == 0 are skipped, as reference BLAS does.
+void gemvColumns(size_t begin, size_t end, size_t m, double alpha, const double* A,
+                 size_t lda, const double* x, double* y) {
+    for (size_t j = begin; j < end; j += GEMV_COLUMN_BLOCK) {
+        size_t width = std::min(GEMV_COLUMN_BLOCK, end - j);
+        for (size_t i = 0; i < m; ++i) {
+            if (x[i] != 0.0) {
+                axpy(width, alpha * x[i], A + i * lda + j, y + j);
+            }
+        }
+    }
+}
+
+// Number of ranges to split `count` rows or columns into: one per thread
+// when the product is big enough, else one
+size_t rangeCount(size_t m, size_t n, size_t count) {
+    size_t threads = numThreads();
+    if (threads <= 1 || m * n < GEMV_PARALLEL_THRESHOLD) {
+        return 1;
+    }
+    return std::max<size_t>(1, std::min(threads, count / 8));
+}
+
+} // namespace
+
+// ========== GEMV ENTRY POINTS ==========
+
+void gemv(size_t m, size_t n, double alpha, const double* A, size_t lda,
+          const double* x, double beta, double* y) {
+    if (m == 0) {
+        return;
+    }
+    if (n == 0 || alpha == 0.0) {
+        scaleOutput(m, beta, y);
+        return;
+    }
+
+    size_t parts = rangeCount(m, n, m);
+    if (parts == 1) {
+        gemvRows(0, m, n, alpha, A, lda, x, beta, y);
+        return;
+    }
+    size_t chunk = ceilDiv(m, parts);
+    ThreadPool::global().parallelFor(parts, [&](size_t t) {
+        gemvRows(t * chunk, std::min(m, (t + 1) * chunk), n, alpha, A, lda, x, beta, y);
+    });
+}
+
+void gemvTransposed(size_t m, size_t n, double alpha, const double* A, size_t lda,
+                    const double* x, double beta, double* y) {
+    if (n == 0) {
+        return;
+    }
+    scaleOutput(n, beta, y);
+    if (m == 0 || alpha == 0.0) {
+        return;
+    }
+
+    size_t parts = rangeCount(m, n, n);
+    if (parts == 1) {
+        gemvColumns(0, n, m, alpha, A, lda, x, y);
+        return;
+    }
+    // Column ranges start on 8-double (one cache line) boundaries
+    size_t chunk = ceilDiv(ceilDiv(n, parts), 8) * 8;
+    ThreadPool::global().parallelFor(ceilDiv(n, chunk), [&](size_t t) {
+        gemvColumns(t * chunk, std::min(n, (t + 1) * chunk), m, alpha, A, lda, x, y);
+    });
+}
+
+} // namespace kernels
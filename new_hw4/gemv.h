@@ -0,0 +1,37 @@
+#ifndef GEMV_H
+#define GEMV_H
+
+#include <cstddef>
+
+namespace kernels {
+
+// ========== GEMV PARAMETERS ==========
+
+// Products touching at least this many matrix elements are split across
+// the global thread pool
+constexpr size_t GEMV_PARALLEL_THRESHOLD = 1 << 16;
+
+// Columns of y updated together by the transposed kernel (16 KB, so the
+// block of y stays in L1 while every row of A streams past it)
+constexpr size_t GEMV_COLUMN_BLOCK = 2048;
+
+// ========== GEMV ENTRY POINTS ==========
+
+// A is m x n, row-major with row stride lda. As in BLAS, beta == 0
+// overwrites y without reading it. Matrix-vector products are memory
+// bound: each element of A is read once, by the SIMD dot and axpy kernels.
+
+// y (m) = alpha * A * x (n) + beta * y. Rows of A are split across the
+// thread pool; each row is one dot product with x.
+void gemv(size_t m, size_t n, double alpha, const double* A, size_t lda,
+          const double* x, double beta, double* y);
+
+// y (n) = alpha * A^T * x (m) + beta * y, reading A row by row (no
+// transpose is formed). Columns of y are split across the thread pool, so
+// no two threads write the same element.
+void gemvTransposed(size_t m, size_t n, double alpha, const double* A, size_t lda,
+                    const double* x, double beta, double* y);
+
+} // namespace kernels
+
+#endif // GEMV_H
@@ -0,0 +1,332 @@
+#include "krylov.h"
+#include "elementwise.h"
+#include "gemv.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Check shapes, size x and start the history. Returns ||b||; when it is
+// zero x is set to zero and the result is already complete.
+double begin(const LinearOperator& a, const Vector& b, Vector& x,
+             const SolverOptions& options, SolverResult& result) {
+    if (a.rows() != a.cols()) {
+        throw std::logic_error("Iterative solver requires a square operator");
+    }
+    if (b.size() != a.rows()) {
+        throw std::invalid_argument("Right-hand side size does not match operator");
+    }
+    if (options.preconditioner && options.preconditioner->size() != a.rows()) {
+        throw std::invalid_argument("Preconditioner size does not match operator");
+    }
+    if (x.size() != b.size()) {
+        x = Vector(b.size());
+    }
+
+    double b_norm = nrm2(b);
+    if (b_norm == 0.0) {
+        x.fill(0.0);
+        result.converged = true;
+        result.residual_history.push_back(0.0);
+        if (options.monitor) {
+            options.monitor(0, 0.0);
+        }
+    }
+    return b_norm;
+}
+
+// Record the relative residual after result.iterations iterations and
+// report whether it meets the tolerance
+bool record(SolverResult& result, const SolverOptions& options, double residual) {
+    result.residual = residual;
+    result.converged = residual <= options.tolerance;
+    result.residual_history.push_back(residual);
+    if (options.monitor) {
+        options.monitor(result.iterations, residual);
+    }
+    return result.converged;
+}
+
+// r = b - A * x
+void residualInto(const LinearOperator& a, const Vector& b, const Vector& x, Vector& r) {
+    a.apply(x, r);
+    for (size_t i = 0; i < r.size(); ++i) {
+        r[i] = b[i] - r[i];
+    }
+}
+
+// z = M^-1 * r, or a copy of r without a preconditioner
+void precondition(const Preconditioner* m, const Vector& r, Vector& z) {
+    if (m) {
+        m->apply(r, z);
+    } else {
+        z = r;
+    }
+}
+
+} // namespace
+
+// ========== LINEAR OPERATOR ==========
+
+LinearOperator::LinearOperator(const Matrix& a)
+    : rows_(a.rows()), cols_(a.cols()),
+      apply_([&a](const Vector& x, Vector& y) { multiply_into(a, x, y); }) {}
+
+LinearOperator::LinearOperator(const SparseMatrix& a)
+    : rows_(a.rows()), cols_(a.cols()),
+      apply_([&a](const Vector& x, Vector& y) { multiply_into(a, x, y); }) {}
+
+LinearOperator::LinearOperator(size_t n, Apply apply)
+    : rows_(n), cols_(n), apply_(std::move(apply)) {
+    if (!apply_) {
+        throw std::invalid_argument("Linear operator requires a callback");
+    }
+}
+
+void LinearOperator::apply(const Vector& x, Vector& y) const {
+    if (x.size() != cols_) {
+        throw std::invalid_argument("Vector size does not match operator");
+    }
+    if (y.size() != rows_) {
+        y.resize(rows_);
+    }
+    apply_(x, y);
+}
+
+// ========== CONJUGATE GRADIENT ==========
+
+SolverResult ConjugateGradientSolver::solve(const LinearOperator& a, const Vector& b,
+                                            Vector& x, const SolverOptions& options) {
+    SolverResult result;
+    double b_norm = begin(a, b, x, options, result);
+    if (b_norm == 0.0) {
+        return result;
+    }
+
+    residualInto(a, b, x, r_);
+    if (record(result, options, nrm2(r_) / b_norm)) {
+        return result;
+    }
+    precondition(options.preconditioner, r_, z_);
+    p_ = z_;
+    double rz = dot(r_, z_);
+
+    while (result.iterations < options.max_iterations) {
+        a.apply(p_, q_);
+        double pq = dot(p_, q_);
+        // A (or M) is not positive definite along p
+        if (!(pq > 0.0)) {
+            break;
+        }
+        double alpha = rz / pq;
+        axpy(alpha, p_, x);
+        axpy(-alpha, q_, r_);
+        ++result.iterations;
+        if (record(result, options, nrm2(r_) / b_norm)) {
+            break;
+        }
+
+        precondition(options.preconditioner, r_, z_);
+        double rz_next = dot(r_, z_);
+        double beta = rz_next / rz;
+        rz = rz_next;
+        for (size_t i = 0; i < p_.size(); ++i) {
+            p_[i] = z_[i] + beta * p_[i];
+        }
+    }
+    return result;
+}
+
+// ========== BICGSTAB ==========
+
+SolverResult BiCGSTABSolver::solve(const LinearOperator& a, const Vector& b, Vector& x,
+                                   const SolverOptions& options) {
+    SolverResult result;
+    double b_norm = begin(a, b, x, options, result);
+    if (b_norm == 0.0) {
+        return result;
+    }
+
+    residualInto(a, b, x, r_);
+    if (record(result, options, nrm2(r_) / b_norm)) {
+        return result;
+    }
+    r_hat_ = r_;
+    double rho = 1.0, alpha = 1.0, omega = 1.0;
+
+    while (result.iterations < options.max_iterations) {
+        double rho_next = dot(r_hat_, r_);
+        if (rho_next == 0.0) {
+            break;
+        }
+        if (result.iterations == 0) {
+            p_ = r_;
+        } else {
+            double beta = (rho_next / rho) * (alpha / omega);
+            for (size_t i = 0; i < p_.size(); ++i) {
+                p_[i] = r_[i] + beta * (p_[i] - omega * v_[i]);
+            }
+        }
+        rho = rho_next;
+
+        precondition(options.preconditioner, p_, p_hat_);
+        a.apply(p_hat_, v_);
+        double r_hat_v = dot(r_hat_, v_);
+        if (r_hat_v == 0.0) {
+            break;
+        }
+        alpha = rho / r_hat_v;
+        s_ = r_;
+        axpy(-alpha, v_, s_);
+        ++result.iterations;
+
+        // Half step: s is already small enough
+        double s_norm = nrm2(s_) / b_norm;
+        if (s_norm <= options.tolerance) {
+            axpy(alpha, p_hat_, x);
+            record(result, options, s_norm);
+            break;
+        }
+
+        precondition(options.preconditioner, s_, s_hat_);
+        a.apply(s_hat_, t_);
+        double tt = dot(t_, t_);
+        omega = tt > 0.0 ? dot(t_, s_) / tt : 0.0;
+        axpy(alpha, p_hat_, x);
+        axpy(omega, s_hat_, x);
+        r_ = s_;
+        axpy(-omega, t_, r_);
+        if (record(result, options, nrm2(r_) / b_norm) || omega == 0.0) {
+            break;
+        }
+    }
+    return result;
+}
+
+// ========== GMRES ==========
+
+SolverResult GMRESSolver::solve(const LinearOperator& a, const Vector& b, Vector& x,
+                                const SolverOptions& options) {
+    if (options.restart == 0) {
+        throw std::invalid_argument("GMRES restart length must be positive");
+    }
+    SolverResult result;
+    double b_norm = begin(a, b, x, options, result);
+    if (b_norm == 0.0) {
+        return result;
+    }
+
+    size_t n = b.size();
+    size_t m = std::min(options.restart, n);
+    if (basis_.rows() != m + 1 || basis_.cols() != n) {
+        basis_ = Matrix(m + 1, n);
+        hessenberg_ = Matrix(m + 1, m);
+    }
+    cosines_.resize(m);
+    sines_.resize(m);
+    g_.resize(m + 1);
+    h_.resize(m + 1);
+
+    bool first = true;
+    while (true) {
+        // True residual at every restart; the in-cycle values are estimates
+        residualInto(a, b, x, r_);
+        double beta = nrm2(r_);
+        if (first) {
+            first = false;
+            if (record(result, options, beta / b_norm)) {
+                return result;
+            }
+        } else {
+            result.residual = beta / b_norm;
+            result.converged = result.residual <= options.tolerance;
+            if (result.converged) {
+                return result;
+            }
+        }
+        if (result.iterations >= options.max_iterations) {
+            return result;
+        }
+
+        kernels::scale(n, 1.0 / beta, r_.data(), basis_.data());
+        std::fill(g_.begin(), g_.end(), 0.0);
+        g_[0] = beta;
+
+        size_t j = 0;
+        bool singular = false;
+        while (j < m && result.iterations < options.max_iterations) {
+            // w = A * M^-1 * v_j
+            std::copy(basis_.data() + j * n, basis_.data() + (j + 1) * n, r_.data());
+            if (options.preconditioner) {
+                options.preconditioner->apply(r_, z_);
+                a.apply(z_, w_);
+            } else {
+                a.apply(r_, w_);
+            }
+
+            // Classical Gram-Schmidt against v_0..v_j, twice
+            for (int pass = 0; pass < 2; ++pass) {
+                kernels::gemv(j + 1, n, 1.0, basis_.data(), n, w_.data(), 0.0, h_.data());
+                kernels::gemvTransposed(j + 1, n, -1.0, basis_.data(), n, h_.data(), 1.0,
+                                        w_.data());
+                for (size_t i = 0; i <= j; ++i) {
+                    hessenberg_(i, j) = pass == 0 ? h_[i] : hessenberg_(i, j) + h_[i];
+                }
+            }
+            double h_next = nrm2(w_);
+            hessenberg_(j + 1, j) = h_next;
+
+            // Rotate the new column by the previous rotations, then zero
+            // its subdiagonal entry with a new one
+            for (size_t i = 0; i < j; ++i) {
+                double upper = hessenberg_(i, j), lower = hessenberg_(i + 1, j);
+                hessenberg_(i, j) = cosines_[i] * upper + sines_[i] * lower;
+                hessenberg_(i + 1, j) = -sines_[i] * upper + cosines_[i] * lower;
+            }
+            double denominator = std::hypot(hessenberg_(j, j), h_next);
+            if (denominator == 0.0) {
+                singular = true;
+                break;
+            }
+            cosines_[j] = hessenberg_(j, j) / denominator;
+            sines_[j] = h_next / denominator;
+            hessenberg_(j, j) = denominator;
+            hessenberg_(j + 1, j) = 0.0;
+            g_[j + 1] = -sines_[j] * g_[j];
+            g_[j] = cosines_[j] * g_[j];
+
+            ++j;
+            ++result.iterations;
+            // A zero h_next means the subspace holds the exact solution
+            if (record(result, options, std::abs(g_[j]) / b_norm) || h_next == 0.0) {
+                break;
+            }
+            kernels::scale(n, 1.0 / h_next, w_.data(), basis_.data() + j * n);
+        }
+
+        // Back substitution for y in H * y = g, then x += M^-1 * V^T * y
+        for (size_t i = j; i-- > 0;) {
+            double sum = g_[i];
+            for (size_t k = i + 1; k < j; ++k) {
+                sum -= hessenberg_(i, k) * h_[k];
+            }
+            h_[i] = sum / hessenberg_(i, i);
+        }
+        if (j > 0) {
+            kernels::gemvTransposed(j, n, 1.0, basis_.data(), n, h_.data(), 0.0, r_.data());
+            if (options.preconditioner) {
+                options.preconditioner->apply(r_, z_);
+                axpy(1.0, z_, x);
+            } else {
+                axpy(1.0, r_, x);
+            }
+        }
+        if (singular) {
+            residualInto(a, b, x, r_);
+            result.residual = nrm2(r_) / b_norm;
+            result.converged = false;
+            return result;
+        }
+    }
+}
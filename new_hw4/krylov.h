@@ -0,0 +1,129 @@
+#ifndef KRYLOV_H
+#define KRYLOV_H
+
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include "matrix.h"
+#include "sparse_matrix.h"
+#include "vector.h"
+#include "preconditioner.h"
+
+// Krylov subspace solvers for A * x = b where A is only available through
+// products y = A * x: large sparse systems, or operators that are never
+// formed at all. Each solver owns its work vectors and keeps them between
+// solve() calls, so repeated solves of the same size allocate nothing.
+
+// ========== LINEAR OPERATOR ==========
+
+// Square operator x -> A * x. Wraps a dense Matrix (GEMV kernel), a
+// SparseMatrix (threaded SpMV) or any callback. The wrapped matrix is not
+// copied and must outlive the operator.
+class LinearOperator {
+public:
+    // apply(x, y) must set y = A * x. y already has size() elements and is
+    // never the same vector as x.
+    using Apply = std::function<void(const Vector& x, Vector& y)>;
+
+private:
+    size_t rows_;
+    size_t cols_;
+    Apply apply_;
+
+public:
+    LinearOperator(const Matrix& a);
+    LinearOperator(const SparseMatrix& a);
+    LinearOperator(size_t n, Apply apply);
+
+    // y = A * x, resizing y only if its size differs
+    void apply(const Vector& x, Vector& y) const;
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+};
+
+// ========== OPTIONS AND RESULTS ==========
+
+struct SolverOptions {
+    // Stop once ||b - A * x|| <= tolerance * ||b||
+    double tolerance = 1e-10;
+
+    size_t max_iterations = 1000;
+
+    // Krylov basis size of GMRES between restarts
+    size_t restart = 30;
+
+    // Optional M ~ A; not owned. CG applies it symmetrically and requires
+    // it to be SPD; BiCGSTAB and GMRES precondition from the right, so the
+    // residuals they report are those of the original system.
+    const Preconditioner* preconditioner = nullptr;
+
+    // Called with (iteration, relative residual) for the initial guess
+    // (iteration 0) and after every iteration
+    std::function<void(size_t, double)> monitor;
+};
+
+struct SolverResult {
+    bool converged = false;
+    size_t iterations = 0;
+
+    // Final relative residual ||b - A * x|| / ||b||. CG and BiCGSTAB track
+    // it by recurrence; GMRES recomputes it from x when it stops.
+    double residual = 0.0;
+
+    // Relative residual of the initial guess, then after each iteration
+    // (for GMRES, the estimate from its least-squares problem)
+    std::vector<double> residual_history;
+};
+
+// ========== SOLVERS ==========
+
+// All solvers: x holds the initial guess on entry (replaced by zeros if its
+// size does not match) and the approximate solution on return. They throw
+// std::logic_error for a non-square operator and std::invalid_argument if b
+// or the preconditioner has the wrong size. Not converging within
+// max_iterations, or a breakdown of the recurrence, is reported through
+// SolverResult::converged rather than thrown.
+
+// Preconditioned conjugate gradient, for symmetric positive definite A.
+// One operator product and one preconditioner application per iteration.
+class ConjugateGradientSolver {
+private:
+    Vector r_, z_, p_, q_;
+
+public:
+    SolverResult solve(const LinearOperator& a, const Vector& b, Vector& x,
+                       const SolverOptions& options = SolverOptions());
+};
+
+// BiCGSTAB (van der Vorst) for general nonsymmetric A, with right
+// preconditioning. Two operator products per iteration and short
+// recurrences, so memory does not grow with the iteration count.
+class BiCGSTABSolver {
+private:
+    Vector r_, r_hat_, p_, v_, s_, t_, p_hat_, s_hat_;
+
+public:
+    SolverResult solve(const LinearOperator& a, const Vector& b, Vector& x,
+                       const SolverOptions& options = SolverOptions());
+};
+
+// Restarted GMRES(m) with right preconditioning. The Arnoldi basis is kept
+// as the rows of an (m + 1) x n matrix and orthogonalized by classical
+// Gram-Schmidt applied twice, so each step is two GEMV pairs rather than
+// j dot products; the small Hessenberg least-squares problem is solved by
+// Givens rotations as it grows. The true residual is recomputed at every
+// restart.
+class GMRESSolver {
+private:
+    Matrix basis_;
+    Matrix hessenberg_;
+    std::vector<double> cosines_, sines_, g_, h_;
+    Vector r_, w_, z_;
+
+public:
+    SolverResult solve(const LinearOperator& a, const Vector& b, Vector& x,
+                       const SolverOptions& options = SolverOptions());
+};
+
+#endif // KRYLOV_H
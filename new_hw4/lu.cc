@@ -0,0 +1,186 @@
+#include "lu.h"
+#include "gemm.h"
+#include "triangular.h"
+#include "elementwise.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+// ========== FACTORIZATION ==========
+
+LUDecomposition::LUDecomposition(Matrix a)
+    : lu_(std::move(a)), permutation_sign_(1), singular_(false) {
+    if (lu_.rows() != lu_.cols()) {
+        throw std::logic_error("LU decomposition requires square matrix");
+    }
+    factor();
+}
+
+void LUDecomposition::factor() {
+    size_t n = lu_.rows();
+    double* a = lu_.data();
+    pivots_.resize(n);
+
+    // Pivots this small relative to the matrix are rounding noise: the
+    // matrix is singular to working precision
+    double lo = 0.0, hi = 0.0;
+    kernels::minMax(n * n, a, &lo, &hi);
+    double tolerance = static_cast<double>(n) * std::numeric_limits<double>::epsilon() *
+                       std::max(std::abs(lo), std::abs(hi));
+
+    for (size_t k0 = 0; k0 < n; k0 += LU_BLOCK) {
+        size_t k1 = std::min(k0 + LU_BLOCK, n);
+
+        // Factor the panel of columns k0..k1 with partial pivoting. Pivot
+        // swaps exchange whole rows, which also applies them to the
+        // already-computed L and to the trailing columns.
+        for (size_t j = k0; j < k1; ++j) {
+            size_t pivot_row = j;
+            double pivot_abs = std::abs(a[j * n + j]);
+            for (size_t i = j + 1; i < n; ++i) {
+                double candidate = std::abs(a[i * n + j]);
+                if (candidate > pivot_abs) {
+                    pivot_abs = candidate;
+                    pivot_row = i;
+                }
+            }
+            pivots_[j] = pivot_row;
+            if (pivot_row != j) {
+                std::swap_ranges(a + j * n, a + (j + 1) * n, a + pivot_row * n);
+                permutation_sign_ = -permutation_sign_;
+            }
+
+            double pivot = a[j * n + j];
+            if (std::abs(pivot) <= tolerance) {
+                singular_ = true;
+            }
+            if (pivot == 0.0) {
+                // Column is already zero below the diagonal; keep going so
+                // the remaining factors stay defined
+                continue;
+            }
+            for (size_t i = j + 1; i < n; ++i) {
+                double l_ij = a[i * n + j] / pivot;
+                a[i * n + j] = l_ij;
+                for (size_t c = j + 1; c < k1; ++c) {
+                    a[i * n + c] -= l_ij * a[j * n + c];
+                }
+            }
+        }
+
+        if (k1 < n) {
+            size_t kb = k1 - k0;
+            size_t rest = n - k1;
+
+            // U12 = L11^-1 * A12
+            kernels::solveLower(lu_.block(k0, k0, kb, kb), lu_.block(k0, k1, kb, rest), true);
+
+            // A22 -= L21 * U12: the bulk of the flops, done by the GEMM kernel
+            kernels::gemm(rest, rest, kb, -1.0,
+                          a + k1 * n + k0, n, 1,
+                          a + k0 * n + k1, n, 1,
+                          a + k1 * n + k1, n);
+        }
+    }
+}
+
+void LUDecomposition::requireNonSingular() const {
+    if (singular_) {
+        throw std::runtime_error("Matrix is singular");
+    }
+}
+
+// ========== SOLVES ==========
+
+void LUDecomposition::solveInPlace(Matrix& b) const {
+    if (b.rows() != lu_.rows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for solve");
+    }
+    requireNonSingular();
+
+    // Apply P to B, then forward and back substitution
+    double* rows = b.data();
+    size_t k = b.cols();
+    for (size_t i = 0; i < pivots_.size(); ++i) {
+        if (pivots_[i] != i) {
+            std::swap_ranges(rows + i * k, rows + (i + 1) * k, rows + pivots_[i] * k);
+        }
+    }
+    kernels::solveLower(lu_, b, true);
+    kernels::solveUpper(lu_, b, false);
+}
+
+Matrix LUDecomposition::solve(const Matrix& b) const {
+    Matrix x(b);
+    solveInPlace(x);
+    return x;
+}
+
+std::vector<double> LUDecomposition::solve(const std::vector<double>& b) const {
+    Matrix x(b.size(), 1);
+    std::copy(b.begin(), b.end(), x.data());
+    solveInPlace(x);
+    return std::vector<double>(x.data(), x.data() + x.rows());
+}
+
+Matrix LUDecomposition::inverse() const {
+    Matrix x = Matrix::identity(lu_.rows());
+    solveInPlace(x);
+    return x;
+}
+
+double LUDecomposition::determinant() const {
+    if (singular_) {
+        return 0.0;
+    }
+    double det = permutation_sign_;
+    for (size_t i = 0; i < lu_.rows(); ++i) {
+        det *= lu_(i, i);
+    }
+    return det;
+}
+
+// ========== FACTORS ==========
+
+size_t LUDecomposition::size() const {
+    return lu_.rows();
+}
+
+bool LUDecomposition::isSingular() const {
+    return singular_;
+}
+
+Matrix LUDecomposition::lower() const {
+    size_t n = lu_.rows();
+    Matrix l = Matrix::identity(n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            l(i, j) = lu_(i, j);
+        }
+    }
+    return l;
+}
+
+Matrix LUDecomposition::upper() const {
+    size_t n = lu_.rows();
+    Matrix u(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i; j < n; ++j) {
+            u(i, j) = lu_(i, j);
+        }
+    }
+    return u;
+}
+
+Matrix LUDecomposition::permutation() const {
+    size_t n = lu_.rows();
+    Matrix p = Matrix::identity(n);
+    double* rows = p.data();
+    for (size_t i = 0; i < n; ++i) {
+        if (pivots_[i] != i) {
+            std::swap_ranges(rows + i * n, rows + (i + 1) * n, rows + pivots_[i] * n);
+        }
+    }
+    return p;
+}
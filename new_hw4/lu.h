@@ -0,0 +1,75 @@
+#ifndef LU_H
+#define LU_H
+
+#include <vector>
+#include <cstddef>
+#include "matrix.h"
+
+// LU decomposition with partial pivoting: P * A = L * U.
+//
+// The factorization is computed once and can then be reused for any
+// number of solves. It is blocked and right-looking: each panel of
+// LU_BLOCK columns is factored, and the trailing matrix is updated with
+// one call to the GEMM kernel, so most of the work runs at GEMM speed.
+class LUDecomposition {
+private:
+    // L (strictly below the diagonal, unit diagonal implied) and U
+    // (on and above the diagonal) packed into one matrix
+    Matrix lu_;
+    
+    // Row i was swapped with row pivots_[i] at step i
+    std::vector<size_t> pivots_;
+    
+    // +1 or -1: the sign of the row permutation
+    int permutation_sign_;
+    
+    // True if a pivot was at most n * eps * max |A| (A is singular to
+    // working precision)
+    bool singular_;
+    
+    void factor();
+    
+    // Throw std::runtime_error if the matrix is singular
+    void requireNonSingular() const;
+
+public:
+    // Panel width of the blocked factorization
+    static constexpr size_t LU_BLOCK = 64;
+    
+    // Factor a square matrix (std::logic_error otherwise). Pass an rvalue
+    // to factor in place without copying.
+    explicit LUDecomposition(Matrix a);
+    
+    // ========== SOLVES ==========
+    
+    // Solve A * X = B for X; B may have any number of columns
+    Matrix solve(const Matrix& b) const;
+    
+    // Solve A * x = b for a single right-hand side
+    std::vector<double> solve(const std::vector<double>& b) const;
+    
+    // Overwrite B with the solution of A * X = B
+    void solveInPlace(Matrix& b) const;
+    
+    // A^-1
+    Matrix inverse() const;
+    
+    // det(A); zero for singular matrices
+    double determinant() const;
+    
+    // ========== FACTORS ==========
+    
+    size_t size() const;
+    bool isSingular() const;
+    
+    // Unit lower-triangular factor L
+    Matrix lower() const;
+    
+    // Upper-triangular factor U
+    Matrix upper() const;
+    
+    // Permutation matrix P such that P * A = L * U
+    Matrix permutation() const;
+};
+
+#endif // LU_H
@@ -1,8 +1,12 @@
 #include "matrix.h"
+#include "gemm.h"
+#include "transpose.h"
+#include "strassen.h"
+#include "lu.h"
+#include "reduce.h"
 #include <cmath>
-#include <iomanip>
-#include <sstream>
 #include <algorithm>
+#include <limits>
 
 // ========== PRIVATE HELPER METHODS ==========
 
@@ -14,21 +18,28 @@ bool Matrix::almostEqual(double a, double b) const {
     return std::abs(a - b) < EPSILON;
 }
 
+double Matrix::reciprocal(double scalar) {
+    if (std::abs(scalar) < EPSILON) {
+        throw std::invalid_argument("Division by zero");
+    }
+    return 1.0 / scalar;
+}
+
 // ========== CONSTRUCTORS ==========
 
 // Default constructor: creates empty 0x0 matrix
-Matrix::Matrix() : num_rows_(0), num_cols_(0) {}
+Matrix::BasicMatrix() : num_rows_(0), num_cols_(0) {}
 
 // Create matrix of given size (zero-initialized)
-Matrix::Matrix(size_t rows, size_t cols) 
+Matrix::BasicMatrix(size_t rows, size_t cols) 
     : data_(rows * cols, 0.0), num_rows_(rows), num_cols_(cols) {}
 
 // Create matrix filled with specific value
-Matrix::Matrix(size_t rows, size_t cols, double value)
+Matrix::BasicMatrix(size_t rows, size_t cols, double value)
     : data_(rows * cols, value), num_rows_(rows), num_cols_(cols) {}
 
 // Create from initializer list
-Matrix::Matrix(std::initializer_list<std::initializer_list<double>> list) {
+Matrix::BasicMatrix(std::initializer_list<std::initializer_list<double>> list) {
     num_rows_ = list.size();
     if (num_rows_ == 0) {
         num_cols_ = 0;
@@ -49,9 +60,17 @@ Matrix::Matrix(std::initializer_list<std::initializer_list<double>> list) {
 }
 
 // Copy constructor
-Matrix::Matrix(const Matrix& other)
+Matrix::BasicMatrix(const Matrix& other)
     : data_(other.data_), num_rows_(other.num_rows_), num_cols_(other.num_cols_) {}
 
+// Move constructor
+Matrix::BasicMatrix(Matrix&& other) noexcept
+    : data_(std::move(other.data_)), num_rows_(other.num_rows_), num_cols_(other.num_cols_) {
+    other.data_.clear();
+    other.num_rows_ = 0;
+    other.num_cols_ = 0;
+}
+
 // ========== ASSIGNMENT OPERATORS ==========
 
 // Copy assignment
@@ -64,6 +83,19 @@ Matrix& Matrix::operator=(const Matrix& other) {
     return *this;
 }
 
+// Move assignment
+Matrix& Matrix::operator=(Matrix&& other) noexcept {
+    if (this != &other) {
+        data_ = std::move(other.data_);
+        num_rows_ = other.num_rows_;
+        num_cols_ = other.num_cols_;
+        other.data_.clear();
+        other.num_rows_ = 0;
+        other.num_cols_ = 0;
+    }
+    return *this;
+}
+
 // ========== ELEMENT ACCESS ==========
 
 double& Matrix::operator()(size_t row, size_t col) {
@@ -88,6 +120,49 @@ const double& Matrix::at(size_t row, size_t col) const {
     return data_[getIndex(row, col)];
 }
 
+double* Matrix::data() {
+    return data_.data();
+}
+
+const double* Matrix::data() const {
+    return data_.data();
+}
+
+// ========== VIEWS ==========
+
+MatrixView Matrix::block(size_t row, size_t col, size_t rows, size_t cols) {
+    return MatrixView(*this).block(row, col, rows, cols);
+}
+
+ConstMatrixView Matrix::block(size_t row, size_t col, size_t rows, size_t cols) const {
+    return ConstMatrixView(*this).block(row, col, rows, cols);
+}
+
+MatrixView Matrix::row(size_t i) {
+    return block(i, 0, 1, num_cols_);
+}
+
+ConstMatrixView Matrix::row(size_t i) const {
+    return block(i, 0, 1, num_cols_);
+}
+
+MatrixView Matrix::col(size_t j) {
+    return block(0, j, num_rows_, 1);
+}
+
+ConstMatrixView Matrix::col(size_t j) const {
+    return block(0, j, num_rows_, 1);
+}
+
+MatrixView Matrix::diagonal_view() {
+    // Consecutive diagonal elements are cols + 1 apart in row-major storage
+    return MatrixView(data_.data(), std::min(num_rows_, num_cols_), 1, num_cols_ + 1);
+}
+
+ConstMatrixView Matrix::diagonal_view() const {
+    return ConstMatrixView(data_.data(), std::min(num_rows_, num_cols_), 1, num_cols_ + 1);
+}
+
 // ========== SIZE AND PROPERTIES ==========
 
 size_t Matrix::rows() const {
@@ -108,80 +183,62 @@ bool Matrix::isSquare() const {
 
 // ========== ARITHMETIC OPERATORS ==========
 
-// Matrix addition
-Matrix Matrix::operator+(const Matrix& other) const {
-    if (num_rows_ != other.num_rows_ || num_cols_ != other.num_cols_) {
-        throw std::invalid_argument("Matrix dimensions must match for addition");
-    }
-    
-    Matrix result(num_rows_, num_cols_);
-    for (size_t i = 0; i < data_.size(); ++i) {
-        result.data_[i] = data_[i] + other.data_[i];
-    }
-    return result;
-}
-
-// Matrix subtraction
-Matrix Matrix::operator-(const Matrix& other) const {
-    if (num_rows_ != other.num_rows_ || num_cols_ != other.num_cols_) {
-        throw std::invalid_argument("Matrix dimensions must match for subtraction");
-    }
-    
-    Matrix result(num_rows_, num_cols_);
-    for (size_t i = 0; i < data_.size(); ++i) {
-        result.data_[i] = data_[i] - other.data_[i];
-    }
-    return result;
-}
-
 // Matrix multiplication
 Matrix Matrix::operator*(const Matrix& other) const {
     if (num_cols_ != other.num_rows_) {
         throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
     }
     
-    Matrix result(num_rows_, other.num_cols_);
-    for (size_t i = 0; i < num_rows_; ++i) {
-        for (size_t j = 0; j < other.num_cols_; ++j) {
-            double sum = 0.0;
-            for (size_t k = 0; k < num_cols_; ++k) {
-                sum += (*this)(i, k) * other(k, j);
-            }
-            result(i, j) = sum;
-        }
+    // kernels::gemm picks the scalar loop for small shapes and the
+    // packed, cache-blocked engine for large ones; very large products
+    // take the Strassen-Winograd path if it has been enabled
+    if (kernels::useStrassen(num_rows_, other.num_cols_, num_cols_)) {
+        Matrix result;
+        result.reshape(num_rows_, other.num_cols_);
+        kernels::strassen(num_rows_, other.num_cols_, num_cols_,
+                          data_.data(), num_cols_,
+                          other.data_.data(), other.num_cols_,
+                          result.data_.data(), result.num_cols_);
+        return result;
     }
+    Matrix result(num_rows_, other.num_cols_);
+    kernels::gemm(num_rows_, other.num_cols_, num_cols_, 1.0,
+                  data_.data(), num_cols_, 1,
+                  other.data_.data(), other.num_cols_, 1,
+                  result.data_.data(), result.num_cols_);
     return result;
 }
 
-// Scalar multiplication (matrix * scalar)
-Matrix Matrix::operator*(double scalar) const {
-    Matrix result(num_rows_, num_cols_);
-    for (size_t i = 0; i < data_.size(); ++i) {
-        result.data_[i] = data_[i] * scalar;
-    }
-    return result;
+// Operators on expiring matrices (result written into the operand's buffer)
+Matrix operator+(Matrix&& lhs, Matrix&& rhs) {
+    lhs += rhs;
+    return std::move(lhs);
 }
 
-// Scalar multiplication (scalar * matrix)
-Matrix operator*(double scalar, const Matrix& m) {
-    return m * scalar;
+Matrix operator-(Matrix&& lhs, Matrix&& rhs) {
+    lhs -= rhs;
+    return std::move(lhs);
 }
 
-// Scalar division
-Matrix Matrix::operator/(double scalar) const {
-    if (std::abs(scalar) < EPSILON) {
-        throw std::invalid_argument("Division by zero");
-    }
-    return (*this) * (1.0 / scalar);
+Matrix operator*(Matrix&& m, double scalar) {
+    m *= scalar;
+    return std::move(m);
 }
 
-// Unary negation
-Matrix Matrix::operator-() const {
-    Matrix result(num_rows_, num_cols_);
-    for (size_t i = 0; i < data_.size(); ++i) {
-        result.data_[i] = -data_[i];
-    }
-    return result;
+Matrix operator*(double scalar, Matrix&& m) {
+    m *= scalar;
+    return std::move(m);
+}
+
+Matrix operator/(Matrix&& m, double scalar) {
+    m /= scalar;
+    return std::move(m);
+}
+
+Matrix operator-(Matrix&& m) {
+    // Multiplying by -1 is exact, so this matches element-wise negation
+    m *= -1.0;
+    return std::move(m);
 }
 
 // ========== COMPOUND ASSIGNMENT OPERATORS ==========
@@ -191,9 +248,7 @@ Matrix& Matrix::operator+=(const Matrix& other) {
         throw std::invalid_argument("Matrix dimensions must match for addition");
     }
     
-    for (size_t i = 0; i < data_.size(); ++i) {
-        data_[i] += other.data_[i];
-    }
+    kernels::add(data_.size(), data_.data(), other.data_.data(), data_.data());
     return *this;
 }
 
@@ -202,29 +257,23 @@ Matrix& Matrix::operator-=(const Matrix& other) {
         throw std::invalid_argument("Matrix dimensions must match for subtraction");
     }
     
-    for (size_t i = 0; i < data_.size(); ++i) {
-        data_[i] -= other.data_[i];
-    }
+    kernels::subtract(data_.size(), data_.data(), other.data_.data(), data_.data());
     return *this;
 }
 
 Matrix& Matrix::operator*=(const Matrix& other) {
+    // The product needs its own buffer; moving it in avoids a copy back
     *this = (*this) * other;
     return *this;
 }
 
 Matrix& Matrix::operator*=(double scalar) {
-    for (size_t i = 0; i < data_.size(); ++i) {
-        data_[i] *= scalar;
-    }
+    kernels::scale(data_.size(), scalar, data_.data(), data_.data());
     return *this;
 }
 
 Matrix& Matrix::operator/=(double scalar) {
-    if (std::abs(scalar) < EPSILON) {
-        throw std::invalid_argument("Division by zero");
-    }
-    *this *= (1.0 / scalar);
+    *this *= reciprocal(scalar);
     return *this;
 }
 
@@ -251,26 +300,26 @@ bool Matrix::operator!=(const Matrix& other) const {
 
 // Transpose
 Matrix Matrix::transpose() const {
-    Matrix result(num_cols_, num_rows_);
-    for (size_t i = 0; i < num_rows_; ++i) {
-        for (size_t j = 0; j < num_cols_; ++j) {
-            result(j, i) = (*this)(i, j);
-        }
-    }
+    Matrix result;
+    transpose_into(*this, result);
     return result;
 }
 
+// In-place transpose: tiled swaps for square matrices, cycle-following
+// for rectangular ones
+void Matrix::transposeInPlace() {
+    kernels::transposeInPlace(num_rows_, num_cols_, data_.data());
+    std::swap(num_rows_, num_cols_);
+}
+
 // Trace
 double Matrix::trace() const {
     if (!isSquare()) {
         throw std::logic_error("Trace requires square matrix");
     }
     
-    double sum = 0.0;
-    for (size_t i = 0; i < num_rows_; ++i) {
-        sum += (*this)(i, i);
-    }
-    return sum;
+    // The diagonal is read in place with stride cols + 1
+    return kernels::reduceSum(num_rows_, data_.data(), num_cols_ + 1);
 }
 
 // Extract diagonal
@@ -285,16 +334,227 @@ Matrix Matrix::diagonal() const {
 
 // Fill matrix with value
 void Matrix::fill(double value) {
-    std::fill(data_.begin(), data_.end(), value);
+    kernels::fill(data_.size(), value, data_.data());
 }
 
 // Frobenius norm
 double Matrix::norm() const {
-    double sum = 0.0;
-    for (double val : data_) {
-        sum += val * val;
+    return kernels::reduceNorm(data_.size(), data_.data());
+}
+
+// ========== REDUCTIONS ==========
+
+double Matrix::sum() const {
+    return kernels::reduceSum(data_.size(), data_.data());
+}
+
+double Matrix::min() const {
+    if (data_.empty()) {
+        throw std::logic_error("Minimum of an empty matrix");
+    }
+    return kernels::reduceMin(data_.size(), data_.data());
+}
+
+double Matrix::max() const {
+    if (data_.empty()) {
+        throw std::logic_error("Maximum of an empty matrix");
+    }
+    return kernels::reduceMax(data_.size(), data_.data());
+}
+
+Matrix Matrix::rowSums() const {
+    Matrix result(num_rows_, 1);
+    kernels::rowSums(num_rows_, num_cols_, data_.data(), num_cols_, result.data());
+    return result;
+}
+
+Matrix Matrix::columnSums() const {
+    Matrix result(1, num_cols_);
+    kernels::columnSums(num_rows_, num_cols_, data_.data(), num_cols_, result.data());
+    return result;
+}
+
+// ========== LINEAR SYSTEMS ==========
+
+Matrix Matrix::solve(const Matrix& b) const {
+    return LUDecomposition(*this).solve(b);
+}
+
+Matrix Matrix::inverse() const {
+    return LUDecomposition(*this).inverse();
+}
+
+double Matrix::determinant() const {
+    return LUDecomposition(*this).determinant();
+}
+
+// ========== MATRIX FUNCTIONS ==========
+
+namespace {
+
+// Coefficients b_0, ..., b_m of the degree-m diagonal Pade approximant
+// to e^x: numerator sum b_k x^k, denominator sum b_k (-x)^k
+constexpr double PADE3[] = {120.0, 60.0, 12.0, 1.0};
+constexpr double PADE5[] = {30240.0, 15120.0, 3360.0, 420.0, 30.0, 1.0};
+constexpr double PADE7[] = {17297280.0, 8648640.0, 1995840.0, 277200.0, 25200.0,
+                            1512.0, 56.0, 1.0};
+constexpr double PADE9[] = {17643225600.0, 8821612800.0, 2075673600.0, 302702400.0,
+                            30270240.0, 2162160.0, 110880.0, 3960.0, 90.0, 1.0};
+constexpr double PADE13[] = {64764752532480000.0, 32382376266240000.0, 7771770303897600.0,
+                             1187353796428800.0, 129060195264000.0, 10559470521600.0,
+                             670442572800.0, 33522128640.0, 1323241920.0, 40840800.0,
+                             960960.0, 16380.0, 182.0, 1.0};
+
+// Largest 1-norm for which each degree is accurate to double precision
+// (Higham 2005, Table 2.3)
+constexpr double THETA3 = 1.495585217958292e-2;
+constexpr double THETA5 = 2.539398330063230e-1;
+constexpr double THETA7 = 9.504178996162932e-1;
+constexpr double THETA9 = 2.097847961257068e0;
+constexpr double THETA13 = 5.371920351148152e0;
+
+// Largest absolute column sum
+double norm1(const Matrix& a) {
+    std::vector<double> sums(a.cols(), 0.0);
+    for (size_t i = 0; i < a.rows(); ++i) {
+        const double* row = a.data() + i * a.cols();
+        for (size_t j = 0; j < a.cols(); ++j) {
+            sums[j] += std::abs(row[j]);
+        }
+    }
+    return sums.empty() ? 0.0 : *std::max_element(sums.begin(), sums.end());
+}
+
+void addToDiagonal(Matrix& a, double value) {
+    for (size_t i = 0; i < a.rows(); ++i) {
+        a(i, i) += value;
+    }
+}
+
+// The approximant is (V - U)^-1 (V + U), with U the odd-power terms and
+// V the even-power terms. Degrees up to 9 build each even power of a.
+void padeTerms(const Matrix& a, const double* b, size_t degree, Matrix& u, Matrix& v) {
+    Matrix a2 = a * a;
+    Matrix power = a2;  // a^(2k)
+    Matrix scratch;
+    Matrix odd = Matrix::identity(a.rows()) * b[1];
+    v = Matrix::identity(a.rows()) * b[0];
+    for (size_t k = 1; 2 * k < degree; ++k) {
+        if (k > 1) {
+            multiply_into(power, a2, scratch);
+            std::swap(power, scratch);
+        }
+        odd += b[2 * k + 1] * power;
+        v += b[2 * k] * power;
+    }
+    u = a * odd;
+}
+
+// Degree 13 needs only a^2, a^4 and a^6: the high terms are factored
+// through a^6 (six products in all)
+void padeTerms13(const Matrix& a, Matrix& u, Matrix& v) {
+    const double* b = PADE13;
+    Matrix a2 = a * a;
+    Matrix a4 = a2 * a2;
+    Matrix a6 = a4 * a2;
+    
+    Matrix high = b[13] * a6 + b[11] * a4 + b[9] * a2;
+    Matrix odd = a6 * high;
+    odd += b[7] * a6 + b[5] * a4 + b[3] * a2;
+    addToDiagonal(odd, b[1]);
+    u = a * odd;
+    
+    high = b[12] * a6 + b[10] * a4 + b[8] * a2;
+    v = a6 * high;
+    v += b[6] * a6 + b[4] * a4 + b[2] * a2;
+    addToDiagonal(v, b[0]);
+}
+
+} // namespace
+
+// Binary exponentiation, as power() in new_hw1. The result starts at the
+// lowest set bit's power rather than at the identity, and the squarings
+// ping-pong between two buffers through multiply_into, so only the first
+// product of each buffer allocates.
+Matrix Matrix::pow(int n) const {
+    if (!isSquare()) {
+        throw std::logic_error("Matrix power requires square matrix");
+    }
+    if (n == 0) {
+        return identity(num_rows_);
     }
-    return std::sqrt(sum);
+    
+    // Negative powers are powers of the inverse (-n computed unsigned so
+    // INT_MIN does not overflow)
+    Matrix base = n < 0 ? inverse() : *this;
+    unsigned int e = n < 0 ? 0u - static_cast<unsigned int>(n) : static_cast<unsigned int>(n);
+    Matrix scratch;
+    while ((e & 1u) == 0) {
+        multiply_into(base, base, scratch);
+        std::swap(base, scratch);
+        e >>= 1;
+    }
+    
+    Matrix result = base;
+    e >>= 1;
+    while (e != 0) {
+        multiply_into(base, base, scratch);
+        std::swap(base, scratch);
+        if (e & 1u) {
+            multiply_into(result, base, scratch);
+            std::swap(result, scratch);
+        }
+        e >>= 1;
+    }
+    return result;
+}
+
+// Scaling and squaring: pick the cheapest Pade degree that is accurate
+// for this 1-norm; beyond degree 13's range, divide by 2^s first and
+// square the approximant s times
+Matrix Matrix::expm() const {
+    if (!isSquare()) {
+        throw std::logic_error("Matrix exponential requires square matrix");
+    }
+    if (isEmpty()) {
+        return Matrix();
+    }
+    
+    double a_norm = norm1(*this);
+    if (!std::isfinite(a_norm)) {
+        return Matrix(num_rows_, num_cols_, std::numeric_limits<double>::quiet_NaN());
+    }
+    
+    Matrix u, v;
+    int squarings = 0;
+    if (a_norm <= THETA3) {
+        padeTerms(*this, PADE3, 3, u, v);
+    } else if (a_norm <= THETA5) {
+        padeTerms(*this, PADE5, 5, u, v);
+    } else if (a_norm <= THETA7) {
+        padeTerms(*this, PADE7, 7, u, v);
+    } else if (a_norm <= THETA9) {
+        padeTerms(*this, PADE9, 9, u, v);
+    } else {
+        Matrix scaled = *this;
+        if (a_norm > THETA13) {
+            // Dividing by a power of two is exact
+            squarings = static_cast<int>(std::ceil(std::log2(a_norm / THETA13)));
+            scaled *= std::ldexp(1.0, -squarings);
+        }
+        padeTerms13(scaled, u, v);
+    }
+    
+    Matrix numerator = v + u;
+    Matrix denominator = v - u;
+    Matrix result = LUDecomposition(denominator).solve(numerator);
+    
+    Matrix scratch;
+    for (int i = 0; i < squarings; ++i) {
+        multiply_into(result, result, scratch);
+        std::swap(result, scratch);
+    }
+    return result;
 }
 
 // ========== STATIC FACTORY METHODS ==========
@@ -324,29 +584,196 @@ Matrix Matrix::diagonal(const std::vector<double>& diag) {
     return result;
 }
 
-// ========== STREAM OPERATORS ==========
+// ========== ALLOCATION-FREE KERNELS ==========
 
-std::ostream& operator<<(std::ostream& os, const Matrix& m) {
-    os << "[";
-    for (size_t i = 0; i < m.num_rows_; ++i) {
-        if (i > 0) os << " ";
-        os << "[";
-        for (size_t j = 0; j < m.num_cols_; ++j) {
-            os << m(i, j);
-            if (j < m.num_cols_ - 1) os << ", ";
+void Matrix::reshape(size_t rows, size_t cols) {
+    data_.resize(rows * cols);
+    num_rows_ = rows;
+    num_cols_ = cols;
+}
+
+void add_into(ConstMatrixView a, ConstMatrixView b, Matrix& out) {
+    if (a.rows() != b.rows() || a.cols() != b.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for addition");
+    }
+    
+    // Expression assignment evaluates in place when out already has the
+    // right shape and does not overlap a or b through another layout
+    out = a + b;
+}
+
+void subtract_into(ConstMatrixView a, ConstMatrixView b, Matrix& out) {
+    if (a.rows() != b.rows() || a.cols() != b.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for subtraction");
+    }
+    
+    out = a - b;
+}
+
+void multiply_into(ConstMatrixView a, ConstMatrixView b, Matrix& out) {
+    if (a.cols() != b.rows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    MatrixSpan out_span{out.data_.data(), out.num_rows_, out.num_cols_, out.num_cols_, 1};
+    if (out_span.overlaps(a.span()) || out_span.overlaps(b.span())) {
+        throw std::invalid_argument("Output of multiply_into must not alias an input");
+    }
+    
+    out.reshape(a.rows(), b.cols());
+    multiply_into(a, b, MatrixView(out));
+}
+
+void multiply_into(ConstMatrixView a, ConstMatrixView b, MatrixView out) {
+    if (a.cols() != b.rows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    if (out.rows() != a.rows() || out.cols() != b.cols()) {
+        throw std::invalid_argument("Output block has the wrong shape for multiplication");
+    }
+    if (out.span().overlaps(a.span()) || out.span().overlaps(b.span())) {
+        throw std::invalid_argument("Output of multiply_into must not alias an input");
+    }
+    
+    bool unit_strides = a.colStride() == 1 && b.colStride() == 1 && out.colStride() == 1;
+    if (unit_strides && kernels::useStrassen(a.rows(), b.cols(), a.cols())) {
+        kernels::strassen(a.rows(), b.cols(), a.cols(),
+                          a.data(), a.rowStride(), b.data(), b.rowStride(),
+                          out.data(), out.rowStride());
+        return;
+    }
+    
+    out.fill(0.0);
+    if (out.colStride() == 1) {
+        kernels::gemm(a.rows(), b.cols(), a.cols(), 1.0,
+                      a.data(), a.rowStride(), a.colStride(),
+                      b.data(), b.rowStride(), b.colStride(),
+                      out.data(), out.rowStride());
+    } else {
+        // The kernel writes rows of C contiguously; go through a temporary
+        Matrix product;
+        multiply_into(a, b, product);
+        out = product;
+    }
+}
+
+void transpose_into(ConstMatrixView a, Matrix& out) {
+    MatrixSpan out_span{out.data_.data(), out.num_rows_, out.num_cols_, out.num_cols_, 1};
+    if (out_span.overlaps(a.span())) {
+        throw std::invalid_argument("Output of transpose_into must not alias its input");
+    }
+    
+    out.reshape(a.cols(), a.rows());
+    if (a.colStride() == 1) {
+        kernels::transpose(a.rows(), a.cols(), a.data(), a.rowStride(),
+                           out.data_.data(), out.num_cols_);
+    } else {
+        for (size_t i = 0; i < a.rows(); ++i) {
+            for (size_t j = 0; j < a.cols(); ++j) {
+                out(j, i) = a(i, j);
+            }
         }
-        os << "]";
-        if (i < m.num_rows_ - 1) os << "\n";
     }
-    os << "]";
-    return os;
 }
 
-std::istream& operator>>(std::istream& is, Matrix& m) {
-    for (size_t i = 0; i < m.num_rows_; ++i) {
-        for (size_t j = 0; j < m.num_cols_; ++j) {
-            is >> m(i, j);
+// ========== BLAS-STYLE UPDATES ==========
+
+namespace {
+
+// op(X) = X^T as a view with swapped strides
+ConstMatrixView transposedView(ConstMatrixView x) {
+    return ConstMatrixView(x.data(), x.cols(), x.rows(), x.colStride(), x.rowStride());
+}
+
+// Zero every element of x without reading it (beta == 0)
+void zeroView(MatrixView x) {
+    if (x.colStride() != 1) {
+        x.fill(0.0);
+        return;
+    }
+    for (size_t i = 0; i < x.rows(); ++i) {
+        kernels::fill(x.cols(), 0.0, x.data() + i * x.rowStride());
+    }
+}
+
+} // namespace
+
+void gemm(double alpha, ConstMatrixView a, bool trans_a,
+          ConstMatrixView b, bool trans_b, double beta, MatrixView c) {
+    ConstMatrixView op_a = trans_a ? transposedView(a) : a;
+    ConstMatrixView op_b = trans_b ? transposedView(b) : b;
+    if (op_a.cols() != op_b.rows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    if (c.rows() != op_a.rows() || c.cols() != op_b.cols()) {
+        throw std::invalid_argument("Output block has the wrong shape for multiplication");
+    }
+    if (c.span().overlaps(a.span()) || c.span().overlaps(b.span())) {
+        throw std::invalid_argument("Output of gemm must not alias an input");
+    }
+    if (c.isEmpty()) {
+        return;
+    }
+    
+    if (beta == 0.0) {
+        zeroView(c);
+    } else if (beta != 1.0) {
+        scal(beta, c);
+    }
+    if (alpha == 0.0 || op_a.cols() == 0) {
+        return;
+    }
+    
+    // The kernel accumulates into C, so beta * C is already in place
+    size_t m = c.rows(), n = c.cols(), k = op_a.cols();
+    if (c.colStride() == 1) {
+        kernels::gemm(m, n, k, alpha,
+                      op_a.data(), op_a.rowStride(), op_a.colStride(),
+                      op_b.data(), op_b.rowStride(), op_b.colStride(),
+                      c.data(), c.rowStride());
+    } else if (c.rowStride() == 1) {
+        // A column-major C is a row-major C^T = op(B)^T * op(A)^T
+        kernels::gemm(n, m, k, alpha,
+                      op_b.data(), op_b.colStride(), op_b.rowStride(),
+                      op_a.data(), op_a.colStride(), op_a.rowStride(),
+                      c.data(), c.colStride());
+    } else {
+        Matrix product;
+        multiply_into(op_a, op_b, product);
+        axpy(alpha, product, c);
+    }
+}
+
+void axpy(double alpha, ConstMatrixView x, MatrixView y) {
+    if (x.rows() != y.rows() || x.cols() != y.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for axpy");
+    }
+    if (x.aliases(y.span())) {
+        // x reads elements of y through another layout; update from a copy
+        axpy(alpha, Matrix(x), y);
+        return;
+    }
+    
+    if (x.colStride() == 1 && y.colStride() == 1) {
+        for (size_t i = 0; i < y.rows(); ++i) {
+            kernels::axpy(y.cols(), alpha, x.data() + i * x.rowStride(),
+                          y.data() + i * y.rowStride());
+        }
+    } else {
+        for (size_t i = 0; i < y.rows(); ++i) {
+            for (size_t j = 0; j < y.cols(); ++j) {
+                y(i, j) += alpha * x(i, j);
+            }
         }
     }
-    return is;
-}
\ No newline at end of file
+}
+
+void scal(double alpha, MatrixView x) {
+    if (x.colStride() != 1) {
+        x *= alpha;
+        return;
+    }
+    for (size_t i = 0; i < x.rows(); ++i) {
+        double* row = x.data() + i * x.rowStride();
+        kernels::scale(x.cols(), alpha, row, row);
+    }
+}
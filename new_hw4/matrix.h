@@ -6,10 +6,21 @@
 #include <stdexcept>
 #include <initializer_list>
 #include <cstddef>
+#include <utility>
+#include "aligned_allocator.h"
+#include "basic_matrix.h"
+#include "matrix_expr.h"
+#include "matrix_view.h"
+#include "elementwise.h"
 
-class Matrix {
+// Double-precision matrix. This specialization of BasicMatrix (see
+// basic_matrix.h) carries the optimized machinery: expression templates,
+// views, the blocked GEMM and the factorizations.
+template <>
+class BasicMatrix<double> : public MatrixExpr<Matrix> {
 private:
-    std::vector<double> data_;
+    // Row-major elements; the buffer starts on a MATRIX_ALIGNMENT boundary
+    std::vector<double, AlignedAllocator<double>> data_;
     size_t num_rows_;
     size_t num_cols_;
     
@@ -20,34 +31,59 @@ private:
     
     // Helper function for floating-point comparison
     bool almostEqual(double a, double b) const;
+    
+    // Helper function for scalar division: 1 / scalar, rejecting zero
+    static double reciprocal(double scalar);
+    
+    // Views use reciprocal() for operator/=
+    friend class MatrixView;
+    
+    // Helper function for the _into kernels: set the shape, keeping the
+    // existing allocation when it is large enough (contents unspecified)
+    void reshape(size_t rows, size_t cols);
 
 public:
     // ========== CONSTRUCTORS & DESTRUCTOR ==========
     
     // Default constructor: creates empty 0x0 matrix
-    Matrix();
+    BasicMatrix();
     
     // Create matrix of given size (zero-initialized)
-    Matrix(size_t rows, size_t cols);
+    BasicMatrix(size_t rows, size_t cols);
     
     // Create matrix filled with specific value
-    Matrix(size_t rows, size_t cols, double value);
+    BasicMatrix(size_t rows, size_t cols, double value);
     
     // Create from initializer list
     // Example: Matrix m = {{1, 2}, {3, 4}};
-    Matrix(std::initializer_list<std::initializer_list<double>> list);
+    BasicMatrix(std::initializer_list<std::initializer_list<double>> list);
     
     // Copy constructor
-    Matrix(const Matrix& other);
+    BasicMatrix(const Matrix& other);
+    
+    // Move constructor (steals the buffer; other is left as a 0x0 matrix)
+    BasicMatrix(Matrix&& other) noexcept;
+    
+    // Materialize an element-wise expression in a single pass
+    // Example: Matrix m = a + b * 2.0 - c;
+    template <typename E>
+    BasicMatrix(const MatrixExpr<E>& expr);
     
     // Destructor (using std::vector so default is fine, but declared for completeness)
-    ~Matrix() = default;
+    ~BasicMatrix() = default;
     
     // ========== ASSIGNMENT OPERATORS ==========
     
     // Copy assignment
     Matrix& operator=(const Matrix& other);
     
+    // Move assignment
+    Matrix& operator=(Matrix&& other) noexcept;
+    
+    // Expression assignment (evaluates in place when the shape matches)
+    template <typename E>
+    Matrix& operator=(const MatrixExpr<E>& expr);
+    
     // ========== ELEMENT ACCESS ==========
     
     // Access element (no bounds checking)
@@ -58,6 +94,29 @@ public:
     double& at(size_t row, size_t col);
     const double& at(size_t row, size_t col) const;
     
+    // Raw row-major storage
+    double* data();
+    const double* data() const;
+    
+    // ========== VIEWS ==========
+    
+    // Non-owning windows onto this matrix's elements (see matrix_view.h).
+    // Bounds are checked when the view is created (std::out_of_range).
+    
+    // rows x cols block whose top-left element is (row, col)
+    MatrixView block(size_t row, size_t col, size_t rows, size_t cols);
+    ConstMatrixView block(size_t row, size_t col, size_t rows, size_t cols) const;
+    
+    // Single row (1 x cols) or column (rows x 1)
+    MatrixView row(size_t i);
+    ConstMatrixView row(size_t i) const;
+    MatrixView col(size_t j);
+    ConstMatrixView col(size_t j) const;
+    
+    // Diagonal as a column vector, without copying (cf. diagonal())
+    MatrixView diagonal_view();
+    ConstMatrixView diagonal_view() const;
+    
     // ========== SIZE AND PROPERTIES ==========
     
     size_t rows() const;
@@ -67,31 +126,24 @@ public:
     
     // ========== ARITHMETIC OPERATORS ==========
     
-    // Matrix addition
-    Matrix operator+(const Matrix& other) const;
-    
-    // Matrix subtraction
-    Matrix operator-(const Matrix& other) const;
-    
     // Matrix multiplication
     Matrix operator*(const Matrix& other) const;
     
-    // Scalar multiplication (matrix * scalar)
-    Matrix operator*(double scalar) const;
-    
-    // Scalar multiplication (scalar * matrix)
-    friend Matrix operator*(double scalar, const Matrix& m);
-    
-    // Scalar division
-    Matrix operator/(double scalar) const;
+    // Addition, subtraction, scalar multiplication, scalar division and
+    // unary negation are lazy expressions; see the free operators below
     
-    // Unary negation
-    Matrix operator-() const;
+    // Scalar division (needs reciprocal())
+    template <typename E>
+    friend MatrixScaleExpr<E> operator/(const MatrixExpr<E>& expr, double scalar);
     
     // ========== COMPOUND ASSIGNMENT OPERATORS ==========
     
     Matrix& operator+=(const Matrix& other);
     Matrix& operator-=(const Matrix& other);
+    template <typename E>
+    Matrix& operator+=(const MatrixExpr<E>& expr);
+    template <typename E>
+    Matrix& operator-=(const MatrixExpr<E>& expr);
     Matrix& operator*=(const Matrix& other);
     Matrix& operator*=(double scalar);
     Matrix& operator/=(double scalar);
@@ -106,6 +158,9 @@ public:
     // Transpose
     Matrix transpose() const;
     
+    // Transpose without allocating a second matrix (rows and cols swap)
+    void transposeInPlace();
+    
     // Trace (sum of diagonal elements, square matrices only)
     double trace() const;
     
@@ -115,9 +170,55 @@ public:
     // Fill matrix with value
     void fill(double value);
     
-    // Frobenius norm
+    // Frobenius norm (overflow-safe)
     double norm() const;
     
+    // ========== REDUCTIONS ==========
+    
+    // Multithreaded and bitwise reproducible for any thread count; see
+    // reduce.h. trace() and norm() above use the same reductions.
+    
+    // Sum of all elements
+    double sum() const;
+    
+    // Smallest and largest element, NaN if any element is NaN
+    // (std::logic_error for an empty matrix)
+    double min() const;
+    double max() const;
+    
+    // Sum of each row as a rows x 1 column, of each column as a 1 x cols row
+    Matrix rowSums() const;
+    Matrix columnSums() const;
+    
+    // ========== LINEAR SYSTEMS ==========
+    
+    // These factor the matrix with LUDecomposition (lu.h) on every call;
+    // keep an LUDecomposition around to reuse one factorization instead.
+    // Square matrices only (std::logic_error); singular matrices throw
+    // std::runtime_error.
+    
+    // Solve this * X = b (b may have several columns)
+    Matrix solve(const Matrix& b) const;
+    
+    // Matrix inverse
+    Matrix inverse() const;
+    
+    // Determinant (zero for singular matrices)
+    double determinant() const;
+    
+    // ========== MATRIX FUNCTIONS ==========
+    
+    // Square matrices only (std::logic_error)
+    
+    // this^n by repeated squaring: O(log n) products instead of n - 1.
+    // n = 0 gives the identity; negative n raises inverse() to -n, so a
+    // singular matrix throws std::runtime_error.
+    Matrix pow(int n) const;
+    
+    // Matrix exponential e^this by scaling and squaring with a Pade
+    // approximant of degree 3 to 13 chosen from the 1-norm (Higham 2005)
+    Matrix expm() const;
+    
     // ========== STATIC FACTORY METHODS ==========
     
     // Create n×n identity matrix
@@ -132,10 +233,456 @@ public:
     // Create diagonal matrix from vector
     static Matrix diagonal(const std::vector<double>& diag);
     
+    // ========== ALLOCATION-FREE KERNELS ==========
+    
+    // Write the result into out, resizing it only if its shape differs.
+    // Once out has the right shape these never allocate, so they can be
+    // called in hot loops with a preallocated output. Inputs may be whole
+    // matrices or views.
+    
+    // out = a + b (out may alias a or b)
+    friend void add_into(ConstMatrixView a, ConstMatrixView b, Matrix& out);
+    
+    // out = a - b (out may alias a or b)
+    friend void subtract_into(ConstMatrixView a, ConstMatrixView b, Matrix& out);
+    
+    // out = a * b (out must not overlap a or b)
+    friend void multiply_into(ConstMatrixView a, ConstMatrixView b, Matrix& out);
+    
+    // out = a^T (out must not overlap a)
+    friend void transpose_into(ConstMatrixView a, Matrix& out);
+    
     // ========== STREAM OPERATORS ==========
     
+    // Text I/O through the bulk routines in matrix_text.h. Output prints
+    // each element in shortest round-trip form. Input into an empty matrix
+    // reads to the end of the stream and takes the shape from the text;
+    // otherwise exactly rows() * cols() values are read.
     friend std::ostream& operator<<(std::ostream& os, const Matrix& m);
     friend std::istream& operator>>(std::istream& is, Matrix& m);
 };
 
+// ========== EXPRESSION OPERATORS ==========
+
+// Matrix addition
+template <typename L, typename R>
+MatrixBinaryExpr<L, R, AddOp> operator+(const MatrixExpr<L>& lhs, const MatrixExpr<R>& rhs) {
+    if (lhs.self().rows() != rhs.self().rows() || lhs.self().cols() != rhs.self().cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for addition");
+    }
+    return MatrixBinaryExpr<L, R, AddOp>(lhs.self(), rhs.self());
+}
+
+// Matrix subtraction
+template <typename L, typename R>
+MatrixBinaryExpr<L, R, SubtractOp> operator-(const MatrixExpr<L>& lhs, const MatrixExpr<R>& rhs) {
+    if (lhs.self().rows() != rhs.self().rows() || lhs.self().cols() != rhs.self().cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for subtraction");
+    }
+    return MatrixBinaryExpr<L, R, SubtractOp>(lhs.self(), rhs.self());
+}
+
+// Scalar multiplication (matrix * scalar)
+template <typename E>
+MatrixScaleExpr<E> operator*(const MatrixExpr<E>& expr, double scalar) {
+    return MatrixScaleExpr<E>(expr.self(), scalar);
+}
+
+// Scalar multiplication (scalar * matrix)
+template <typename E>
+MatrixScaleExpr<E> operator*(double scalar, const MatrixExpr<E>& expr) {
+    return MatrixScaleExpr<E>(expr.self(), scalar);
+}
+
+// Scalar division
+template <typename E>
+MatrixScaleExpr<E> operator/(const MatrixExpr<E>& expr, double scalar) {
+    return MatrixScaleExpr<E>(expr.self(), Matrix::reciprocal(scalar));
+}
+
+// Unary negation
+template <typename E>
+MatrixNegateExpr<E> operator-(const MatrixExpr<E>& expr) {
+    return MatrixNegateExpr<E>(expr.self());
+}
+
+// Operators taking an expiring Matrix write the result into its buffer
+// instead of allocating, e.g. (A * B) + C or -(A * B) reuse the product
+template <typename E>
+Matrix operator+(Matrix&& lhs, const MatrixExpr<E>& rhs) {
+    lhs += rhs;
+    return std::move(lhs);
+}
+
+template <typename E>
+Matrix operator+(const MatrixExpr<E>& lhs, Matrix&& rhs) {
+    if (lhs.self().rows() != rhs.rows() || lhs.self().cols() != rhs.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for addition");
+    }
+    rhs = lhs.self() + rhs;
+    return std::move(rhs);
+}
+
+template <typename E>
+Matrix operator-(Matrix&& lhs, const MatrixExpr<E>& rhs) {
+    lhs -= rhs;
+    return std::move(lhs);
+}
+
+template <typename E>
+Matrix operator-(const MatrixExpr<E>& lhs, Matrix&& rhs) {
+    if (lhs.self().rows() != rhs.rows() || lhs.self().cols() != rhs.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for subtraction");
+    }
+    rhs = lhs.self() - rhs;
+    return std::move(rhs);
+}
+
+// Both operands expiring: reuse the left one
+Matrix operator+(Matrix&& lhs, Matrix&& rhs);
+Matrix operator-(Matrix&& lhs, Matrix&& rhs);
+
+Matrix operator*(Matrix&& m, double scalar);
+Matrix operator*(double scalar, Matrix&& m);
+Matrix operator/(Matrix&& m, double scalar);
+Matrix operator-(Matrix&& m);
+
+// out = a * b written into an existing block of the right shape, e.g. a
+// trailing block of a larger matrix (out must not overlap a or b)
+void multiply_into(ConstMatrixView a, ConstMatrixView b, MatrixView out);
+
+// ========== BLAS-STYLE UPDATES ==========
+
+// In-place updates of an existing matrix or view, so accumulation loops
+// such as C = C + 2.0 * (A * B) need no temporaries. Shapes must match
+// exactly (std::invalid_argument); nothing is resized.
+
+// C = alpha * op(A) * op(B) + beta * C, where op(X) is X^T when trans_x is
+// set. Transposed operands are read through swapped strides, not copied.
+// As in BLAS, beta == 0 overwrites C without reading it. C must not
+// overlap A or B.
+void gemm(double alpha, ConstMatrixView a, bool trans_a,
+          ConstMatrixView b, bool trans_b, double beta, MatrixView c);
+
+// y = alpha * x + y
+void axpy(double alpha, ConstMatrixView x, MatrixView y);
+
+// x = alpha * x
+void scal(double alpha, MatrixView x);
+
+// How a product operand is handed to the GEMM kernel: matrices and views
+// are passed by view without copying, other expressions are materialized
+template <typename E>
+struct ProductOperand {
+    Matrix value;
+    ConstMatrixView view;
+    explicit ProductOperand(const E& e) : value(e), view(value) {}
+};
+
+template <>
+struct ProductOperand<Matrix> {
+    ConstMatrixView view;
+    explicit ProductOperand(const Matrix& m) : view(m) {}
+};
+
+template <>
+struct ProductOperand<ConstMatrixView> {
+    ConstMatrixView view;
+    explicit ProductOperand(const ConstMatrixView& v) : view(v) {}
+};
+
+template <>
+struct ProductOperand<MatrixView> {
+    ConstMatrixView view;
+    explicit ProductOperand(const MatrixView& v) : view(v) {}
+};
+
+// Matrix multiplication is not element-wise, so the product is computed
+// eagerly; Matrix * Matrix uses the member operator
+template <typename L, typename R>
+Matrix operator*(const MatrixExpr<L>& lhs, const MatrixExpr<R>& rhs) {
+    ProductOperand<L> a(lhs.self());
+    ProductOperand<R> b(rhs.self());
+    Matrix result;
+    multiply_into(a.view, b.view, result);
+    return result;
+}
+
+// Comparisons against expressions compare the materialized result
+template <typename E>
+bool operator==(const Matrix& lhs, const MatrixExpr<E>& rhs) {
+    return lhs == Matrix(rhs);
+}
+
+template <typename E>
+bool operator==(const MatrixExpr<E>& lhs, const Matrix& rhs) {
+    return Matrix(lhs) == rhs;
+}
+
+template <typename L, typename R>
+bool operator==(const MatrixExpr<L>& lhs, const MatrixExpr<R>& rhs) {
+    return Matrix(lhs) == Matrix(rhs);
+}
+
+template <typename L, typename R>
+bool operator!=(const MatrixExpr<L>& lhs, const MatrixExpr<R>& rhs) {
+    return !(lhs == rhs);
+}
+
+// ========== EXPRESSION EVALUATION ==========
+
+template <typename E>
+Matrix MatrixExpr<E>::eval() const {
+    return Matrix(*this);
+}
+
+template <typename E>
+bool MatrixExpr<E>::isEmpty() const {
+    return self().rows() == 0 || self().cols() == 0;
+}
+
+template <typename E>
+bool MatrixExpr<E>::isSquare() const {
+    return self().rows() == self().cols() && self().rows() > 0;
+}
+
+template <typename E>
+double MatrixExpr<E>::at(size_t row, size_t col) const {
+    if (row >= self().rows() || col >= self().cols()) {
+        throw std::out_of_range("Matrix index out of range");
+    }
+    return self()(row, col);
+}
+
+template <typename E>
+Matrix MatrixExpr<E>::transpose() const {
+    return eval().transpose();
+}
+
+template <typename E>
+double MatrixExpr<E>::trace() const {
+    return eval().trace();
+}
+
+template <typename E>
+Matrix MatrixExpr<E>::diagonal() const {
+    return eval().diagonal();
+}
+
+template <typename E>
+double MatrixExpr<E>::norm() const {
+    return eval().norm();
+}
+
+template <typename E>
+double MatrixExpr<E>::sum() const {
+    return eval().sum();
+}
+
+template <typename E>
+double MatrixExpr<E>::min() const {
+    return eval().min();
+}
+
+template <typename E>
+double MatrixExpr<E>::max() const {
+    return eval().max();
+}
+
+template <typename E>
+Matrix MatrixExpr<E>::rowSums() const {
+    return eval().rowSums();
+}
+
+template <typename E>
+Matrix MatrixExpr<E>::columnSums() const {
+    return eval().columnSums();
+}
+
+template <typename E>
+Matrix MatrixExpr<E>::solve(const Matrix& b) const {
+    return eval().solve(b);
+}
+
+template <typename E>
+Matrix MatrixExpr<E>::inverse() const {
+    return eval().inverse();
+}
+
+template <typename E>
+double MatrixExpr<E>::determinant() const {
+    return eval().determinant();
+}
+
+template <typename E>
+Matrix MatrixExpr<E>::pow(int n) const {
+    return eval().pow(n);
+}
+
+template <typename E>
+Matrix MatrixExpr<E>::expm() const {
+    return eval().expm();
+}
+
+// The common single-operation expressions over contiguous operands
+// (a + b, a - b, a * s, -a) are evaluated by one SIMD kernel call;
+// evaluateSimd returns false for every other expression, which then takes
+// the generic element loop
+
+// Start of an operand's elements if they are contiguous and row-major,
+// nullptr otherwise
+inline const double* contiguousData(const MatrixLeaf& m) {
+    return m.data();
+}
+
+inline const double* contiguousData(const ConstMatrixView& v) {
+    bool contiguous = (v.colStride() == 1 || v.cols() <= 1) &&
+                      (v.rowStride() == v.cols() || v.rows() <= 1);
+    return contiguous ? v.data() : nullptr;
+}
+
+inline const double* contiguousData(const MatrixView& v) {
+    return contiguousData(ConstMatrixView(v));
+}
+
+template <typename E>
+const double* contiguousData(const E&) {
+    return nullptr;
+}
+
+template <typename E>
+bool evaluateSimd(const E&, double*) {
+    return false;
+}
+
+template <typename L, typename R>
+bool evaluateSimd(const MatrixBinaryExpr<L, R, AddOp>& e, double* out) {
+    const double* a = contiguousData(e.lhs());
+    const double* b = contiguousData(e.rhs());
+    if (a == nullptr || b == nullptr) {
+        return false;
+    }
+    kernels::add(e.rows() * e.cols(), a, b, out);
+    return true;
+}
+
+template <typename L, typename R>
+bool evaluateSimd(const MatrixBinaryExpr<L, R, SubtractOp>& e, double* out) {
+    const double* a = contiguousData(e.lhs());
+    const double* b = contiguousData(e.rhs());
+    if (a == nullptr || b == nullptr) {
+        return false;
+    }
+    kernels::subtract(e.rows() * e.cols(), a, b, out);
+    return true;
+}
+
+template <typename E>
+bool evaluateSimd(const MatrixScaleExpr<E>& e, double* out) {
+    const double* a = contiguousData(e.operand());
+    if (a == nullptr) {
+        return false;
+    }
+    kernels::scale(e.rows() * e.cols(), e.scalar(), a, out);
+    return true;
+}
+
+template <typename E>
+bool evaluateSimd(const MatrixNegateExpr<E>& e, double* out) {
+    const double* a = contiguousData(e.operand());
+    if (a == nullptr) {
+        return false;
+    }
+    kernels::scale(e.rows() * e.cols(), -1.0, a, out);
+    return true;
+}
+
+template <typename E>
+Matrix::BasicMatrix(const MatrixExpr<E>& expr)
+    : data_(expr.self().rows() * expr.self().cols()),
+      num_rows_(expr.self().rows()), num_cols_(expr.self().cols()) {
+    typename ExprOperand<E>::type e(expr.self());
+    double* out = data_.data();
+    if (evaluateSimd(e, out)) {
+        return;
+    }
+    for (size_t i = 0; i < num_rows_; ++i) {
+        for (size_t j = 0; j < num_cols_; ++j) {
+            out[i * num_cols_ + j] = e(i, j);
+        }
+    }
+}
+
+template <typename E>
+Matrix& Matrix::operator=(const MatrixExpr<E>& expr) {
+    typename ExprOperand<E>::type e(expr.self());
+    MatrixSpan target{data_.data(), num_rows_, num_cols_, num_cols_, 1};
+    if (num_rows_ != e.rows() || num_cols_ != e.cols() || e.aliases(target)) {
+        // Build the result separately: the expression reads this matrix
+        // through a different layout (e.g. a view of part of it), or
+        // resizing would free storage the expression still reads
+        Matrix result(expr);
+        data_.swap(result.data_);
+        num_rows_ = result.num_rows_;
+        num_cols_ = result.num_cols_;
+        return *this;
+    }
+    
+    // Element (i, j) of the result only depends on element (i, j) of each
+    // operand, so evaluating straight into our own storage is safe when
+    // this matrix itself appears in the expression
+    double* out = data_.data();
+    if (evaluateSimd(e, out)) {
+        return *this;
+    }
+    for (size_t i = 0; i < num_rows_; ++i) {
+        for (size_t j = 0; j < num_cols_; ++j) {
+            out[i * num_cols_ + j] = e(i, j);
+        }
+    }
+    return *this;
+}
+
+template <typename E>
+Matrix& Matrix::operator+=(const MatrixExpr<E>& expr) {
+    typename ExprOperand<E>::type e(expr.self());
+    if (num_rows_ != e.rows() || num_cols_ != e.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for addition");
+    }
+    MatrixSpan target{data_.data(), num_rows_, num_cols_, num_cols_, 1};
+    if (e.aliases(target)) {
+        // Snapshot sources that read this matrix through another layout
+        return *this += Matrix(expr);
+    }
+    
+    double* out = data_.data();
+    for (size_t i = 0; i < num_rows_; ++i) {
+        for (size_t j = 0; j < num_cols_; ++j) {
+            out[i * num_cols_ + j] += e(i, j);
+        }
+    }
+    return *this;
+}
+
+template <typename E>
+Matrix& Matrix::operator-=(const MatrixExpr<E>& expr) {
+    typename ExprOperand<E>::type e(expr.self());
+    if (num_rows_ != e.rows() || num_cols_ != e.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for subtraction");
+    }
+    MatrixSpan target{data_.data(), num_rows_, num_cols_, num_cols_, 1};
+    if (e.aliases(target)) {
+        // Snapshot sources that read this matrix through another layout
+        return *this -= Matrix(expr);
+    }
+    
+    double* out = data_.data();
+    for (size_t i = 0; i < num_rows_; ++i) {
+        for (size_t j = 0; j < num_cols_; ++j) {
+            out[i * num_cols_ + j] -= e(i, j);
+        }
+    }
+    return *this;
+}
+
 #endif // MATRIX_H
\ No newline at end of file
@@ -0,0 +1,267 @@
+#ifndef MATRIX_EXPR_H
+#define MATRIX_EXPR_H
+
+#include <cstddef>
+
+// Expression templates for element-wise Matrix arithmetic.
+//
+// Operators such as A + B * 2.0 - C build a tree of lightweight expression
+// nodes instead of computing intermediate matrices. The tree is evaluated
+// in a single fused loop, with no temporaries, when it is assigned to (or
+// used to construct) a Matrix.
+//
+// Expression nodes refer to the matrices they were built from, so an
+// expression must be materialized before those matrices go away. Store
+// results as Matrix, not auto.
+
+template <typename T>
+class BasicMatrix;
+
+// Double-precision matrix, the type expressions are built from
+using Matrix = BasicMatrix<double>;
+
+// ========== EXPRESSION BASE ==========
+
+// CRTP base shared by Matrix, the matrix views and every expression node.
+// Each node and leaf provides rows(), cols(), an element read
+// operator()(i, j) and aliases(target).
+template <typename E>
+class MatrixExpr {
+public:
+    const E& self() const { return static_cast<const E&>(*this); }
+
+    // Materialize into a Matrix
+    Matrix eval() const;
+
+    // The const Matrix interface, so calls such as (a + b).norm() keep
+    // working (defined in matrix.h). Size queries and at() read the
+    // expression directly; the rest evaluate it first. Views (block(),
+    // row(), ...) and data() are left out, since they would point into
+    // that temporary.
+    bool isEmpty() const;
+    bool isSquare() const;
+    double at(size_t row, size_t col) const;
+
+    Matrix transpose() const;
+    double trace() const;
+    Matrix diagonal() const;
+    double norm() const;
+
+    double sum() const;
+    double min() const;
+    double max() const;
+    Matrix rowSums() const;
+    Matrix columnSums() const;
+
+    Matrix solve(const Matrix& b) const;
+    Matrix inverse() const;
+    double determinant() const;
+
+    Matrix pow(int n) const;
+    Matrix expm() const;
+};
+
+// ========== ALIASING ==========
+
+// Memory footprint of a strided matrix: element (i, j) lives at
+// data[i * row_stride + j * col_stride]
+struct MatrixSpan {
+    const double* data;
+    size_t rows;
+    size_t cols;
+    size_t row_stride;
+    size_t col_stride;
+
+    bool isEmpty() const { return rows == 0 || cols == 0; }
+
+    // Address of the last element
+    const double* last() const {
+        return data + (rows - 1) * row_stride + (cols - 1) * col_stride;
+    }
+
+    // The span as count lines of length contiguous elements, stride apart
+    // (rows, or columns of a transposed view). Returns false if neither
+    // rows nor columns are contiguous.
+    bool lines(size_t& count, size_t& stride, size_t& length) const {
+        if (col_stride == 1 || cols == 1) {
+            count = rows;
+            stride = row_stride;
+            length = cols;
+            return true;
+        }
+        if (row_stride == 1 || rows == 1) {
+            count = cols;
+            stride = col_stride;
+            length = rows;
+            return true;
+        }
+        return false;
+    }
+
+    // True if the two spans share an element. Spans made of lines with the
+    // same stride (blocks of one matrix) are compared line by line, so
+    // disjoint blocks do not count as overlapping even though their
+    // address ranges interleave; other layouts compare address ranges.
+    bool overlaps(const MatrixSpan& other) const {
+        if (isEmpty() || other.isEmpty()) {
+            return false;
+        }
+        if (data > other.last() || other.data > last()) {
+            return false;
+        }
+        size_t count, stride, length, other_count, other_stride, other_length;
+        if (!lines(count, stride, length) ||
+            !other.lines(other_count, other_stride, other_length)) {
+            return true;
+        }
+        if (count == 1 && other_count == 1) {
+            return true;  // Two intervals, already known to intersect
+        }
+        size_t pitch = count > 1 ? stride : other_stride;
+        if ((count > 1 && other_count > 1 && stride != other_stride) ||
+            length > pitch || other_length > pitch) {
+            return true;
+        }
+
+        // other starts line q, column r of this span's grid (0 <= r < pitch);
+        // its lines then cover columns r..r + other_length of lines q.. and
+        // any part past pitch wraps onto the next line
+        ptrdiff_t offset = other.data - data;
+        ptrdiff_t p = static_cast<ptrdiff_t>(pitch);
+        ptrdiff_t q = offset >= 0 ? offset / p : -((-offset + p - 1) / p);
+        ptrdiff_t r = offset - q * p;
+        ptrdiff_t n = static_cast<ptrdiff_t>(count);
+        ptrdiff_t other_n = static_cast<ptrdiff_t>(other_count);
+        bool same_line = r < static_cast<ptrdiff_t>(length) && q < n && q + other_n > 0;
+        bool next_line = r + static_cast<ptrdiff_t>(other_length) > p &&
+                         q + 1 < n && q + 1 + other_n > 0;
+        return same_line || next_line;
+    }
+
+    // True if both spans map (i, j) to the same address for every element
+    bool sameLayout(const MatrixSpan& other) const {
+        return data == other.data && rows == other.rows && cols == other.cols &&
+               (rows == 1 || row_stride == other.row_stride) &&
+               (cols == 1 || col_stride == other.col_stride);
+    }
+};
+
+// Writing an expression into target element by element is only safe if
+// no leaf reads an element of target other than the one being written.
+// Every leaf and node answers that through aliases(target).
+
+// ========== LEAF ==========
+
+// Non-owning, inlinable read access to a Matrix inside an expression
+class MatrixLeaf {
+private:
+    const double* data_;
+    size_t num_rows_;
+    size_t num_cols_;
+
+public:
+    template <typename M>
+    explicit MatrixLeaf(const M& m)
+        : data_(m.data()), num_rows_(m.rows()), num_cols_(m.cols()) {}
+
+    size_t rows() const { return num_rows_; }
+    size_t cols() const { return num_cols_; }
+    const double* data() const { return data_; }
+    double operator()(size_t row, size_t col) const {
+        return data_[row * num_cols_ + col];
+    }
+
+    bool aliases(const MatrixSpan& target) const {
+        MatrixSpan span{data_, num_rows_, num_cols_, num_cols_, 1};
+        return span.overlaps(target) && !span.sameLayout(target);
+    }
+};
+
+// How a node stores an operand: matrices through a leaf, views and
+// sub-expressions by value (they are only a few pointers and scalars)
+template <typename E>
+struct ExprOperand {
+    using type = E;
+};
+
+template <>
+struct ExprOperand<Matrix> {
+    using type = MatrixLeaf;
+};
+
+// ========== ELEMENT-WISE OPERATIONS ==========
+
+struct AddOp {
+    static double apply(double a, double b) { return a + b; }
+};
+
+struct SubtractOp {
+    static double apply(double a, double b) { return a - b; }
+};
+
+// ========== EXPRESSION NODES ==========
+
+// Element-wise lhs op rhs (operands already checked to have equal shape)
+template <typename L, typename R, typename Op>
+class MatrixBinaryExpr : public MatrixExpr<MatrixBinaryExpr<L, R, Op>> {
+private:
+    typename ExprOperand<L>::type lhs_;
+    typename ExprOperand<R>::type rhs_;
+
+public:
+    MatrixBinaryExpr(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {}
+
+    const typename ExprOperand<L>::type& lhs() const { return lhs_; }
+    const typename ExprOperand<R>::type& rhs() const { return rhs_; }
+
+    size_t rows() const { return lhs_.rows(); }
+    size_t cols() const { return lhs_.cols(); }
+    double operator()(size_t row, size_t col) const {
+        return Op::apply(lhs_(row, col), rhs_(row, col));
+    }
+    bool aliases(const MatrixSpan& target) const {
+        return lhs_.aliases(target) || rhs_.aliases(target);
+    }
+};
+
+// Element-wise expr * scalar (scalar division is folded into this node)
+template <typename E>
+class MatrixScaleExpr : public MatrixExpr<MatrixScaleExpr<E>> {
+private:
+    typename ExprOperand<E>::type expr_;
+    double scalar_;
+
+public:
+    MatrixScaleExpr(const E& expr, double scalar) : expr_(expr), scalar_(scalar) {}
+
+    const typename ExprOperand<E>::type& operand() const { return expr_; }
+    double scalar() const { return scalar_; }
+
+    size_t rows() const { return expr_.rows(); }
+    size_t cols() const { return expr_.cols(); }
+    double operator()(size_t row, size_t col) const {
+        return expr_(row, col) * scalar_;
+    }
+    bool aliases(const MatrixSpan& target) const { return expr_.aliases(target); }
+};
+
+// Element-wise -expr
+template <typename E>
+class MatrixNegateExpr : public MatrixExpr<MatrixNegateExpr<E>> {
+private:
+    typename ExprOperand<E>::type expr_;
+
+public:
+    explicit MatrixNegateExpr(const E& expr) : expr_(expr) {}
+
+    const typename ExprOperand<E>::type& operand() const { return expr_; }
+
+    size_t rows() const { return expr_.rows(); }
+    size_t cols() const { return expr_.cols(); }
+    double operator()(size_t row, size_t col) const {
+        return -expr_(row, col);
+    }
+    bool aliases(const MatrixSpan& target) const { return expr_.aliases(target); }
+};
+
+#endif // MATRIX_EXPR_H
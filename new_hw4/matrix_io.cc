@@ -0,0 +1,281 @@
+#include "matrix_io.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char MAGIC[4] = {'M', 'T', 'R', 'X'};
+
+uint64_t byteSwap(uint64_t value) {
+    return __builtin_bswap64(value);
+}
+
+// Validate a header read from path and return it in host byte order
+MatrixFileHeader decodeHeader(MatrixFileHeader header, const std::string& path) {
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a matrix file: " + path);
+    }
+    if (header.version != MATRIX_FILE_VERSION) {
+        throw std::runtime_error("Unsupported matrix file version: " + path);
+    }
+    if (header.dtype != MatrixDataType::Float64) {
+        throw std::runtime_error("Unsupported matrix element type: " + path);
+    }
+    if (header.byte_order != MatrixByteOrder::Little &&
+        header.byte_order != MatrixByteOrder::Big) {
+        throw std::runtime_error("Invalid byte order in matrix file: " + path);
+    }
+    if (header.byte_order != hostByteOrder()) {
+        header.rows = byteSwap(header.rows);
+        header.cols = byteSwap(header.cols);
+    }
+    if (header.cols != 0 && header.rows > SIZE_MAX / sizeof(double) / header.cols) {
+        throw std::runtime_error("Matrix file dimensions too large: " + path);
+    }
+    return header;
+}
+
+MatrixFileHeader makeHeader(size_t rows, size_t cols) {
+    MatrixFileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = MATRIX_FILE_VERSION;
+    header.dtype = MatrixDataType::Float64;
+    header.byte_order = hostByteOrder();
+    header.rows = rows;
+    header.cols = cols;
+    return header;
+}
+
+} // namespace
+
+MatrixByteOrder hostByteOrder() {
+    const uint16_t probe = 1;
+    uint8_t first_byte;
+    std::memcpy(&first_byte, &probe, 1);
+    return first_byte == 1 ? MatrixByteOrder::Little : MatrixByteOrder::Big;
+}
+
+// ========== WHOLE-MATRIX I/O ==========
+
+void saveBinary(const Matrix& m, const std::string& path) {
+    MatrixWriter writer(path, m.cols());
+    writer.writeRows(m);
+    writer.close();
+}
+
+Matrix loadBinary(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open matrix file: " + path);
+    }
+    MatrixFileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("Truncated matrix file: " + path);
+    }
+    bool swap = header.byte_order != hostByteOrder();
+    header = decodeHeader(header, path);
+
+    // Check the header against the file size before allocating, so a
+    // corrupt header cannot request a huge matrix
+    size_t bytes = header.rows * header.cols * sizeof(double);
+    std::streamoff header_end = in.tellg();
+    in.seekg(0, std::ios::end);
+    std::streamoff file_end = in.tellg();
+    if (!in || static_cast<size_t>(file_end - header_end) < bytes) {
+        throw std::runtime_error("Truncated matrix file: " + path);
+    }
+    in.seekg(header_end);
+
+    Matrix result(header.rows, header.cols);
+    if (bytes > 0 && !in.read(reinterpret_cast<char*>(result.data()), bytes)) {
+        throw std::runtime_error("Truncated matrix file: " + path);
+    }
+    if (swap) {
+        uint64_t* words = reinterpret_cast<uint64_t*>(result.data());
+        for (size_t i = 0; i < header.rows * header.cols; ++i) {
+            words[i] = byteSwap(words[i]);
+        }
+    }
+    return result;
+}
+
+// ========== MEMORY-MAPPED MATRIX ==========
+
+MappedMatrix::MappedMatrix(const std::string& path)
+    : mapping_(nullptr), mapping_size_(0), data_(nullptr), num_rows_(0), num_cols_(0) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open matrix file: " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot open matrix file: " + path);
+    }
+    size_t file_size = static_cast<size_t>(info.st_size);
+    if (file_size < sizeof(MatrixFileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Truncated matrix file: " + path);
+    }
+
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map matrix file: " + path);
+    }
+    mapping_ = mapping;
+    mapping_size_ = file_size;
+
+    try {
+        MatrixFileHeader header;
+        std::memcpy(&header, mapping_, sizeof(header));
+        if (header.byte_order != hostByteOrder()) {
+            throw std::runtime_error(
+                "Matrix file byte order differs from host; use loadBinary: " + path);
+        }
+        header = decodeHeader(header, path);
+        if (file_size - sizeof(header) < header.rows * header.cols * sizeof(double)) {
+            throw std::runtime_error("Truncated matrix file: " + path);
+        }
+        num_rows_ = header.rows;
+        num_cols_ = header.cols;
+    } catch (...) {
+        unmap();
+        throw;
+    }
+    data_ = reinterpret_cast<const double*>(
+        static_cast<const char*>(mapping_) + sizeof(MatrixFileHeader));
+}
+
+MappedMatrix::~MappedMatrix() {
+    unmap();
+}
+
+MappedMatrix::MappedMatrix(MappedMatrix&& other) noexcept
+    : mapping_(other.mapping_), mapping_size_(other.mapping_size_), data_(other.data_),
+      num_rows_(other.num_rows_), num_cols_(other.num_cols_) {
+    other.mapping_ = nullptr;
+    other.mapping_size_ = 0;
+    other.data_ = nullptr;
+    other.num_rows_ = 0;
+    other.num_cols_ = 0;
+}
+
+MappedMatrix& MappedMatrix::operator=(MappedMatrix&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        std::swap(mapping_, other.mapping_);
+        std::swap(mapping_size_, other.mapping_size_);
+        std::swap(data_, other.data_);
+        std::swap(num_rows_, other.num_rows_);
+        std::swap(num_cols_, other.num_cols_);
+    }
+    return *this;
+}
+
+void MappedMatrix::unmap() {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+        data_ = nullptr;
+        num_rows_ = 0;
+        num_cols_ = 0;
+    }
+}
+
+ConstMatrixView MappedMatrix::view() const {
+    return ConstMatrixView(data_, num_rows_, num_cols_, num_cols_);
+}
+
+Matrix MappedMatrix::toMatrix() const {
+    Matrix result(num_rows_, num_cols_);
+    std::copy(data_, data_ + num_rows_ * num_cols_, result.data());
+    return result;
+}
+
+// ========== STREAMING WRITER ==========
+
+MatrixWriter::MatrixWriter(const std::string& path, size_t cols)
+    : out_(path, std::ios::binary | std::ios::trunc), path_(path),
+      num_rows_(0), num_cols_(cols) {
+    if (!out_) {
+        throw std::runtime_error("Cannot create matrix file: " + path);
+    }
+    writeHeader();
+}
+
+MatrixWriter::~MatrixWriter() {
+    if (out_.is_open()) {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+}
+
+void MatrixWriter::writeHeader() {
+    MatrixFileHeader header = makeHeader(num_rows_, num_cols_);
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out_) {
+        throw std::runtime_error("Cannot write matrix file: " + path_);
+    }
+}
+
+void MatrixWriter::writeRow(const double* values) {
+    if (!out_.is_open()) {
+        throw std::logic_error("Matrix writer is closed");
+    }
+    out_.write(reinterpret_cast<const char*>(values), num_cols_ * sizeof(double));
+    if (!out_) {
+        throw std::runtime_error("Cannot write matrix file: " + path_);
+    }
+    ++num_rows_;
+}
+
+void MatrixWriter::writeRows(ConstMatrixView block) {
+    if (block.cols() != num_cols_) {
+        throw std::invalid_argument("Matrix dimensions must match for writing");
+    }
+    if (block.colStride() == 1 && block.rowStride() == num_cols_) {
+        // Contiguous block: one write for all of it
+        if (!out_.is_open()) {
+            throw std::logic_error("Matrix writer is closed");
+        }
+        out_.write(reinterpret_cast<const char*>(block.data()),
+                   block.rows() * num_cols_ * sizeof(double));
+        if (!out_) {
+            throw std::runtime_error("Cannot write matrix file: " + path_);
+        }
+        num_rows_ += block.rows();
+        return;
+    }
+
+    std::vector<double> row(num_cols_);
+    for (size_t i = 0; i < block.rows(); ++i) {
+        for (size_t j = 0; j < num_cols_; ++j) {
+            row[j] = block(i, j);
+        }
+        writeRow(row.data());
+    }
+}
+
+void MatrixWriter::close() {
+    if (!out_.is_open()) {
+        return;
+    }
+    // The header was written with a provisional row count
+    out_.seekp(0);
+    writeHeader();
+    out_.close();
+    if (!out_) {
+        throw std::runtime_error("Cannot write matrix file: " + path_);
+    }
+}
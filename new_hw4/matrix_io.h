@@ -0,0 +1,130 @@
+#ifndef MATRIX_IO_H
+#define MATRIX_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "matrix.h"
+
+// Binary on-disk format for matrices.
+//
+// A file is a 64-byte header followed by rows * cols elements in row-major
+// order, with no separators. The element data starts on a 64-byte
+// boundary, so a memory-mapped file can be used in place as a matrix view.
+// All I/O failures and malformed files throw std::runtime_error.
+
+// ========== FILE FORMAT ==========
+
+enum class MatrixDataType : uint8_t {
+    Float64 = 1
+};
+
+enum class MatrixByteOrder : uint8_t {
+    Little = 1,
+    Big = 2
+};
+
+struct MatrixFileHeader {
+    char magic[4];              // "MTRX"
+    uint8_t version;            // MATRIX_FILE_VERSION
+    MatrixDataType dtype;
+    MatrixByteOrder byte_order; // of every multi-byte field that follows
+    uint8_t reserved;
+    uint64_t rows;
+    uint64_t cols;
+    uint8_t padding[40];
+};
+
+static_assert(sizeof(MatrixFileHeader) == 64, "Matrix file header must be 64 bytes");
+
+constexpr uint8_t MATRIX_FILE_VERSION = 1;
+
+// Byte order of this machine, written into every new file
+MatrixByteOrder hostByteOrder();
+
+// ========== WHOLE-MATRIX I/O ==========
+
+void saveBinary(const Matrix& m, const std::string& path);
+
+// Read a whole file into a new Matrix. Files written on a machine of the
+// other byte order are converted.
+Matrix loadBinary(const std::string& path);
+
+// ========== MEMORY-MAPPED MATRIX ==========
+
+// Read-only matrix backed directly by a mapped file. Opening costs O(1)
+// regardless of size: nothing is parsed or copied, and pages are read
+// from disk as they are touched. The file must be in host byte order.
+class MappedMatrix {
+private:
+    void* mapping_;
+    size_t mapping_size_;
+    const double* data_;
+    size_t num_rows_;
+    size_t num_cols_;
+
+    void unmap();
+
+public:
+    explicit MappedMatrix(const std::string& path);
+    ~MappedMatrix();
+
+    MappedMatrix(const MappedMatrix&) = delete;
+    MappedMatrix& operator=(const MappedMatrix&) = delete;
+    MappedMatrix(MappedMatrix&& other) noexcept;
+    MappedMatrix& operator=(MappedMatrix&& other) noexcept;
+
+    size_t rows() const { return num_rows_; }
+    size_t cols() const { return num_cols_; }
+    const double* data() const { return data_; }
+
+    double operator()(size_t row, size_t col) const {
+        return data_[row * num_cols_ + col];
+    }
+
+    // View of the mapped elements; valid while this object lives
+    ConstMatrixView view() const;
+
+    // Copy the mapped elements into an ordinary Matrix
+    Matrix toMatrix() const;
+};
+
+// ========== STREAMING WRITER ==========
+
+// Writes a matrix a few rows at a time, so results larger than memory can
+// be produced without ever holding the whole matrix. The row count is
+// whatever has been written when the writer is closed.
+class MatrixWriter {
+private:
+    std::ofstream out_;
+    std::string path_;
+    size_t num_rows_;
+    size_t num_cols_;
+
+    void writeHeader();
+
+public:
+    MatrixWriter(const std::string& path, size_t cols);
+
+    // Closes the file if close() was not called (errors are swallowed;
+    // call close() to see them)
+    ~MatrixWriter();
+
+    MatrixWriter(const MatrixWriter&) = delete;
+    MatrixWriter& operator=(const MatrixWriter&) = delete;
+
+    // Append one row of cols() values
+    void writeRow(const double* values);
+
+    // Append every row of a block with cols() columns
+    void writeRows(ConstMatrixView block);
+
+    // Finish the header and flush the file
+    void close();
+
+    size_t rows() const { return num_rows_; }
+    size_t cols() const { return num_cols_; }
+};
+
+#endif // MATRIX_IO_H
@@ -0,0 +1,267 @@
+#include "matrix_text.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Longest output of std::to_chars for a double in shortest form
+constexpr size_t MAX_DOUBLE_CHARS = 32;
+
+// Stream output is staged in blocks of this many bytes
+constexpr size_t TEXT_BUFFER = 1 << 16;
+
+bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == ',' || c == ';' ||
+           c == '[' || c == ']';
+}
+
+// Parse one number starting at first (no leading separators) and return
+// the position just past it, or nullptr if the text is not a number
+const char* parseNumber(const char* first, const char* last, double& value) {
+    // from_chars does not accept an explicit plus sign
+    if (first != last && *first == '+' && last - first > 1 && first[1] != '-') {
+        ++first;
+    }
+    std::from_chars_result result = std::from_chars(first, last, value);
+    if (result.ec == std::errc::invalid_argument) {
+        return nullptr;
+    }
+    // from_chars leaves value unset for out-of-range input; strtod
+    // saturates it to +-inf or 0 instead
+    if (result.ec == std::errc::result_out_of_range) {
+        value = std::strtod(std::string(first, result.ptr).c_str(), nullptr);
+    }
+    if (result.ptr != last && !isSeparator(*result.ptr) && *result.ptr != '\n') {
+        return nullptr;
+    }
+    return result.ptr;
+}
+
+// Collects formatted text into a std::string
+class StringSink {
+private:
+    std::string& out_;
+
+public:
+    explicit StringSink(std::string& out) : out_(out) {}
+
+    // Room for at least n more characters
+    char* reserve(size_t n) {
+        size_t used = out_.size();
+        out_.resize(used + n);
+        return &out_[used];
+    }
+    void commit(char* end) { out_.resize(end - out_.data()); }
+};
+
+// Stages formatted text in a block buffer and writes it to a stream in
+// large pieces
+class StreamSink {
+private:
+    std::ostream& os_;
+    std::vector<char> buffer_;
+    size_t used_;
+
+public:
+    explicit StreamSink(std::ostream& os) : os_(os), buffer_(TEXT_BUFFER), used_(0) {}
+    ~StreamSink() { flush(); }
+
+    char* reserve(size_t n) {
+        if (used_ + n > buffer_.size()) {
+            flush();
+            if (n > buffer_.size()) {
+                buffer_.resize(n);
+            }
+        }
+        return buffer_.data() + used_;
+    }
+    void commit(char* end) { used_ = end - buffer_.data(); }
+
+    void flush() {
+        os_.write(buffer_.data(), used_);
+        used_ = 0;
+    }
+};
+
+template <typename Sink>
+void put(Sink& sink, const char* text) {
+    size_t length = std::strlen(text);
+    char* out = sink.reserve(length);
+    sink.commit(std::copy(text, text + length, out));
+}
+
+// Write the rows of m as row_open v0 separator v1 ... row_close, with
+// row_separator between rows
+template <typename Sink>
+void formatRows(Sink& sink, ConstMatrixView m, const char* separator,
+                const char* row_open, const char* row_close, const char* row_separator) {
+    size_t separator_length = std::strlen(separator);
+    for (size_t i = 0; i < m.rows(); ++i) {
+        if (i > 0) put(sink, row_separator);
+        put(sink, row_open);
+        for (size_t j = 0; j < m.cols(); ++j) {
+            char* out = sink.reserve(MAX_DOUBLE_CHARS + separator_length);
+            if (j > 0) {
+                out = std::copy(separator, separator + separator_length, out);
+            }
+            out = std::to_chars(out, out + MAX_DOUBLE_CHARS, m(i, j)).ptr;
+            sink.commit(out);
+        }
+        put(sink, row_close);
+    }
+}
+
+// Read the next value from a stream buffer, skipping separators and line
+// breaks. Returns false at end of input or on a malformed number.
+bool readValue(std::streambuf& buffer, double& value, bool& at_eof) {
+    using Traits = std::streambuf::traits_type;
+    int c = buffer.sgetc();
+    while (c != Traits::eof() && (isSeparator(Traits::to_char_type(c)) || c == '\n')) {
+        c = buffer.snextc();
+    }
+    if (c == Traits::eof()) {
+        at_eof = true;
+        return false;
+    }
+
+    char token[MAX_DOUBLE_CHARS * 16];
+    size_t length = 0;
+    while (c != Traits::eof() && !isSeparator(Traits::to_char_type(c)) && c != '\n') {
+        if (length == sizeof(token)) {
+            return false;
+        }
+        token[length++] = Traits::to_char_type(c);
+        c = buffer.snextc();
+    }
+    at_eof = c == Traits::eof();
+    return parseNumber(token, token + length, value) == token + length;
+}
+
+} // namespace
+
+// ========== PARSING ==========
+
+Matrix parseMatrix(std::string_view text) {
+    std::vector<double> values;
+    size_t rows = 0;
+    size_t cols = 0;
+
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        const char* line_end = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (line_end == nullptr) {
+            line_end = end;
+        }
+
+        size_t row_start = values.size();
+        while (true) {
+            while (p < line_end && isSeparator(*p)) {
+                ++p;
+            }
+            if (p == line_end) {
+                break;
+            }
+            double value;
+            p = parseNumber(p, line_end, value);
+            if (p == nullptr) {
+                throw std::invalid_argument("Invalid number in matrix text on row " +
+                                            std::to_string(rows + 1));
+            }
+            values.push_back(value);
+        }
+
+        size_t row_length = values.size() - row_start;
+        if (row_length > 0) {
+            if (rows == 0) {
+                cols = row_length;
+            } else if (row_length != cols) {
+                throw std::invalid_argument("All rows must have the same number of columns");
+            }
+            ++rows;
+        }
+        p = line_end + 1;
+    }
+
+    Matrix result(rows, cols);
+    std::copy(values.begin(), values.end(), result.data());
+    return result;
+}
+
+Matrix readMatrix(std::istream& is) {
+    std::string text;
+    std::streambuf* buffer = is.rdbuf();
+    std::streamsize got;
+    do {
+        size_t used = text.size();
+        text.resize(used + TEXT_BUFFER);
+        got = buffer->sgetn(&text[used], TEXT_BUFFER);
+        text.resize(used + static_cast<size_t>(got));
+    } while (got == static_cast<std::streamsize>(TEXT_BUFFER));
+    is.setstate(std::ios::eofbit);
+    return parseMatrix(text);
+}
+
+// ========== FORMATTING ==========
+
+std::string formatMatrix(ConstMatrixView m, char delimiter) {
+    std::string out;
+    out.reserve(m.rows() * (m.cols() * 12 + 1));
+    StringSink sink(out);
+    const char separator[2] = {delimiter, '\0'};
+    formatRows(sink, m, separator, "", "\n", "");
+    return out;
+}
+
+void writeMatrix(std::ostream& os, ConstMatrixView m, char delimiter) {
+    StreamSink sink(os);
+    const char separator[2] = {delimiter, '\0'};
+    formatRows(sink, m, separator, "", "\n", "");
+}
+
+// ========== STREAM OPERATORS ==========
+
+std::ostream& operator<<(std::ostream& os, const Matrix& m) {
+    StreamSink sink(os);
+    put(sink, "[");
+    formatRows(sink, m, ", ", "[", "]", "\n ");
+    put(sink, "]");
+    return os;
+}
+
+std::istream& operator>>(std::istream& is, Matrix& m) {
+    std::istream::sentry sentry(is);
+    if (!sentry) {
+        return is;
+    }
+
+    // An empty target takes its shape from the input, which is read to
+    // the end
+    if (m.isEmpty()) {
+        try {
+            m = readMatrix(is);
+        } catch (const std::invalid_argument&) {
+            is.setstate(std::ios::failbit);
+        }
+        return is;
+    }
+
+    std::streambuf& buffer = *is.rdbuf();
+    bool at_eof = false;
+    for (size_t i = 0; i < m.rows(); ++i) {
+        for (size_t j = 0; j < m.cols(); ++j) {
+            if (!readValue(buffer, m(i, j), at_eof)) {
+                is.setstate(at_eof ? std::ios::failbit | std::ios::eofbit : std::ios::failbit);
+                return is;
+            }
+        }
+    }
+    if (at_eof) {
+        is.setstate(std::ios::eofbit);
+    }
+    return is;
+}
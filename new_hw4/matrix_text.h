@@ -0,0 +1,37 @@
+#ifndef MATRIX_TEXT_H
+#define MATRIX_TEXT_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "matrix.h"
+
+// Bulk text parsing and formatting for matrices.
+//
+// Numbers are converted with std::from_chars / std::to_chars over large
+// buffers instead of going through the iostream locale machinery one
+// element at a time. Formatting writes the shortest decimal form that
+// reads back to the identical double, so text round-trips exactly.
+//
+// Input is one matrix row per line. Values may be separated by commas,
+// semicolons, spaces or tabs, and square brackets are ignored, so both
+// CSV and the operator<< layout are accepted. Blank lines are skipped.
+// The stream operators for Matrix (declared in matrix.h) use the same
+// routines.
+
+// ========== PARSING ==========
+
+// Parse text into a matrix whose dimensions are taken from the input.
+// Throws std::invalid_argument on a malformed number or ragged rows.
+Matrix parseMatrix(std::string_view text);
+
+// Read everything left in the stream and parse it as with parseMatrix
+Matrix readMatrix(std::istream& is);
+
+// ========== FORMATTING ==========
+
+// One line per row, values separated by delimiter
+std::string formatMatrix(ConstMatrixView m, char delimiter = ',');
+void writeMatrix(std::ostream& os, ConstMatrixView m, char delimiter = ',');
+
+#endif // MATRIX_TEXT_H
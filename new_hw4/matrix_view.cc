@@ -0,0 +1,111 @@
+#include "matrix_view.h"
+#include "matrix.h"
+
+namespace {
+
+void checkBlock(size_t row, size_t col, size_t rows, size_t cols,
+                size_t num_rows, size_t num_cols) {
+    if (row > num_rows || col > num_cols ||
+        rows > num_rows - row || cols > num_cols - col) {
+        throw std::out_of_range("Matrix block out of range");
+    }
+}
+
+} // namespace
+
+// ========== CONST VIEW ==========
+
+ConstMatrixView::ConstMatrixView(const double* data, size_t rows, size_t cols,
+                                 size_t row_stride, size_t col_stride)
+    : data_(data), num_rows_(rows), num_cols_(cols),
+      row_stride_(row_stride), col_stride_(col_stride) {}
+
+ConstMatrixView::ConstMatrixView(const Matrix& m)
+    : data_(m.data()), num_rows_(m.rows()), num_cols_(m.cols()),
+      row_stride_(m.cols()), col_stride_(1) {}
+
+ConstMatrixView::ConstMatrixView(const MatrixView& view)
+    : data_(view.data()), num_rows_(view.rows()), num_cols_(view.cols()),
+      row_stride_(view.rowStride()), col_stride_(view.colStride()) {}
+
+const double& ConstMatrixView::at(size_t row, size_t col) const {
+    if (row >= num_rows_ || col >= num_cols_) {
+        throw std::out_of_range("Matrix index out of range");
+    }
+    return (*this)(row, col);
+}
+
+ConstMatrixView ConstMatrixView::block(size_t row, size_t col, size_t rows, size_t cols) const {
+    checkBlock(row, col, rows, cols, num_rows_, num_cols_);
+    return ConstMatrixView(data_ + row * row_stride_ + col * col_stride_,
+                           rows, cols, row_stride_, col_stride_);
+}
+
+ConstMatrixView ConstMatrixView::row(size_t i) const {
+    return block(i, 0, 1, num_cols_);
+}
+
+ConstMatrixView ConstMatrixView::col(size_t j) const {
+    return block(0, j, num_rows_, 1);
+}
+
+// ========== MUTABLE VIEW ==========
+
+MatrixView::MatrixView(double* data, size_t rows, size_t cols,
+                       size_t row_stride, size_t col_stride)
+    : data_(data), num_rows_(rows), num_cols_(cols),
+      row_stride_(row_stride), col_stride_(col_stride) {}
+
+MatrixView::MatrixView(Matrix& m)
+    : data_(m.data()), num_rows_(m.rows()), num_cols_(m.cols()),
+      row_stride_(m.cols()), col_stride_(1) {}
+
+MatrixView& MatrixView::operator=(const MatrixView& other) {
+    if (num_rows_ != other.num_rows_ || num_cols_ != other.num_cols_) {
+        throw std::invalid_argument("Matrix dimensions must match for view assignment");
+    }
+    assign(other);
+    return *this;
+}
+
+double& MatrixView::at(size_t row, size_t col) const {
+    if (row >= num_rows_ || col >= num_cols_) {
+        throw std::out_of_range("Matrix index out of range");
+    }
+    return (*this)(row, col);
+}
+
+MatrixView& MatrixView::operator*=(double scalar) {
+    for (size_t i = 0; i < num_rows_; ++i) {
+        for (size_t j = 0; j < num_cols_; ++j) {
+            (*this)(i, j) *= scalar;
+        }
+    }
+    return *this;
+}
+
+MatrixView& MatrixView::operator/=(double scalar) {
+    return *this *= Matrix::reciprocal(scalar);
+}
+
+void MatrixView::fill(double value) {
+    for (size_t i = 0; i < num_rows_; ++i) {
+        for (size_t j = 0; j < num_cols_; ++j) {
+            (*this)(i, j) = value;
+        }
+    }
+}
+
+MatrixView MatrixView::block(size_t row, size_t col, size_t rows, size_t cols) const {
+    checkBlock(row, col, rows, cols, num_rows_, num_cols_);
+    return MatrixView(data_ + row * row_stride_ + col * col_stride_,
+                      rows, cols, row_stride_, col_stride_);
+}
+
+MatrixView MatrixView::row(size_t i) const {
+    return block(i, 0, 1, num_cols_);
+}
+
+MatrixView MatrixView::col(size_t j) const {
+    return block(0, j, num_rows_, 1);
+}
@@ -0,0 +1,212 @@
+#ifndef MATRIX_VIEW_H
+#define MATRIX_VIEW_H
+
+#include <cstddef>
+#include <vector>
+#include <stdexcept>
+#include "matrix_expr.h"
+
+// Non-owning, strided windows onto Matrix storage.
+//
+// Element (i, j) of a view lives at data[i * rowStride() + j * colStride()],
+// which covers whole matrices, blocks, single rows and columns, and the
+// diagonal (row stride cols + 1). Views take part in expressions like any
+// Matrix and are accepted by the multiply/_into kernels, so blocked
+// algorithms can work on parts of a matrix without copying them.
+//
+// A view does not keep its matrix alive and is invalidated by anything
+// that reallocates the matrix (reshaping, assigning a different shape).
+
+class MatrixView;
+
+// ========== CONST VIEW ==========
+
+class ConstMatrixView : public MatrixExpr<ConstMatrixView> {
+private:
+    const double* data_;
+    size_t num_rows_;
+    size_t num_cols_;
+    size_t row_stride_;
+    size_t col_stride_;
+
+public:
+    // View rows x cols elements starting at data
+    ConstMatrixView(const double* data, size_t rows, size_t cols,
+                    size_t row_stride, size_t col_stride = 1);
+
+    // View a whole matrix (implicit so matrices can be passed as views)
+    ConstMatrixView(const Matrix& m);
+
+    // Read-only view of a mutable view
+    ConstMatrixView(const MatrixView& view);
+
+    // ========== ELEMENT ACCESS ==========
+
+    const double& operator()(size_t row, size_t col) const {
+        return data_[row * row_stride_ + col * col_stride_];
+    }
+
+    // Access with bounds checking
+    const double& at(size_t row, size_t col) const;
+
+    // ========== SIZE AND LAYOUT ==========
+
+    size_t rows() const { return num_rows_; }
+    size_t cols() const { return num_cols_; }
+    size_t rowStride() const { return row_stride_; }
+    size_t colStride() const { return col_stride_; }
+    const double* data() const { return data_; }
+    bool isEmpty() const { return num_rows_ == 0 || num_cols_ == 0; }
+
+    MatrixSpan span() const {
+        return MatrixSpan{data_, num_rows_, num_cols_, row_stride_, col_stride_};
+    }
+
+    bool aliases(const MatrixSpan& target) const {
+        return span().overlaps(target) && !span().sameLayout(target);
+    }
+
+    // ========== SUB-VIEWS ==========
+
+    ConstMatrixView block(size_t row, size_t col, size_t rows, size_t cols) const;
+    ConstMatrixView row(size_t i) const;
+    ConstMatrixView col(size_t j) const;
+};
+
+// ========== MUTABLE VIEW ==========
+
+class MatrixView : public MatrixExpr<MatrixView> {
+private:
+    double* data_;
+    size_t num_rows_;
+    size_t num_cols_;
+    size_t row_stride_;
+    size_t col_stride_;
+
+    // Write every element of an expression into the view
+    template <typename E>
+    void assign(const E& e);
+
+public:
+    // View rows x cols elements starting at data
+    MatrixView(double* data, size_t rows, size_t cols,
+               size_t row_stride, size_t col_stride = 1);
+
+    // View a whole matrix (implicit so matrices can be passed as views)
+    MatrixView(Matrix& m);
+
+    // Copying a view makes another view of the same elements
+    MatrixView(const MatrixView& other) = default;
+
+    // ========== ASSIGNMENT ==========
+
+    // Assigning to a view writes through to the viewed elements; the
+    // shapes must match. Overlapping sources are handled correctly.
+    MatrixView& operator=(const MatrixView& other);
+    template <typename E>
+    MatrixView& operator=(const MatrixExpr<E>& expr);
+
+    // ========== ELEMENT ACCESS ==========
+
+    double& operator()(size_t row, size_t col) const {
+        return data_[row * row_stride_ + col * col_stride_];
+    }
+
+    // Access with bounds checking
+    double& at(size_t row, size_t col) const;
+
+    // ========== SIZE AND LAYOUT ==========
+
+    size_t rows() const { return num_rows_; }
+    size_t cols() const { return num_cols_; }
+    size_t rowStride() const { return row_stride_; }
+    size_t colStride() const { return col_stride_; }
+    double* data() const { return data_; }
+    bool isEmpty() const { return num_rows_ == 0 || num_cols_ == 0; }
+
+    MatrixSpan span() const {
+        return MatrixSpan{data_, num_rows_, num_cols_, row_stride_, col_stride_};
+    }
+
+    bool aliases(const MatrixSpan& target) const {
+        return span().overlaps(target) && !span().sameLayout(target);
+    }
+
+    // ========== COMPOUND ASSIGNMENT OPERATORS ==========
+
+    template <typename E>
+    MatrixView& operator+=(const MatrixExpr<E>& expr);
+    template <typename E>
+    MatrixView& operator-=(const MatrixExpr<E>& expr);
+    MatrixView& operator*=(double scalar);
+    MatrixView& operator/=(double scalar);
+
+    // Fill every viewed element with value
+    void fill(double value);
+
+    // ========== SUB-VIEWS ==========
+
+    MatrixView block(size_t row, size_t col, size_t rows, size_t cols) const;
+    MatrixView row(size_t i) const;
+    MatrixView col(size_t j) const;
+};
+
+// ========== VIEW EXPRESSION EVALUATION ==========
+
+template <typename E>
+void MatrixView::assign(const E& e) {
+    if (e.aliases(span())) {
+        // The source reads elements we are about to overwrite, so take a
+        // snapshot first
+        std::vector<double> snapshot(num_rows_ * num_cols_);
+        for (size_t i = 0; i < num_rows_; ++i) {
+            for (size_t j = 0; j < num_cols_; ++j) {
+                snapshot[i * num_cols_ + j] = e(i, j);
+            }
+        }
+        for (size_t i = 0; i < num_rows_; ++i) {
+            for (size_t j = 0; j < num_cols_; ++j) {
+                (*this)(i, j) = snapshot[i * num_cols_ + j];
+            }
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < num_rows_; ++i) {
+        for (size_t j = 0; j < num_cols_; ++j) {
+            (*this)(i, j) = e(i, j);
+        }
+    }
+}
+
+template <typename E>
+MatrixView& MatrixView::operator=(const MatrixExpr<E>& expr) {
+    typename ExprOperand<E>::type e(expr.self());
+    if (num_rows_ != e.rows() || num_cols_ != e.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for view assignment");
+    }
+    assign(e);
+    return *this;
+}
+
+template <typename E>
+MatrixView& MatrixView::operator+=(const MatrixExpr<E>& expr) {
+    typename ExprOperand<E>::type e(expr.self());
+    if (num_rows_ != e.rows() || num_cols_ != e.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for addition");
+    }
+    assign(MatrixBinaryExpr<MatrixView, decltype(e), AddOp>(*this, e));
+    return *this;
+}
+
+template <typename E>
+MatrixView& MatrixView::operator-=(const MatrixExpr<E>& expr) {
+    typename ExprOperand<E>::type e(expr.self());
+    if (num_rows_ != e.rows() || num_cols_ != e.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for subtraction");
+    }
+    assign(MatrixBinaryExpr<MatrixView, decltype(e), SubtractOp>(*this, e));
+    return *this;
+}
+
+#endif // MATRIX_VIEW_H
@@ -0,0 +1,129 @@
+#include "preconditioner.h"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+double invertPivot(double pivot) {
+    if (pivot == 0.0 || !std::isfinite(pivot)) {
+        throw std::runtime_error("Preconditioner has a zero diagonal entry");
+    }
+    return 1.0 / pivot;
+}
+
+void prepareOutput(size_t n, const Vector& r, Vector& z) {
+    if (r.size() != n) {
+        throw std::invalid_argument("Vector size does not match preconditioner");
+    }
+    if (&r == &z) {
+        throw std::invalid_argument("Output of preconditioner must not alias its input");
+    }
+    if (z.size() != n) {
+        z.resize(n);
+    }
+}
+
+} // namespace
+
+// ========== JACOBI ==========
+
+JacobiPreconditioner::JacobiPreconditioner(const Matrix& a) {
+    if (a.rows() != a.cols()) {
+        throw std::logic_error("Preconditioner requires a square matrix");
+    }
+    inverse_diagonal_.resize(a.rows());
+    for (size_t i = 0; i < a.rows(); ++i) {
+        inverse_diagonal_[i] = invertPivot(a(i, i));
+    }
+}
+
+JacobiPreconditioner::JacobiPreconditioner(const SparseMatrix& a) {
+    if (a.rows() != a.cols()) {
+        throw std::logic_error("Preconditioner requires a square matrix");
+    }
+    inverse_diagonal_.resize(a.rows());
+    for (size_t i = 0; i < a.rows(); ++i) {
+        inverse_diagonal_[i] = invertPivot(a(i, i));
+    }
+}
+
+void JacobiPreconditioner::apply(const Vector& r, Vector& z) const {
+    prepareOutput(size(), r, z);
+    for (size_t i = 0; i < size(); ++i) {
+        z[i] = inverse_diagonal_[i] * r[i];
+    }
+}
+
+size_t JacobiPreconditioner::size() const {
+    return inverse_diagonal_.size();
+}
+
+// ========== ILU(0) ==========
+
+ILU0Preconditioner::ILU0Preconditioner(const SparseMatrix& a)
+    : size_(a.rows()), row_ptr_(a.rowPointers()), col_index_(a.columnIndices()),
+      values_(a.values()), diagonal_(a.rows()) {
+    if (a.rows() != a.cols()) {
+        throw std::logic_error("Preconditioner requires a square matrix");
+    }
+    for (size_t i = 0; i < size_; ++i) {
+        size_t k = row_ptr_[i];
+        while (k < row_ptr_[i + 1] && col_index_[k] < i) {
+            ++k;
+        }
+        if (k == row_ptr_[i + 1] || col_index_[k] != i) {
+            throw std::runtime_error("ILU(0) requires every diagonal entry to be stored");
+        }
+        diagonal_[i] = k;
+    }
+
+    // IKJ elimination restricted to the pattern of A: position maps each
+    // column of the current row to its slot in values_
+    constexpr size_t NONE = std::numeric_limits<size_t>::max();
+    std::vector<size_t> position(size_, NONE);
+    for (size_t i = 0; i < size_; ++i) {
+        for (size_t k = row_ptr_[i]; k < row_ptr_[i + 1]; ++k) {
+            position[col_index_[k]] = k;
+        }
+        for (size_t k = row_ptr_[i]; k < diagonal_[i]; ++k) {
+            size_t j = col_index_[k];
+            double factor = values_[k] / values_[diagonal_[j]];
+            values_[k] = factor;
+            for (size_t m = diagonal_[j] + 1; m < row_ptr_[j + 1]; ++m) {
+                size_t slot = position[col_index_[m]];
+                if (slot != NONE) {
+                    values_[slot] -= factor * values_[m];
+                }
+            }
+        }
+        invertPivot(values_[diagonal_[i]]);
+        for (size_t k = row_ptr_[i]; k < row_ptr_[i + 1]; ++k) {
+            position[col_index_[k]] = NONE;
+        }
+    }
+}
+
+void ILU0Preconditioner::apply(const Vector& r, Vector& z) const {
+    prepareOutput(size_, r, z);
+
+    // L * y = r (unit diagonal), then U * z = y, both in z
+    for (size_t i = 0; i < size_; ++i) {
+        double sum = r[i];
+        for (size_t k = row_ptr_[i]; k < diagonal_[i]; ++k) {
+            sum -= values_[k] * z[col_index_[k]];
+        }
+        z[i] = sum;
+    }
+    for (size_t i = size_; i-- > 0;) {
+        double sum = z[i];
+        for (size_t k = diagonal_[i] + 1; k < row_ptr_[i + 1]; ++k) {
+            sum -= values_[k] * z[col_index_[k]];
+        }
+        z[i] = sum / values_[diagonal_[i]];
+    }
+}
+
+size_t ILU0Preconditioner::size() const {
+    return size_;
+}
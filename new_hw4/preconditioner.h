@@ -0,0 +1,63 @@
+#ifndef PRECONDITIONER_H
+#define PRECONDITIONER_H
+
+#include <vector>
+#include <cstddef>
+#include "matrix.h"
+#include "sparse_matrix.h"
+#include "vector.h"
+
+// Preconditioner M ~ A for the Krylov solvers in krylov.h: apply() solves
+// M * z = r. A good M makes M^-1 * A much better conditioned than A while
+// being cheap to apply, which cuts the iteration count.
+class Preconditioner {
+public:
+    virtual ~Preconditioner() = default;
+
+    // z = M^-1 * r. z is resized only if its size differs and must not be r.
+    virtual void apply(const Vector& r, Vector& z) const = 0;
+
+    // Order of M
+    virtual size_t size() const = 0;
+};
+
+// Jacobi (diagonal) preconditioner, M = diag(A). Cheap and effective when
+// A is diagonally dominant or its rows are badly scaled.
+class JacobiPreconditioner : public Preconditioner {
+private:
+    std::vector<double> inverse_diagonal_;
+
+public:
+    // Throw std::logic_error if a is not square and std::runtime_error if
+    // a diagonal entry is zero
+    explicit JacobiPreconditioner(const Matrix& a);
+    explicit JacobiPreconditioner(const SparseMatrix& a);
+
+    void apply(const Vector& r, Vector& z) const override;
+    size_t size() const override;
+};
+
+// Incomplete LU factorization with zero fill-in, M = L * U where L (unit
+// lower) and U (upper) keep exactly the sparsity pattern of A. Applying M^-1
+// is one forward and one backward sparse triangular solve.
+class ILU0Preconditioner : public Preconditioner {
+private:
+    size_t size_;
+    std::vector<size_t> row_ptr_;
+    std::vector<size_t> col_index_;
+    // Strictly lower entries hold L, the rest hold U
+    std::vector<double> values_;
+    // Position of each row's diagonal entry in values_
+    std::vector<size_t> diagonal_;
+
+public:
+    // Factor a square sparse matrix (std::logic_error otherwise). Throws
+    // std::runtime_error if a diagonal entry is missing from the pattern or
+    // a pivot becomes zero.
+    explicit ILU0Preconditioner(const SparseMatrix& a);
+
+    void apply(const Vector& r, Vector& z) const override;
+    size_t size() const override;
+};
+
+#endif // PRECONDITIONER_H
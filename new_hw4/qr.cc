@@ -0,0 +1,276 @@
+#include "qr.h"
+#include "gemm.h"
+#include "triangular.h"
+#include "elementwise.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+// ========== FACTORIZATION ==========
+
+QRDecomposition::QRDecomposition(Matrix a) : qr_(std::move(a)) {
+    factor();
+}
+
+void QRDecomposition::factor() {
+    size_t m = qr_.rows();
+    size_t n = qr_.cols();
+    size_t steps = std::min(m, n);
+    double* a = qr_.data();
+    tau_.assign(steps, 0.0);
+
+    // Workspace reused by every panel: explicit V (unit diagonal, zeros
+    // above), the triangular factor T, and W = V^T * C
+    Matrix v(m, QR_BLOCK);
+    Matrix t(QR_BLOCK, QR_BLOCK);
+    Matrix w(QR_BLOCK, n);
+    std::vector<double> dots(n);
+    std::vector<double> below(m);
+
+    for (size_t k0 = 0; k0 < steps; k0 += QR_BLOCK) {
+        size_t k1 = std::min(k0 + QR_BLOCK, steps);
+
+        // Unblocked Householder QR of the panel (columns k0..k1)
+        for (size_t j = k0; j < k1; ++j) {
+            // Norm of the column below the diagonal, scaled so that the
+            // squares cannot overflow or underflow (LAPACK dlarfg)
+            double alpha = a[j * n + j];
+            for (size_t i = j + 1; i < m; ++i) {
+                below[i - j - 1] = a[i * n + j];
+            }
+            double x_norm = kernels::nrm2(m - j - 1, below.data());
+            if (x_norm == 0.0) {
+                tau_[j] = 0.0;  // Already zero below the diagonal: H = I
+                continue;
+            }
+
+            // H = I - tau * v * v^T maps the column onto beta * e1.
+            // |alpha - beta| >= |beta|, so dividing by it cannot overflow.
+            double beta = -std::copysign(std::hypot(alpha, x_norm), alpha);
+            double tau = (beta - alpha) / beta;
+            double pivot = alpha - beta;
+            for (size_t i = j + 1; i < m; ++i) {
+                a[i * n + j] /= pivot;
+            }
+            a[j * n + j] = beta;
+            tau_[j] = tau;
+
+            // Apply H to the rest of the panel: dots = v^T * A[j:m, j+1:k1]
+            for (size_t c = j + 1; c < k1; ++c) {
+                dots[c] = a[j * n + c];
+            }
+            for (size_t i = j + 1; i < m; ++i) {
+                double v_i = a[i * n + j];
+                for (size_t c = j + 1; c < k1; ++c) {
+                    dots[c] += v_i * a[i * n + c];
+                }
+            }
+            for (size_t c = j + 1; c < k1; ++c) {
+                a[j * n + c] -= tau * dots[c];
+            }
+            for (size_t i = j + 1; i < m; ++i) {
+                double v_i = a[i * n + j];
+                for (size_t c = j + 1; c < k1; ++c) {
+                    a[i * n + c] -= tau * v_i * dots[c];
+                }
+            }
+        }
+
+        if (k1 >= n) {
+            break;
+        }
+        size_t kb = k1 - k0;
+        size_t mv = m - k0;
+        size_t nc = n - k1;
+
+        // Copy the panel's reflectors into V with explicit unit diagonal
+        for (size_t i = 0; i < mv; ++i) {
+            for (size_t c = 0; c < kb; ++c) {
+                double value = 0.0;
+                if (i == c) {
+                    value = 1.0;
+                } else if (i > c) {
+                    value = a[(k0 + i) * n + k0 + c];
+                }
+                v(i, c) = value;
+            }
+        }
+
+        // T such that H(k0) ... H(k1 - 1) = I - V * T * V^T (LAPACK larft):
+        // T(0:c, c) = -tau_c * T(0:c, 0:c) * V(:, 0:c)^T * v_c
+        for (size_t c = 0; c < kb; ++c) {
+            double tau_c = tau_[k0 + c];
+            t(c, c) = tau_c;
+            for (size_t r = 0; r < c; ++r) {
+                double s = 0.0;
+                for (size_t i = c; i < mv; ++i) {
+                    s += v(i, r) * v(i, c);
+                }
+                t(r, c) = -tau_c * s;
+            }
+            // Multiply the new column by the already-formed upper triangle
+            for (size_t r = 0; r < c; ++r) {
+                double s = 0.0;
+                for (size_t p = r; p < c; ++p) {
+                    s += t(r, p) * t(p, c);
+                }
+                dots[r] = s;
+            }
+            for (size_t r = 0; r < c; ++r) {
+                t(r, c) = dots[r];
+            }
+        }
+
+        // C = (I - V T V^T)^T C = C - V * (T^T * (V^T * C)) for the trailing
+        // columns C = A[k0:m, k1:n]
+        double* c_block = a + k0 * n + k1;
+        std::fill(w.data(), w.data() + kb * n, 0.0);
+        kernels::gemm(kb, nc, mv, 1.0,
+                      v.data(), 1, QR_BLOCK,
+                      c_block, n, 1,
+                      w.data(), n);
+
+        // W = T^T * W in place: row r of the result only needs rows <= r,
+        // so sweep from the bottom up
+        for (size_t r = kb; r-- > 0;) {
+            double* w_r = w.data() + r * n;
+            for (size_t j = 0; j < nc; ++j) {
+                w_r[j] *= t(r, r);
+            }
+            for (size_t p = 0; p < r; ++p) {
+                double t_pr = t(p, r);
+                const double* w_p = w.data() + p * n;
+                for (size_t j = 0; j < nc; ++j) {
+                    w_r[j] += t_pr * w_p[j];
+                }
+            }
+        }
+
+        kernels::gemm(mv, nc, kb, -1.0,
+                      v.data(), QR_BLOCK, 1,
+                      w.data(), n, 1,
+                      c_block, n);
+    }
+}
+
+// ========== SOLVES ==========
+
+void QRDecomposition::applyQt(Matrix& b) const {
+    size_t m = qr_.rows();
+    size_t k = b.cols();
+    std::vector<double> dots(k);
+
+    for (size_t j = 0; j < tau_.size(); ++j) {
+        double tau = tau_[j];
+        if (tau == 0.0) {
+            continue;
+        }
+        // b = (I - tau * v * v^T) b with v = [1; qr_(j+1:m, j)]
+        for (size_t c = 0; c < k; ++c) {
+            dots[c] = b(j, c);
+        }
+        for (size_t i = j + 1; i < m; ++i) {
+            double v_i = qr_(i, j);
+            for (size_t c = 0; c < k; ++c) {
+                dots[c] += v_i * b(i, c);
+            }
+        }
+        for (size_t c = 0; c < k; ++c) {
+            b(j, c) -= tau * dots[c];
+        }
+        for (size_t i = j + 1; i < m; ++i) {
+            double v_i = qr_(i, j);
+            for (size_t c = 0; c < k; ++c) {
+                b(i, c) -= tau * v_i * dots[c];
+            }
+        }
+    }
+}
+
+Matrix QRDecomposition::solve(const Matrix& b) const {
+    size_t m = qr_.rows();
+    size_t n = qr_.cols();
+    if (m < n) {
+        throw std::logic_error("Least-squares solve requires rows >= cols");
+    }
+    if (b.rows() != m) {
+        throw std::invalid_argument("Matrix dimensions incompatible for solve");
+    }
+    // Rank deficient to working precision, as in
+    // SingularValueDecomposition::rank()
+    double largest = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        largest = std::max(largest, std::abs(qr_(i, i)));
+    }
+    double tolerance = static_cast<double>(m) * std::numeric_limits<double>::epsilon() * largest;
+    for (size_t i = 0; i < n; ++i) {
+        if (!(std::abs(qr_(i, i)) > tolerance)) {
+            throw std::runtime_error("Matrix is rank deficient");
+        }
+    }
+
+    // x = R^-1 * (Q^T b)(0:n)
+    Matrix y(b);
+    applyQt(y);
+    Matrix x(y.block(0, 0, n, b.cols()));
+    kernels::solveUpper(qr_.block(0, 0, n, n), x, false);
+    return x;
+}
+
+// ========== FACTORS ==========
+
+Matrix QRDecomposition::q() const {
+    size_t m = qr_.rows();
+    size_t k = tau_.size();
+
+    // Q = H(0) ... H(k-1) * I(:, 0:k); apply the reflectors last to first
+    Matrix q(m, k);
+    for (size_t i = 0; i < k; ++i) {
+        q(i, i) = 1.0;
+    }
+    std::vector<double> dots(k);
+    for (size_t j = k; j-- > 0;) {
+        double tau = tau_[j];
+        if (tau == 0.0) {
+            continue;
+        }
+        for (size_t c = 0; c < k; ++c) {
+            dots[c] = q(j, c);
+        }
+        for (size_t i = j + 1; i < m; ++i) {
+            for (size_t c = 0; c < k; ++c) {
+                dots[c] += qr_(i, j) * q(i, c);
+            }
+        }
+        for (size_t c = 0; c < k; ++c) {
+            q(j, c) -= tau * dots[c];
+        }
+        for (size_t i = j + 1; i < m; ++i) {
+            for (size_t c = 0; c < k; ++c) {
+                q(i, c) -= tau * qr_(i, j) * dots[c];
+            }
+        }
+    }
+    return q;
+}
+
+Matrix QRDecomposition::r() const {
+    size_t k = tau_.size();
+    size_t n = qr_.cols();
+    Matrix r(k, n);
+    for (size_t i = 0; i < k; ++i) {
+        for (size_t j = i; j < n; ++j) {
+            r(i, j) = qr_(i, j);
+        }
+    }
+    return r;
+}
+
+size_t QRDecomposition::rows() const {
+    return qr_.rows();
+}
+
+size_t QRDecomposition::cols() const {
+    return qr_.cols();
+}
@@ -0,0 +1,47 @@
+#ifndef QR_H
+#define QR_H
+
+#include <vector>
+#include <cstddef>
+#include "matrix.h"
+
+// Householder QR decomposition: A = Q * R for an m x n matrix A.
+//
+// The factorization overwrites the matrix it is given (pass an rvalue to
+// avoid the copy): R ends up on and above the diagonal and the Householder
+// vectors below it, as in LAPACK. It is blocked with the compact WY
+// representation: the reflectors of each panel are combined into
+// I - V * T * V^T, which is applied to the trailing columns with GEMM
+// calls instead of one reflector at a time.
+class QRDecomposition {
+private:
+    Matrix qr_;
+    std::vector<double> tau_;
+    
+    void factor();
+    
+    // B = Q^T * B, one reflector at a time (B has m rows)
+    void applyQt(Matrix& b) const;
+
+public:
+    // Panel width of the blocked factorization
+    static constexpr size_t QR_BLOCK = 32;
+    
+    explicit QRDecomposition(Matrix a);
+    
+    // Least-squares solution of A * X = B, minimizing ||A * X - B|| column
+    // by column. Requires rows >= cols (std::logic_error) and full column
+    // rank (std::runtime_error): every |R(i, i)| must exceed
+    // rows * eps * max |R(j, j)|.
+    Matrix solve(const Matrix& b) const;
+    
+    // Thin factors: Q is m x min(m, n) with orthonormal columns and R is
+    // min(m, n) x n upper triangular
+    Matrix q() const;
+    Matrix r() const;
+    
+    size_t rows() const;
+    size_t cols() const;
+};
+
+#endif // QR_H
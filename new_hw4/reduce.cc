@@ -0,0 +1,229 @@
+#include "reduce.h"
+#include "elementwise.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace kernels {
+
+namespace {
+
+// Column chunk one task of columnSums owns (4 KB of each row)
+constexpr size_t REDUCE_COLUMN_CHUNK = 512;
+
+// Leaves held on the stack before pairwise() falls back to the heap
+constexpr size_t REDUCE_STACK_LEAVES = 64;
+
+size_t ceilDiv(size_t value, size_t divisor) {
+    return (value + divisor - 1) / divisor;
+}
+
+bool runParallel(size_t work) {
+    return work >= REDUCE_PARALLEL_THRESHOLD && numThreads() > 1;
+}
+
+// Run body(first, last) over [0, count), split across the pool when work
+// (elements touched) is large enough
+template <typename Body>
+void forEachRange(size_t count, size_t work, Body body) {
+    if (!runParallel(work) || count < 2) {
+        body(0, count);
+        return;
+    }
+    size_t tasks = std::min(count, 4 * numThreads());
+    ThreadPool::global().parallelFor(tasks, [&](size_t t) {
+        body(t * count / tasks, (t + 1) * count / tasks);
+    });
+}
+
+// Reduce [0, n) leaf by leaf with leaf(first, count), then add the leaf
+// results bottom-up in pairs. Which leaves a thread computes never
+// affects the result.
+template <typename Leaf>
+double pairwise(size_t n, Leaf leaf) {
+    size_t leaves = ceilDiv(n, REDUCE_BLOCK);
+    if (leaves <= 1) {
+        return leaf(0, n);
+    }
+    double local[REDUCE_STACK_LEAVES];
+    std::vector<double> heap;
+    double* partial = local;
+    if (leaves > REDUCE_STACK_LEAVES) {
+        heap.resize(leaves);
+        partial = heap.data();
+    }
+
+    forEachRange(leaves, n, [&](size_t first, size_t last) {
+        for (size_t k = first; k < last; ++k) {
+            size_t start = k * REDUCE_BLOCK;
+            partial[k] = leaf(start, std::min(REDUCE_BLOCK, n - start));
+        }
+    });
+    for (size_t width = 1; width < leaves; width *= 2) {
+        for (size_t i = 0; i + width < leaves; i += 2 * width) {
+            partial[i] += partial[i + width];
+        }
+    }
+    return partial[0];
+}
+
+void reduceMinMax(size_t n, const double* a, double* lo, double* hi) {
+    *lo = std::numeric_limits<double>::infinity();
+    *hi = -std::numeric_limits<double>::infinity();
+    size_t leaves = ceilDiv(n, REDUCE_BLOCK);
+    if (leaves <= 1) {
+        minMax(n, a, lo, hi);
+        return;
+    }
+    std::vector<double> lows(leaves, *lo), highs(leaves, *hi);
+    forEachRange(leaves, n, [&](size_t first, size_t last) {
+        for (size_t k = first; k < last; ++k) {
+            size_t start = k * REDUCE_BLOCK;
+            minMax(std::min(REDUCE_BLOCK, n - start), a + start, &lows[k], &highs[k]);
+        }
+    });
+    double unused = 0.0;
+    minMax(leaves, lows.data(), lo, &unused);
+    minMax(leaves, highs.data(), &unused, hi);
+}
+
+// columnSums for one chunk of width columns. Block sums wait on a stack
+// where level k holds the sum of 2^k blocks; two sums of equal weight are
+// merged as soon as they meet, like carries in a binary counter, so the
+// tree is fixed by the row count alone.
+void columnChunk(size_t rows, size_t width, const double* a, size_t lda, double* out) {
+    std::vector<std::vector<double>> stack;
+    std::vector<size_t> weights;
+    std::vector<double> block(width);
+    for (size_t first = 0; first < rows; first += REDUCE_ROW_BLOCK) {
+        size_t last = std::min(rows, first + REDUCE_ROW_BLOCK);
+        std::copy_n(a + first * lda, width, block.begin());
+        for (size_t r = first + 1; r < last; ++r) {
+            add(width, block.data(), a + r * lda, block.data());
+        }
+        size_t weight = 1;
+        while (!weights.empty() && weights.back() == weight) {
+            add(width, stack.back().data(), block.data(), block.data());
+            stack.pop_back();
+            weights.pop_back();
+            weight *= 2;
+        }
+        stack.push_back(block);
+        weights.push_back(weight);
+    }
+
+    if (stack.empty()) {
+        fill(width, 0.0, out);
+        return;
+    }
+    // Fold what is left, newest (smallest) into oldest
+    std::copy(stack.back().begin(), stack.back().end(), out);
+    for (size_t k = stack.size() - 1; k-- > 0;) {
+        add(width, stack[k].data(), out, out);
+    }
+}
+
+} // namespace
+
+// ========== ARRAY REDUCTIONS ==========
+
+double reduceSum(size_t n, const double* a) {
+    return pairwise(n, [=](size_t first, size_t count) { return sum(count, a + first); });
+}
+
+double reduceSum(size_t n, const double* a, size_t stride) {
+    if (stride == 1) {
+        return reduceSum(n, a);
+    }
+    return pairwise(n, [=](size_t first, size_t count) {
+        const double* x = a + first * stride;
+        double total = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            total += x[i * stride];
+        }
+        return total;
+    });
+}
+
+double reduceSumOfSquares(size_t n, const double* a) {
+    return pairwise(n, [=](size_t first, size_t count) {
+        return sumOfSquares(count, a + first);
+    });
+}
+
+double reduceDot(size_t n, const double* a, const double* b) {
+    return pairwise(n, [=](size_t first, size_t count) {
+        return dot(count, a + first, b + first);
+    });
+}
+
+double reduceNorm(size_t n, const double* a) {
+    double sum = reduceSumOfSquares(n, a);
+    if ((sum > DBL_MIN && sum < DBL_MAX) || std::isnan(sum)) {
+        return std::sqrt(sum);
+    }
+
+    // Squares overflowed or underflowed (or a is zero): divide by the
+    // largest magnitude first, as kernels::nrm2 does
+    double lo, hi;
+    reduceMinMax(n, a, &lo, &hi);
+    double largest = std::max(std::abs(lo), std::abs(hi));
+    if (n == 0 || largest == 0.0 || !std::isfinite(largest)) {
+        return n == 0 ? 0.0 : largest;
+    }
+    double scaled = pairwise(n, [=](size_t first, size_t count) {
+        double s = 0.0;
+        for (size_t i = first; i < first + count; ++i) {
+            double r = a[i] / largest;
+            s += r * r;
+        }
+        return s;
+    });
+    return largest * std::sqrt(scaled);
+}
+
+double reduceMin(size_t n, const double* a) {
+    double lo, hi;
+    reduceMinMax(n, a, &lo, &hi);
+    return lo;
+}
+
+double reduceMax(size_t n, const double* a) {
+    double lo, hi;
+    reduceMinMax(n, a, &lo, &hi);
+    return hi;
+}
+
+// ========== MATRIX REDUCTIONS ==========
+
+void rowSums(size_t rows, size_t cols, const double* a, size_t lda, double* out) {
+    // Few rows: let each row's own reduction use the threads instead
+    if (rows < numThreads()) {
+        for (size_t i = 0; i < rows; ++i) {
+            out[i] = reduceSum(cols, a + i * lda);
+        }
+        return;
+    }
+    // Inside a task the per-row reductions run serially (see parallelFor)
+    forEachRange(rows, rows * cols, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            out[i] = reduceSum(cols, a + i * lda);
+        }
+    });
+}
+
+void columnSums(size_t rows, size_t cols, const double* a, size_t lda, double* out) {
+    size_t chunks = ceilDiv(cols, REDUCE_COLUMN_CHUNK);
+    forEachRange(chunks, rows * cols, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) {
+            size_t start = c * REDUCE_COLUMN_CHUNK;
+            columnChunk(rows, std::min(REDUCE_COLUMN_CHUNK, cols - start), a + start, lda,
+                        out + start);
+        }
+    });
+}
+
+} // namespace kernels
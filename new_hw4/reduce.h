@@ -0,0 +1,71 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+#include <cstddef>
+
+namespace kernels {
+
+// ========== REDUCTION PARAMETERS ==========
+
+// Reproducible reductions over large arrays.
+//
+// The input is cut into leaves of REDUCE_BLOCK elements, each reduced by
+// the SIMD kernels in elementwise.h, and the leaf results are combined by
+// a pairwise tree whose shape depends only on n. Leaves are spread over
+// the global thread pool, but since neither the leaves nor the tree depend
+// on how many threads there are, results are bitwise identical for every
+// thread count (on a given SIMD level, see simdLevel()). The pairwise tree
+// also bounds rounding error growth by O(log n) rather than O(n).
+
+// Elements per leaf (32 KB, so a leaf streams through L1)
+constexpr size_t REDUCE_BLOCK = 4096;
+
+// Reductions over fewer elements than this stay on the calling thread
+constexpr size_t REDUCE_PARALLEL_THRESHOLD = 1 << 17;
+
+// Rows summed in sequence before the pairwise tree takes over in
+// columnSums
+constexpr size_t REDUCE_ROW_BLOCK = 64;
+
+// ========== ARRAY REDUCTIONS ==========
+
+// Sum of a[i]
+double reduceSum(size_t n, const double* a);
+
+// Sum of a[i * stride], over the same leaves and tree (a matrix diagonal
+// has stride lda + 1). Leaves are summed in order rather than by the SIMD
+// kernels, so for stride > 1 the last bits can differ from reduceSum on a
+// packed copy; stride 1 gives exactly reduceSum.
+double reduceSum(size_t n, const double* a, size_t stride);
+
+// Sum of a[i]^2
+double reduceSumOfSquares(size_t n, const double* a);
+
+// Sum of a[i] * b[i]
+double reduceDot(size_t n, const double* a, const double* b);
+
+// Euclidean norm. Rescales (one more pass) when the squares overflow or
+// underflow, so the result is accurate for any finite input.
+double reduceNorm(size_t n, const double* a);
+
+// Smallest and largest element (+inf and -inf for n = 0); NaN if any
+// element is NaN
+double reduceMin(size_t n, const double* a);
+double reduceMax(size_t n, const double* a);
+
+// ========== MATRIX REDUCTIONS ==========
+
+// For a rows x cols row-major matrix with row stride lda
+
+// out[i] = sum of row i (rows elements); each row is one reduceSum
+void rowSums(size_t rows, size_t cols, const double* a, size_t lda, double* out);
+
+// out[j] = sum of column j (cols elements). Blocks of REDUCE_ROW_BLOCK
+// rows are added element-wise and the block sums combined pairwise, so
+// every column is summed in the same fixed order; threads split the
+// columns.
+void columnSums(size_t rows, size_t cols, const double* a, size_t lda, double* out);
+
+} // namespace kernels
+
+#endif // REDUCE_H
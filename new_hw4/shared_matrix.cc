@@ -0,0 +1,167 @@
+#include "shared_matrix.h"
+#include <utility>
+
+namespace {
+
+// Value of every empty SharedMatrix
+const Matrix EMPTY_MATRIX;
+
+} // namespace
+
+// ========== PRIVATE HELPER METHODS ==========
+
+void SharedMatrix::release() noexcept {
+    // acq_rel: the thread that deletes the buffer sees every other owner's
+    // writes, and no owner's reads can be reordered after its decrement
+    if (buffer_ != nullptr && buffer_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete buffer_;
+    }
+    buffer_ = nullptr;
+}
+
+void SharedMatrix::detach() {
+    if (buffer_ == nullptr) {
+        buffer_ = new Buffer(Matrix());
+        return;
+    }
+    // Acquire pairs with the release in other owners' release(), so once
+    // the count reads 1 their last accesses to the buffer are complete
+    if (buffer_->refs.load(std::memory_order_acquire) == 1) {
+        return;
+    }
+    Buffer* copy = new Buffer(buffer_->value);
+    release();
+    buffer_ = copy;
+}
+
+// ========== CONSTRUCTORS & DESTRUCTOR ==========
+
+SharedMatrix::SharedMatrix() noexcept : buffer_(nullptr) {}
+
+SharedMatrix::SharedMatrix(Matrix m) : buffer_(new Buffer(std::move(m))) {}
+
+SharedMatrix::SharedMatrix(const SharedMatrix& other) noexcept : buffer_(other.buffer_) {
+    // A new reference is made from an existing one, so no ordering is needed
+    if (buffer_ != nullptr) {
+        buffer_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SharedMatrix::SharedMatrix(SharedMatrix&& other) noexcept : buffer_(other.buffer_) {
+    other.buffer_ = nullptr;
+}
+
+SharedMatrix::~SharedMatrix() {
+    release();
+}
+
+// ========== ASSIGNMENT OPERATORS ==========
+
+SharedMatrix& SharedMatrix::operator=(const SharedMatrix& other) noexcept {
+    if (buffer_ != other.buffer_) {
+        SharedMatrix copy(other);
+        std::swap(buffer_, copy.buffer_);
+    }
+    return *this;
+}
+
+SharedMatrix& SharedMatrix::operator=(SharedMatrix&& other) noexcept {
+    if (this != &other) {
+        release();
+        buffer_ = other.buffer_;
+        other.buffer_ = nullptr;
+    }
+    return *this;
+}
+
+// ========== READ ACCESS ==========
+
+const Matrix& SharedMatrix::get() const {
+    return buffer_ != nullptr ? buffer_->value : EMPTY_MATRIX;
+}
+
+// ========== MUTATING ACCESS ==========
+
+double& SharedMatrix::operator()(size_t row, size_t col) {
+    return mutate()(row, col);
+}
+
+double& SharedMatrix::at(size_t row, size_t col) {
+    // Check before detaching, so a bad index never copies
+    get().at(row, col);
+    return mutate()(row, col);
+}
+
+Matrix& SharedMatrix::mutate() {
+    detach();
+    return buffer_->value;
+}
+
+void SharedMatrix::fill(double value) {
+    if (isShared()) {
+        // Every element is overwritten, so start from a fresh buffer
+        // instead of copying the old one
+        SharedMatrix filled(Matrix(rows(), cols(), value));
+        std::swap(buffer_, filled.buffer_);
+        return;
+    }
+    mutate().fill(value);
+}
+
+// ========== COMPOUND ASSIGNMENT OPERATORS ==========
+
+// other may be this object's own value (s += s.get()); detaching can
+// release that buffer, so the operand is then taken from the new copy
+
+SharedMatrix& SharedMatrix::operator+=(const Matrix& other) {
+    bool self = &other == &get();
+    Matrix& value = mutate();
+    value += self ? value : other;
+    return *this;
+}
+
+SharedMatrix& SharedMatrix::operator-=(const Matrix& other) {
+    bool self = &other == &get();
+    Matrix& value = mutate();
+    value -= self ? value : other;
+    return *this;
+}
+
+SharedMatrix& SharedMatrix::operator*=(const Matrix& other) {
+    bool self = &other == &get();
+    Matrix& value = mutate();
+    value *= self ? value : other;
+    return *this;
+}
+
+SharedMatrix& SharedMatrix::operator*=(double scalar) {
+    mutate() *= scalar;
+    return *this;
+}
+
+SharedMatrix& SharedMatrix::operator/=(double scalar) {
+    mutate() /= scalar;
+    return *this;
+}
+
+// ========== SHARING ==========
+
+size_t SharedMatrix::useCount() const {
+    return buffer_ != nullptr ? buffer_->refs.load(std::memory_order_acquire) : 0;
+}
+
+// ========== COMPARISON OPERATORS ==========
+
+bool SharedMatrix::operator==(const SharedMatrix& other) const {
+    return buffer_ == other.buffer_ || get() == other.get();
+}
+
+bool SharedMatrix::operator!=(const SharedMatrix& other) const {
+    return !(*this == other);
+}
+
+// ========== STREAM OPERATORS ==========
+
+std::ostream& operator<<(std::ostream& os, const SharedMatrix& m) {
+    return os << m.get();
+}
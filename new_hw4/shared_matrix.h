@@ -0,0 +1,120 @@
+#ifndef SHARED_MATRIX_H
+#define SHARED_MATRIX_H
+
+#include <atomic>
+#include <iostream>
+#include <cstddef>
+#include "matrix.h"
+#include "matrix_view.h"
+
+// Matrix with copy-on-write storage, for values that are passed through
+// many stages that mostly only read them.
+//
+// Copies share one reference-counted Matrix, so copying costs an atomic
+// increment instead of a deep copy. The first mutating access through a
+// copy whose buffer is shared (non-const operator() and at(), fill,
+// compound assignment, mutate()) gives that copy its own buffer first. The
+// count is atomic, so copies sharing a buffer may be created, read,
+// mutated and destroyed on different threads; a single SharedMatrix object
+// is no more thread-safe than a Matrix.
+//
+// Read through a const reference (or get()) to avoid copying on a read
+// that happens to go through a non-const object. References and views
+// obtained from a mutating access are only valid until the object is next
+// copied: a later copy shares the buffer they point into.
+class SharedMatrix {
+private:
+    // The shared value and its owner count
+    struct Buffer {
+        std::atomic<size_t> refs;
+        Matrix value;
+        explicit Buffer(Matrix m) : refs(1), value(std::move(m)) {}
+    };
+
+    // Null for an empty matrix, so default construction and moves never
+    // allocate
+    Buffer* buffer_;
+
+    // Drop this object's reference, deleting the buffer with the last one
+    void release() noexcept;
+
+    // Make this object the sole owner of its buffer, copying it if shared
+    void detach();
+
+public:
+    // ========== CONSTRUCTORS & DESTRUCTOR ==========
+
+    // Empty 0x0 matrix
+    SharedMatrix() noexcept;
+
+    // Take over a matrix (move it in to avoid the copy)
+    explicit SharedMatrix(Matrix m);
+
+    // Share other's buffer
+    SharedMatrix(const SharedMatrix& other) noexcept;
+    SharedMatrix(SharedMatrix&& other) noexcept;
+
+    ~SharedMatrix();
+
+    // ========== ASSIGNMENT OPERATORS ==========
+
+    SharedMatrix& operator=(const SharedMatrix& other) noexcept;
+    SharedMatrix& operator=(SharedMatrix&& other) noexcept;
+
+    // ========== READ ACCESS ==========
+
+    // The current value; never copies
+    const Matrix& get() const;
+    operator const Matrix&() const { return get(); }
+    ConstMatrixView view() const { return ConstMatrixView(get()); }
+
+    const double& operator()(size_t row, size_t col) const { return get()(row, col); }
+
+    // Access with bounds checking (throw std::out_of_range)
+    const double& at(size_t row, size_t col) const { return get().at(row, col); }
+
+    const double* data() const { return get().data(); }
+
+    size_t rows() const { return get().rows(); }
+    size_t cols() const { return get().cols(); }
+    bool isEmpty() const { return get().isEmpty(); }
+    bool isSquare() const { return get().isSquare(); }
+
+    // ========== MUTATING ACCESS ==========
+
+    // Each of these first gives this object its own buffer if it is shared
+
+    double& operator()(size_t row, size_t col);
+    double& at(size_t row, size_t col);
+
+    // The value for in-place work with any Matrix routine
+    Matrix& mutate();
+
+    void fill(double value);
+
+    // ========== COMPOUND ASSIGNMENT OPERATORS ==========
+
+    SharedMatrix& operator+=(const Matrix& other);
+    SharedMatrix& operator-=(const Matrix& other);
+    SharedMatrix& operator*=(const Matrix& other);
+    SharedMatrix& operator*=(double scalar);
+    SharedMatrix& operator/=(double scalar);
+
+    // ========== SHARING ==========
+
+    // Number of SharedMatrix objects using this buffer (0 when empty)
+    size_t useCount() const;
+    bool isShared() const { return useCount() > 1; }
+
+    // ========== COMPARISON OPERATORS ==========
+
+    bool operator==(const SharedMatrix& other) const;
+    bool operator!=(const SharedMatrix& other) const;
+
+    // ========== STREAM OPERATORS ==========
+
+    // Same format as Matrix
+    friend std::ostream& operator<<(std::ostream& os, const SharedMatrix& m);
+};
+
+#endif // SHARED_MATRIX_H
@@ -0,0 +1,410 @@
+#include "sparse_matrix.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Run body(first_row, last_row) over all rows of a, split into ranges of
+// about the same number of nonzeros when the product is large enough to
+// be worth spreading over the thread pool. work is the number of
+// multiply-adds the whole product performs.
+template <typename Body>
+void forEachRowRange(const std::vector<size_t>& row_ptr, size_t work, Body body) {
+    size_t rows = row_ptr.size() - 1;
+    size_t threads = kernels::numThreads();
+    if (work < SparseMatrix::SPARSE_PARALLEL_THRESHOLD || threads == 1 || rows < 2) {
+        body(0, rows);
+        return;
+    }
+
+    // A few ranges per thread so one dense row does not stall the rest
+    size_t parts = std::min(4 * threads, rows);
+    size_t nnz = row_ptr[rows];
+    std::vector<size_t> bounds(parts + 1, rows);
+    bounds[0] = 0;
+    for (size_t p = 1; p < parts; ++p) {
+        size_t target = nnz / parts * p + nnz % parts * p / parts;
+        size_t row = std::upper_bound(row_ptr.begin(), row_ptr.end(), target) -
+                     row_ptr.begin() - 1;
+        bounds[p] = std::max(bounds[p - 1], std::min(row, rows));
+    }
+
+    kernels::ThreadPool::global().parallelFor(parts, [&](size_t p) {
+        if (bounds[p] < bounds[p + 1]) {
+            body(bounds[p], bounds[p + 1]);
+        }
+    });
+}
+
+void checkIndex(size_t row, size_t col, size_t rows, size_t cols) {
+    if (row >= rows || col >= cols) {
+        throw std::out_of_range("Sparse matrix index out of range");
+    }
+}
+
+} // namespace
+
+// ========== CONSTRUCTORS ==========
+
+SparseMatrix::SparseMatrix() : num_rows_(0), num_cols_(0), row_ptr_(1, 0) {}
+
+SparseMatrix::SparseMatrix(size_t rows, size_t cols)
+    : num_rows_(rows), num_cols_(cols), row_ptr_(rows + 1, 0) {}
+
+SparseMatrix::SparseMatrix(size_t rows, size_t cols, std::vector<size_t> row_ptr,
+                           std::vector<size_t> col_index, std::vector<double> values)
+    : num_rows_(rows), num_cols_(cols), row_ptr_(std::move(row_ptr)),
+      col_index_(std::move(col_index)), values_(std::move(values)) {
+    if (row_ptr_.size() != rows + 1 || row_ptr_[0] != 0 ||
+        row_ptr_[rows] != values_.size() || col_index_.size() != values_.size()) {
+        throw std::invalid_argument("Invalid CSR structure");
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        if (row_ptr_[i] > row_ptr_[i + 1]) {
+            throw std::invalid_argument("Invalid CSR structure");
+        }
+        for (size_t k = row_ptr_[i]; k < row_ptr_[i + 1]; ++k) {
+            if (col_index_[k] >= cols ||
+                (k > row_ptr_[i] && col_index_[k] <= col_index_[k - 1])) {
+                throw std::invalid_argument("Invalid CSR structure");
+            }
+        }
+    }
+}
+
+SparseMatrix SparseMatrix::fromTriplets(size_t rows, size_t cols,
+                                        const std::vector<Triplet>& triplets) {
+    // Bucket the entries by row (counting sort), then sort each row by
+    // column and merge duplicates
+    std::vector<size_t> row_ptr(rows + 1, 0);
+    for (const Triplet& t : triplets) {
+        checkIndex(t.row, t.col, rows, cols);
+        ++row_ptr[t.row + 1];
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        row_ptr[i + 1] += row_ptr[i];
+    }
+
+    std::vector<std::pair<size_t, double>> entries(triplets.size());
+    std::vector<size_t> next(row_ptr.begin(), row_ptr.end() - 1);
+    for (const Triplet& t : triplets) {
+        entries[next[t.row]++] = {t.col, t.value};
+    }
+
+    SparseMatrix result(rows, cols);
+    result.col_index_.reserve(entries.size());
+    result.values_.reserve(entries.size());
+    for (size_t i = 0; i < rows; ++i) {
+        auto first = entries.begin() + row_ptr[i];
+        auto last = entries.begin() + row_ptr[i + 1];
+        std::sort(first, last, [](const std::pair<size_t, double>& a,
+                                  const std::pair<size_t, double>& b) {
+            return a.first < b.first;
+        });
+        for (auto it = first; it != last; ++it) {
+            if (it != first && it->first == result.col_index_.back()) {
+                result.values_.back() += it->second;
+            } else {
+                result.col_index_.push_back(it->first);
+                result.values_.push_back(it->second);
+            }
+        }
+        result.row_ptr_[i + 1] = result.values_.size();
+    }
+    return result;
+}
+
+SparseMatrix SparseMatrix::fromDense(const Matrix& dense, double tolerance) {
+    SparseMatrix result(dense.rows(), dense.cols());
+    for (size_t i = 0; i < dense.rows(); ++i) {
+        for (size_t j = 0; j < dense.cols(); ++j) {
+            double value = dense(i, j);
+            // Written so that NaN (which compares false) is kept
+            if (!(std::abs(value) <= tolerance)) {
+                result.col_index_.push_back(j);
+                result.values_.push_back(value);
+            }
+        }
+        result.row_ptr_[i + 1] = result.values_.size();
+    }
+    return result;
+}
+
+SparseMatrix SparseMatrix::identity(size_t n) {
+    SparseMatrix result(n, n);
+    result.col_index_.resize(n);
+    result.values_.assign(n, 1.0);
+    for (size_t i = 0; i < n; ++i) {
+        result.col_index_[i] = i;
+        result.row_ptr_[i + 1] = i + 1;
+    }
+    return result;
+}
+
+// ========== CONVERSION ==========
+
+Matrix SparseMatrix::toDense() const {
+    Matrix result(num_rows_, num_cols_);
+    for (size_t i = 0; i < num_rows_; ++i) {
+        for (size_t k = row_ptr_[i]; k < row_ptr_[i + 1]; ++k) {
+            result(i, col_index_[k]) = values_[k];
+        }
+    }
+    return result;
+}
+
+// ========== ELEMENT ACCESS ==========
+
+double SparseMatrix::operator()(size_t row, size_t col) const {
+    auto first = col_index_.begin() + row_ptr_[row];
+    auto last = col_index_.begin() + row_ptr_[row + 1];
+    auto it = std::lower_bound(first, last, col);
+    if (it == last || *it != col) {
+        return 0.0;
+    }
+    return values_[it - col_index_.begin()];
+}
+
+double SparseMatrix::at(size_t row, size_t col) const {
+    checkIndex(row, col, num_rows_, num_cols_);
+    return (*this)(row, col);
+}
+
+// ========== ARITHMETIC OPERATORS ==========
+
+SparseMatrix SparseMatrix::combine(const SparseMatrix& other, double scale) const {
+    SparseMatrix result(num_rows_, num_cols_);
+    result.col_index_.reserve(nonZeros() + other.nonZeros());
+    result.values_.reserve(nonZeros() + other.nonZeros());
+
+    for (size_t i = 0; i < num_rows_; ++i) {
+        // Merge the two sorted rows
+        size_t a = row_ptr_[i], a_end = row_ptr_[i + 1];
+        size_t b = other.row_ptr_[i], b_end = other.row_ptr_[i + 1];
+        while (a < a_end || b < b_end) {
+            if (b == b_end || (a < a_end && col_index_[a] < other.col_index_[b])) {
+                result.col_index_.push_back(col_index_[a]);
+                result.values_.push_back(values_[a]);
+                ++a;
+            } else if (a == a_end || other.col_index_[b] < col_index_[a]) {
+                result.col_index_.push_back(other.col_index_[b]);
+                result.values_.push_back(scale * other.values_[b]);
+                ++b;
+            } else {
+                result.col_index_.push_back(col_index_[a]);
+                result.values_.push_back(values_[a] + scale * other.values_[b]);
+                ++a;
+                ++b;
+            }
+        }
+        result.row_ptr_[i + 1] = result.values_.size();
+    }
+    return result;
+}
+
+SparseMatrix SparseMatrix::operator+(const SparseMatrix& other) const {
+    if (num_rows_ != other.num_rows_ || num_cols_ != other.num_cols_) {
+        throw std::invalid_argument("Matrix dimensions must match for addition");
+    }
+    return combine(other, 1.0);
+}
+
+SparseMatrix SparseMatrix::operator-(const SparseMatrix& other) const {
+    if (num_rows_ != other.num_rows_ || num_cols_ != other.num_cols_) {
+        throw std::invalid_argument("Matrix dimensions must match for subtraction");
+    }
+    return combine(other, -1.0);
+}
+
+SparseMatrix SparseMatrix::operator*(double scalar) const {
+    SparseMatrix result(*this);
+    for (double& value : result.values_) {
+        value *= scalar;
+    }
+    return result;
+}
+
+SparseMatrix operator*(double scalar, const SparseMatrix& m) {
+    return m * scalar;
+}
+
+SparseMatrix SparseMatrix::operator-() const {
+    return *this * -1.0;
+}
+
+std::vector<double> SparseMatrix::operator*(const std::vector<double>& x) const {
+    std::vector<double> y;
+    multiply_into(*this, x, y);
+    return y;
+}
+
+Matrix SparseMatrix::operator*(ConstMatrixView dense) const {
+    Matrix result;
+    multiply_into(*this, dense, result);
+    return result;
+}
+
+// ========== COMPARISON OPERATORS ==========
+
+bool SparseMatrix::operator==(const SparseMatrix& other) const {
+    if (num_rows_ != other.num_rows_ || num_cols_ != other.num_cols_) {
+        return false;
+    }
+    SparseMatrix difference = combine(other, -1.0);
+    for (double value : difference.values_) {
+        if (std::abs(value) >= EPSILON) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SparseMatrix::operator!=(const SparseMatrix& other) const {
+    return !(*this == other);
+}
+
+// ========== OPERATIONS ==========
+
+SparseMatrix SparseMatrix::transpose() const {
+    // Counting sort by column; walking the rows in order leaves the new
+    // rows sorted by column as well
+    SparseMatrix result(num_cols_, num_rows_);
+    result.col_index_.resize(nonZeros());
+    result.values_.resize(nonZeros());
+    for (size_t k = 0; k < nonZeros(); ++k) {
+        ++result.row_ptr_[col_index_[k] + 1];
+    }
+    for (size_t j = 0; j < num_cols_; ++j) {
+        result.row_ptr_[j + 1] += result.row_ptr_[j];
+    }
+
+    std::vector<size_t> next(result.row_ptr_.begin(), result.row_ptr_.end() - 1);
+    for (size_t i = 0; i < num_rows_; ++i) {
+        for (size_t k = row_ptr_[i]; k < row_ptr_[i + 1]; ++k) {
+            size_t dest = next[col_index_[k]]++;
+            result.col_index_[dest] = i;
+            result.values_[dest] = values_[k];
+        }
+    }
+    return result;
+}
+
+void SparseMatrix::prune(double tolerance) {
+    size_t kept = 0;
+    size_t row_start = 0;
+    for (size_t i = 0; i < num_rows_; ++i) {
+        for (size_t k = row_start; k < row_ptr_[i + 1]; ++k) {
+            if (!(std::abs(values_[k]) <= tolerance)) {
+                col_index_[kept] = col_index_[k];
+                values_[kept] = values_[k];
+                ++kept;
+            }
+        }
+        row_start = row_ptr_[i + 1];
+        row_ptr_[i + 1] = kept;
+    }
+    col_index_.resize(kept);
+    values_.resize(kept);
+}
+
+// ========== KERNELS ==========
+
+void SparseMatrix::multiplyRows(const double* x, double* y) const {
+    const size_t* row_ptr = row_ptr_.data();
+    const size_t* col_index = col_index_.data();
+    const double* values = values_.data();
+    forEachRowRange(row_ptr_, nonZeros(), [=](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            double sum = 0.0;
+            for (size_t k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
+                sum += values[k] * x[col_index[k]];
+            }
+            y[i] = sum;
+        }
+    });
+}
+
+void multiply_into(const SparseMatrix& a, const std::vector<double>& x,
+                   std::vector<double>& y) {
+    if (a.num_cols_ != x.size()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    if (&x == &y) {
+        std::vector<double> copy(x);
+        multiply_into(a, copy, y);
+        return;
+    }
+    y.resize(a.num_rows_);
+    a.multiplyRows(x.data(), y.data());
+}
+
+void multiply_into(const SparseMatrix& a, const Vector& x, Vector& y) {
+    if (a.num_cols_ != x.size()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    if (&x == &y) {
+        Vector copy(x);
+        multiply_into(a, copy, y);
+        return;
+    }
+    if (y.size() != a.num_rows_) {
+        y.resize(a.num_rows_);
+    }
+    a.multiplyRows(x.data(), y.data());
+}
+
+void multiply_into(const SparseMatrix& a, ConstMatrixView b, Matrix& out) {
+    if (a.num_cols_ != b.rows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    MatrixSpan out_span{out.data(), out.rows(), out.cols(), out.cols(), 1};
+    if (b.span().overlaps(out_span)) {
+        Matrix result;
+        multiply_into(a, b, result);
+        out = std::move(result);
+        return;
+    }
+    if (out.rows() != a.num_rows_ || out.cols() != b.cols()) {
+        out = Matrix(a.num_rows_, b.cols());
+    }
+
+    // Row i of the result is a combination of the rows of B picked out by
+    // row i of A, so every inner loop runs along a row of B and of out
+    size_t n = b.cols();
+    const size_t* row_ptr = a.row_ptr_.data();
+    const size_t* col_index = a.col_index_.data();
+    const double* values = a.values_.data();
+    const double* bp = b.data();
+    size_t rs = b.rowStride();
+    size_t cs = b.colStride();
+    double* cp = out.data();
+    forEachRowRange(a.row_ptr_, a.nonZeros() * n, [=](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            double* c_row = cp + i * n;
+            std::fill(c_row, c_row + n, 0.0);
+            for (size_t k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
+                double a_ik = values[k];
+                const double* b_row = bp + col_index[k] * rs;
+                for (size_t j = 0; j < n; ++j) {
+                    c_row[j] += a_ik * b_row[j * cs];
+                }
+            }
+        }
+    });
+}
+
+// ========== STREAM OPERATORS ==========
+
+std::ostream& operator<<(std::ostream& os, const SparseMatrix& m) {
+    os << "{";
+    for (size_t i = 0; i < m.num_rows_; ++i) {
+        for (size_t k = m.row_ptr_[i]; k < m.row_ptr_[i + 1]; ++k) {
+            if (k > 0) os << ", ";
+            os << "(" << i << ", " << m.col_index_[k] << "): " << m.values_[k];
+        }
+    }
+    os << "}";
+    return os;
+}
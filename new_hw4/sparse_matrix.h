@@ -0,0 +1,138 @@
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include <vector>
+#include <cstddef>
+#include <iostream>
+#include "matrix.h"
+#include "vector.h"
+
+// Sparse matrix in compressed sparse row (CSR) form.
+//
+// Only nonzero entries are stored: the entries of row i are
+// values()[rowPointers()[i] .. rowPointers()[i + 1]), at the columns given
+// by columnIndices() over the same range. Column indices within a row are
+// strictly increasing. Memory is proportional to the number of nonzeros,
+// so systems with millions of rows fit as long as each row is short.
+//
+// Products with dense vectors and matrices split the rows into ranges of
+// roughly equal nonzero count and run them on the kernels thread pool.
+class SparseMatrix {
+private:
+    size_t num_rows_;
+    size_t num_cols_;
+    std::vector<size_t> row_ptr_;
+    std::vector<size_t> col_index_;
+    std::vector<double> values_;
+
+    static constexpr double EPSILON = 1e-9;
+
+    // Element-wise this + scale * other over the union of both patterns
+    SparseMatrix combine(const SparseMatrix& other, double scale) const;
+
+    // y = A * x on raw arrays of cols() and rows() elements (no overlap)
+    void multiplyRows(const double* x, double* y) const;
+
+public:
+    // Products doing fewer multiply-adds than this stay on the calling thread
+    static constexpr size_t SPARSE_PARALLEL_THRESHOLD = 1 << 15;
+
+    // One (row, col, value) entry, for building a matrix from a list
+    struct Triplet {
+        size_t row;
+        size_t col;
+        double value;
+    };
+
+    // ========== CONSTRUCTORS ==========
+
+    // Empty 0x0 matrix
+    SparseMatrix();
+
+    // All-zero rows x cols matrix
+    SparseMatrix(size_t rows, size_t cols);
+
+    // Adopt CSR arrays directly. Throws std::invalid_argument if they are
+    // not a valid CSR structure for a rows x cols matrix.
+    SparseMatrix(size_t rows, size_t cols, std::vector<size_t> row_ptr,
+                 std::vector<size_t> col_index, std::vector<double> values);
+
+    // Build from entries in any order; duplicate entries are summed
+    static SparseMatrix fromTriplets(size_t rows, size_t cols,
+                                     const std::vector<Triplet>& triplets);
+
+    // Keep the entries of a dense matrix whose magnitude exceeds tolerance,
+    // and every NaN
+    static SparseMatrix fromDense(const Matrix& dense, double tolerance = 0.0);
+
+    static SparseMatrix identity(size_t n);
+
+    // ========== CONVERSION ==========
+
+    Matrix toDense() const;
+
+    // ========== ELEMENT ACCESS ==========
+
+    // Value at (row, col), zero if not stored
+    double operator()(size_t row, size_t col) const;
+
+    // Same with bounds checking (throw std::out_of_range)
+    double at(size_t row, size_t col) const;
+
+    // ========== SIZE AND STORAGE ==========
+
+    size_t rows() const { return num_rows_; }
+    size_t cols() const { return num_cols_; }
+    size_t nonZeros() const { return values_.size(); }
+    bool isEmpty() const { return num_rows_ == 0 || num_cols_ == 0; }
+
+    const std::vector<size_t>& rowPointers() const { return row_ptr_; }
+    const std::vector<size_t>& columnIndices() const { return col_index_; }
+    const std::vector<double>& values() const { return values_; }
+
+    // ========== ARITHMETIC OPERATORS ==========
+
+    SparseMatrix operator+(const SparseMatrix& other) const;
+    SparseMatrix operator-(const SparseMatrix& other) const;
+    SparseMatrix operator*(double scalar) const;
+    friend SparseMatrix operator*(double scalar, const SparseMatrix& m);
+    SparseMatrix operator-() const;
+
+    // Sparse x dense vector (SpMV)
+    std::vector<double> operator*(const std::vector<double>& x) const;
+
+    // Sparse x dense matrix (SpMM)
+    Matrix operator*(ConstMatrixView dense) const;
+
+    // ========== COMPARISON OPERATORS ==========
+
+    // Same shape and every element within EPSILON (entries stored in only
+    // one of the two are compared against zero)
+    bool operator==(const SparseMatrix& other) const;
+    bool operator!=(const SparseMatrix& other) const;
+
+    // ========== OPERATIONS ==========
+
+    SparseMatrix transpose() const;
+
+    // Drop stored entries whose magnitude is at most tolerance; NaN
+    // entries are kept
+    void prune(double tolerance = 0.0);
+
+    // ========== KERNELS ==========
+
+    // y = A * x, reusing y's storage
+    friend void multiply_into(const SparseMatrix& a, const std::vector<double>& x,
+                              std::vector<double>& y);
+    friend void multiply_into(const SparseMatrix& a, const Vector& x, Vector& y);
+
+    // out = A * B, reusing out's storage when it already has the right shape
+    friend void multiply_into(const SparseMatrix& a, ConstMatrixView b, Matrix& out);
+
+    // ========== STREAM OPERATORS ==========
+
+    // Prints the stored entries as {(row, col): value, ...}
+    friend std::ostream& operator<<(std::ostream& os, const SparseMatrix& m);
+};
+
+#endif // SPARSE_MATRIX_H
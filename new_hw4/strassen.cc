@@ -0,0 +1,247 @@
+#include "strassen.h"
+#include "gemm.h"
+#include "elementwise.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace kernels {
+
+namespace {
+
+std::atomic<size_t> g_strassen_threshold(STRASSEN_DEFAULT_THRESHOLD);
+
+// ========== BLOCK HELPERS ==========
+
+// C = A + B over m x n blocks (C may be A or B)
+void blockAdd(size_t m, size_t n, const double* A, size_t lda,
+              const double* B, size_t ldb, double* C, size_t ldc) {
+    for (size_t i = 0; i < m; ++i) {
+        add(n, A + i * lda, B + i * ldb, C + i * ldc);
+    }
+}
+
+// C = A - B over m x n blocks (C may be A or B)
+void blockSubtract(size_t m, size_t n, const double* A, size_t lda,
+                   const double* B, size_t ldb, double* C, size_t ldc) {
+    for (size_t i = 0; i < m; ++i) {
+        subtract(n, A + i * lda, B + i * ldb, C + i * ldc);
+    }
+}
+
+// C = A * B with the classical kernel
+void classical(size_t m, size_t n, size_t k, const double* A, size_t lda,
+               const double* B, size_t ldb, double* C, size_t ldc) {
+    for (size_t i = 0; i < m; ++i) {
+        fill(n, 0.0, C + i * ldc);
+    }
+    gemm(m, n, k, 1.0, A, lda, 1, B, ldb, 1, C, ldc);
+}
+
+bool recurses(size_t m, size_t n, size_t k, size_t crossover) {
+    return std::min({m, n, k}) > crossover;
+}
+
+// Doubles of workspace the serial recursion needs for an m x n x k
+// product: two half-size temporaries per level
+size_t workspaceSize(size_t m, size_t n, size_t k, size_t crossover) {
+    if (!recurses(m, n, k, crossover)) {
+        return 0;
+    }
+    size_t m2 = m / 2, n2 = n / 2, k2 = k / 2;
+    return m2 * std::max(k2, n2) + k2 * n2 + workspaceSize(m2, n2, k2, crossover);
+}
+
+// The recursion covers the even-sized leading part; add in the last
+// column of A times the last row of B (odd k) and compute the last
+// column (odd n) and last row (odd m) of C directly
+void fixOddEdges(size_t m, size_t n, size_t k, const double* A, size_t lda,
+                 const double* B, size_t ldb, double* C, size_t ldc) {
+    size_t me = m & ~size_t(1), ne = n & ~size_t(1), ke = k & ~size_t(1);
+    if (k != ke) {
+        gemm(me, ne, 1, 1.0, A + ke, lda, 1, B + ke * ldb, ldb, 1, C, ldc);
+    }
+    if (n != ne) {
+        classical(m, 1, k, A, lda, B + ne, ldb, C + ne, ldc);
+    }
+    if (m != me) {
+        classical(1, ne, k, A + me * lda, lda, B, ldb, C + me * ldc, ldc);
+    }
+}
+
+// ========== SERIAL RECURSION ==========
+
+// C = A * B using the two-temporary Strassen-Winograd schedule of Boyer,
+// Dumas, Pernet and Zhou: X holds the A-side sums (and P1), Y the B-side
+// sums, and the other products are formed in the quadrants of C
+void multiplySerial(size_t m, size_t n, size_t k, const double* A, size_t lda,
+                    const double* B, size_t ldb, double* C, size_t ldc, double* work,
+                    size_t crossover) {
+    if (!recurses(m, n, k, crossover)) {
+        classical(m, n, k, A, lda, B, ldb, C, ldc);
+        return;
+    }
+
+    size_t m2 = m / 2, n2 = n / 2, k2 = k / 2;
+    const double* A11 = A;
+    const double* A12 = A + k2;
+    const double* A21 = A + m2 * lda;
+    const double* A22 = A21 + k2;
+    const double* B11 = B;
+    const double* B12 = B + n2;
+    const double* B21 = B + k2 * ldb;
+    const double* B22 = B21 + n2;
+    double* C11 = C;
+    double* C12 = C + n2;
+    double* C21 = C + m2 * ldc;
+    double* C22 = C21 + n2;
+
+    size_t ldx = std::max(k2, n2);
+    size_t ldy = n2;
+    double* X = work;
+    double* Y = X + m2 * ldx;
+    double* rest = Y + k2 * ldy;
+
+    blockSubtract(m2, k2, A11, lda, A21, lda, X, ldx);                          // S3
+    blockSubtract(k2, n2, B22, ldb, B12, ldb, Y, ldy);                          // T3
+    multiplySerial(m2, n2, k2, X, ldx, Y, ldy, C21, ldc, rest, crossover);      // P7
+    blockAdd(m2, k2, A21, lda, A22, lda, X, ldx);                               // S1
+    blockSubtract(k2, n2, B12, ldb, B11, ldb, Y, ldy);                          // T1
+    multiplySerial(m2, n2, k2, X, ldx, Y, ldy, C22, ldc, rest, crossover);      // P5
+    blockSubtract(m2, k2, X, ldx, A11, lda, X, ldx);                            // S2
+    blockSubtract(k2, n2, B22, ldb, Y, ldy, Y, ldy);                            // T2
+    multiplySerial(m2, n2, k2, X, ldx, Y, ldy, C12, ldc, rest, crossover);      // P6
+    blockSubtract(m2, k2, A12, lda, X, ldx, X, ldx);                            // S4
+    multiplySerial(m2, n2, k2, X, ldx, B22, ldb, C11, ldc, rest, crossover);    // P3
+    multiplySerial(m2, n2, k2, A11, lda, B11, ldb, X, ldx, rest, crossover);    // P1
+    blockAdd(m2, n2, X, ldx, C12, ldc, C12, ldc);                               // U2 = P1 + P6
+    blockAdd(m2, n2, C12, ldc, C21, ldc, C21, ldc);                             // U3 = U2 + P7
+    blockAdd(m2, n2, C12, ldc, C22, ldc, C12, ldc);                             // U4 = U2 + P5
+    blockAdd(m2, n2, C21, ldc, C22, ldc, C22, ldc);                             // U7 = U3 + P5
+    blockAdd(m2, n2, C12, ldc, C11, ldc, C12, ldc);                             // U5 = U4 + P3
+    blockSubtract(k2, n2, Y, ldy, B21, ldb, Y, ldy);                            // T4
+    multiplySerial(m2, n2, k2, A22, lda, Y, ldy, C11, ldc, rest, crossover);    // P4
+    blockSubtract(m2, n2, C21, ldc, C11, ldc, C21, ldc);                        // U6 = U3 - P4
+    multiplySerial(m2, n2, k2, A12, lda, B21, ldb, C11, ldc, rest, crossover);  // P2
+    blockAdd(m2, n2, X, ldx, C11, ldc, C11, ldc);                               // U1 = P1 + P2
+
+    fixOddEdges(m, n, k, A, lda, B, ldb, C, ldc);
+}
+
+// ========== PARALLEL TOP LEVEL ==========
+
+// One level with all seven products in flight at once. Every product
+// needs its own operands and output, so this level keeps all eight sums
+// and three extra products live; each task then recurses serially in its
+// own slice of the workspace.
+void multiplyParallel(size_t m, size_t n, size_t k, const double* A, size_t lda,
+                      const double* B, size_t ldb, double* C, size_t ldc,
+                      size_t crossover) {
+    size_t m2 = m / 2, n2 = n / 2, k2 = k / 2;
+    const double* A11 = A;
+    const double* A12 = A + k2;
+    const double* A21 = A + m2 * lda;
+    const double* A22 = A21 + k2;
+    const double* B11 = B;
+    const double* B12 = B + n2;
+    const double* B21 = B + k2 * ldb;
+    const double* B22 = B21 + n2;
+    double* C11 = C;
+    double* C12 = C + n2;
+    double* C21 = C + m2 * ldc;
+    double* C22 = C21 + n2;
+
+    size_t a_size = m2 * k2, b_size = k2 * n2, c_size = m2 * n2;
+    size_t task_work = workspaceSize(m2, n2, k2, crossover);
+    std::unique_ptr<double[]> workspace(
+        new double[4 * a_size + 4 * b_size + 3 * c_size + 7 * task_work]);
+    double* S1 = workspace.get();
+    double* S2 = S1 + a_size;
+    double* S3 = S2 + a_size;
+    double* S4 = S3 + a_size;
+    double* T1 = S4 + a_size;
+    double* T2 = T1 + b_size;
+    double* T3 = T2 + b_size;
+    double* T4 = T3 + b_size;
+    double* P1 = T4 + b_size;
+    double* P5 = P1 + c_size;
+    double* P6 = P5 + c_size;
+    double* task_space = P6 + c_size;
+
+    blockAdd(m2, k2, A21, lda, A22, lda, S1, k2);
+    blockSubtract(m2, k2, S1, k2, A11, lda, S2, k2);
+    blockSubtract(m2, k2, A11, lda, A21, lda, S3, k2);
+    blockSubtract(m2, k2, A12, lda, S2, k2, S4, k2);
+    blockSubtract(k2, n2, B12, ldb, B11, ldb, T1, n2);
+    blockSubtract(k2, n2, B22, ldb, T1, n2, T2, n2);
+    blockSubtract(k2, n2, B22, ldb, B12, ldb, T3, n2);
+    blockSubtract(k2, n2, T2, n2, B21, ldb, T4, n2);
+
+    struct Product {
+        const double* a;
+        size_t lda;
+        const double* b;
+        size_t ldb;
+        double* c;
+        size_t ldc;
+    };
+    const Product products[7] = {
+        {A11, lda, B11, ldb, P1, n2},   // P1
+        {A12, lda, B21, ldb, C11, ldc}, // P2
+        {S4, k2, B22, ldb, C12, ldc},   // P3
+        {A22, lda, T4, n2, C21, ldc},   // P4
+        {S1, k2, T1, n2, P5, n2},       // P5
+        {S2, k2, T2, n2, P6, n2},       // P6
+        {S3, k2, T3, n2, C22, ldc},     // P7
+    };
+    ThreadPool::global().parallelFor(7, [&](size_t t) {
+        const Product& p = products[t];
+        multiplySerial(m2, n2, k2, p.a, p.lda, p.b, p.ldb, p.c, p.ldc,
+                       task_space + t * task_work, crossover);
+    });
+
+    blockAdd(m2, n2, P1, n2, P6, n2, P6, n2);      // U2 = P1 + P6
+    blockAdd(m2, n2, C11, ldc, P1, n2, C11, ldc);  // C11 = P2 + P1
+    blockAdd(m2, n2, C12, ldc, P6, n2, C12, ldc);
+    blockAdd(m2, n2, C12, ldc, P5, n2, C12, ldc);  // C12 = P3 + U2 + P5
+    blockSubtract(m2, n2, C22, ldc, C21, ldc, C21, ldc);
+    blockAdd(m2, n2, C21, ldc, P6, n2, C21, ldc);  // C21 = P7 - P4 + U2
+    blockAdd(m2, n2, C22, ldc, P6, n2, C22, ldc);
+    blockAdd(m2, n2, C22, ldc, P5, n2, C22, ldc);  // C22 = P7 + U2 + P5
+
+    fixOddEdges(m, n, k, A, lda, B, ldb, C, ldc);
+}
+
+} // namespace
+
+// ========== STRASSEN CONFIGURATION ==========
+
+void setStrassenThreshold(size_t min_dimension) {
+    g_strassen_threshold.store(min_dimension);
+}
+
+size_t strassenThreshold() {
+    return g_strassen_threshold.load();
+}
+
+bool useStrassen(size_t m, size_t n, size_t k) {
+    size_t threshold = strassenThreshold();
+    return threshold != 0 && std::min({m, n, k}) >= threshold;
+}
+
+// ========== STRASSEN ENTRY POINT ==========
+
+void strassen(size_t m, size_t n, size_t k,
+              const double* A, size_t lda,
+              const double* B, size_t ldb,
+              double* C, size_t ldc, size_t crossover) {
+    if (recurses(m, n, k, crossover) && numThreads() > 1) {
+        multiplyParallel(m, n, k, A, lda, B, ldb, C, ldc, crossover);
+        return;
+    }
+    std::unique_ptr<double[]> workspace(new double[workspaceSize(m, n, k, crossover)]);
+    multiplySerial(m, n, k, A, lda, B, ldb, C, ldc, workspace.get(), crossover);
+}
+
+} // namespace kernels
@@ -0,0 +1,55 @@
+#ifndef STRASSEN_H
+#define STRASSEN_H
+
+#include <cstddef>
+
+namespace kernels {
+
+// ========== STRASSEN PARAMETERS ==========
+
+// Default crossover: sub-products with any dimension at or below it go to
+// the GEMM kernel. One level trades an eighth of the multiplications for
+// 15 block additions; measured single-threaded, 512 gives ~25% over plain
+// GEMM at n = 4096, while 256 adds little speed but more rounding error.
+constexpr size_t STRASSEN_CROSSOVER = 512;
+
+// Default smallest dimension from which Matrix products take the
+// Strassen path: 0, i.e. off. Its top level runs only seven products in
+// parallel (each recursing serially) and allocates about 2 GB of
+// workspace at n = 8192, so with more than a few threads the threaded
+// GEMM is faster; enable it with setStrassenThreshold() after measuring
+// (see BM_StrassenThreads).
+constexpr size_t STRASSEN_DEFAULT_THRESHOLD = 0;
+
+// ========== STRASSEN CONFIGURATION ==========
+
+// Matrix products whose m, n and k are all at least the threshold use
+// strassen() instead of gemm(); 0 disables the Strassen path. The result
+// differs from the classical product by rounding: the error bound grows
+// by a small constant factor per recursion level.
+void setStrassenThreshold(size_t min_dimension);
+size_t strassenThreshold();
+
+// True if an m x n x k product is large enough for the Strassen path
+bool useStrassen(size_t m, size_t n, size_t k);
+
+// ========== STRASSEN ENTRY POINT ==========
+
+// C (m x n) = A (m x k) * B (k x n) with the Strassen-Winograd algorithm
+// (7 half-size products and 15 block additions per level). All three are
+// row-major with leading dimensions lda, ldb, ldc, and C must not overlap
+// A or B. Odd dimensions are handled by peeling off the last row or column.
+//
+// The whole recursion works in one workspace allocated up front. With
+// more than one thread the seven top-level products run in parallel on
+// the global pool, each recursing serially, so at most seven threads
+// are used.
+void strassen(size_t m, size_t n, size_t k,
+              const double* A, size_t lda,
+              const double* B, size_t ldb,
+              double* C, size_t ldc,
+              size_t crossover = STRASSEN_CROSSOVER);
+
+} // namespace kernels
+
+#endif // STRASSEN_H
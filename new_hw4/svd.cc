@@ -0,0 +1,324 @@
+#include "svd.h"
+#include "qr.h"
+#include "elementwise.h"
+#include "thread_pool.h"
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <numeric>
+#include <limits>
+#include <stdexcept>
+
+using kernels::ThreadPool;
+
+namespace {
+
+// Below this many columns a sweep runs on the calling thread
+constexpr size_t JACOBI_PARALLEL_COLUMNS = 128;
+
+// Cache budget for the rows of two column blocks (of g and vt) rotated
+// against each other; sets the block size
+constexpr size_t JACOBI_CACHE_BYTES = 1 << 20;
+
+size_t ceilDiv(size_t value, size_t divisor) {
+    return (value + divisor - 1) / divisor;
+}
+
+// Exponent e with max |a| = f * 2^e, f in [0.5, 1), after dividing a by
+// 2^e (exact, being a power of two). Working on entries of magnitude at
+// most 1 keeps the squared norms from overflowing or underflowing.
+// Returns 0 and leaves a unchanged if it is zero or not finite.
+int normalizeScale(Matrix& a) {
+    size_t count = a.rows() * a.cols();
+    double lo, hi;
+    kernels::minMax(count, a.data(), &lo, &hi);
+    double largest = std::max(std::abs(lo), std::abs(hi));
+    if (count == 0 || largest == 0.0 || !std::isfinite(largest)) {
+        return 0;
+    }
+    int exponent;
+    std::frexp(largest, &exponent);
+    double* data = a.data();
+    for (size_t i = 0; i < count; ++i) {
+        data[i] = std::ldexp(data[i], -exponent);
+    }
+    return exponent;
+}
+
+// Working state of the sweeps: rows of g are the columns being
+// orthogonalized, rows of vt accumulate the rotations, and norms caches
+// the squared row norms of g
+struct JacobiState {
+    Matrix& g;
+    Matrix& vt;
+    std::vector<double> norms;
+    double tol;
+};
+
+// Orthogonalize rows p and q of g, applying the same rotation to rows p
+// and q of vt. Returns false if they were already orthogonal to within tol.
+bool rotatePair(JacobiState& state, size_t p, size_t q) {
+    size_t n = state.g.cols();
+    double* gp = state.g.data() + p * n;
+    double* gq = state.g.data() + q * n;
+    double alpha = state.norms[p];
+    double beta = state.norms[q];
+    double gamma = kernels::dot(n, gp, gq);
+    if (std::abs(gamma) <= state.tol * std::sqrt(alpha) * std::sqrt(beta)) {
+        return false;
+    }
+
+    // The smaller root t = tan(theta) of t^2 + 2 zeta t - 1 = 0 zeroes the
+    // rotated pair's inner product
+    double zeta = (beta - alpha) / (2.0 * gamma);
+    double t = std::copysign(1.0, zeta) / (std::abs(zeta) + std::hypot(1.0, zeta));
+    double c = 1.0 / std::sqrt(1.0 + t * t);
+    double s = c * t;
+
+    for (size_t k = 0; k < n; ++k) {
+        double x = gp[k], y = gq[k];
+        gp[k] = c * x - s * y;
+        gq[k] = s * x + c * y;
+    }
+    double* vp = state.vt.data() + p * n;
+    double* vq = state.vt.data() + q * n;
+    for (size_t k = 0; k < n; ++k) {
+        double x = vp[k], y = vq[k];
+        vp[k] = c * x - s * y;
+        vq[k] = s * x + c * y;
+    }
+
+    // The rotation moves t * gamma between the two squared norms; recompute
+    // a norm that shrank so much that the update lost its accuracy
+    double new_alpha = alpha - t * gamma;
+    double new_beta = beta + t * gamma;
+    state.norms[p] = new_alpha < 0.125 * alpha ? kernels::dot(n, gp, gp) : new_alpha;
+    state.norms[q] = new_beta < 0.125 * beta ? kernels::dot(n, gq, gq) : new_beta;
+    return true;
+}
+
+// Cyclic one-sided Jacobi on the rows of g until every pair is orthogonal.
+// The rows are split into blocks small enough that two of them stay in
+// cache; a sweep first rotates the pairs inside each block, then every
+// pair of blocks in round-robin (tournament) order. The blocks paired in
+// one round are disjoint, so they are rotated in parallel.
+void jacobiSweeps(Matrix& g, Matrix& vt) {
+    size_t n = g.rows();
+    JacobiState state{g, vt, std::vector<double>(n),
+                      std::numeric_limits<double>::epsilon() * static_cast<double>(n)};
+    bool parallel = n >= JACOBI_PARALLEL_COLUMNS && kernels::numThreads() > 1;
+
+    size_t block = std::clamp<size_t>(JACOBI_CACHE_BYTES / (4 * n * sizeof(double)), 4, 64);
+    size_t blocks = ceilDiv(n, block);
+    auto blockEnd = [&](size_t b) { return std::min(n, (b + 1) * block); };
+
+    // An odd count gets a dummy block that sits each round out
+    size_t players = blocks + (blocks % 2);
+    std::vector<size_t> order(players);
+    std::vector<std::pair<size_t, size_t>> pairs;
+    pairs.reserve(players / 2);
+
+    auto forEach = [&](size_t count, const std::function<void(size_t)>& task) {
+        if (parallel && count > 1) {
+            ThreadPool::global().parallelFor(count, task);
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                task(i);
+            }
+        }
+    };
+
+    for (int sweep = 0; sweep < SingularValueDecomposition::MAX_SWEEPS; ++sweep) {
+        // Fresh norms each sweep, so rounding in the updates cannot build up
+        for (size_t j = 0; j < n; ++j) {
+            state.norms[j] = kernels::dot(n, g.data() + j * n, g.data() + j * n);
+        }
+        std::atomic<size_t> rotations(0);
+
+        forEach(blocks, [&](size_t b) {
+            size_t count = 0;
+            for (size_t p = b * block; p < blockEnd(b); ++p) {
+                for (size_t q = p + 1; q < blockEnd(b); ++q) {
+                    count += rotatePair(state, p, q);
+                }
+            }
+            rotations.fetch_add(count, std::memory_order_relaxed);
+        });
+
+        std::iota(order.begin(), order.end(), 0);
+        for (size_t round = 0; round + 1 < players; ++round) {
+            pairs.clear();
+            for (size_t i = 0; i < players / 2; ++i) {
+                size_t a = order[i], b = order[players - 1 - i];
+                if (a < blocks && b < blocks) {
+                    pairs.emplace_back(a, b);
+                }
+            }
+            forEach(pairs.size(), [&](size_t i) {
+                size_t a = pairs[i].first, b = pairs[i].second;
+                size_t count = 0;
+                for (size_t p = a * block; p < blockEnd(a); ++p) {
+                    for (size_t q = b * block; q < blockEnd(b); ++q) {
+                        count += rotatePair(state, std::min(p, q), std::max(p, q));
+                    }
+                }
+                rotations.fetch_add(count, std::memory_order_relaxed);
+            });
+
+            // Keep player 0 fixed and rotate the others one place
+            std::rotate(order.begin() + 1, order.end() - 1, order.end());
+        }
+        if (rotations.load() == 0) {
+            return;
+        }
+    }
+    throw std::runtime_error("Singular value iteration did not converge");
+}
+
+// Replace the columns of u listed in missing (zero singular values) with
+// unit vectors orthogonal to all other columns, by Gram-Schmidt on the
+// coordinate vectors
+void completeBasis(Matrix& u, const std::vector<size_t>& missing) {
+    size_t n = u.rows();
+    std::vector<bool> filled(u.cols(), true);
+    for (size_t k : missing) {
+        filled[k] = false;
+    }
+    std::vector<double> x(n);
+    for (size_t k : missing) {
+        for (size_t candidate = 0; candidate < n; ++candidate) {
+            std::fill(x.begin(), x.end(), 0.0);
+            x[candidate] = 1.0;
+            // Two passes of Gram-Schmidt keep x orthogonal to working precision
+            for (int pass = 0; pass < 2; ++pass) {
+                for (size_t f = 0; f < u.cols(); ++f) {
+                    if (!filled[f]) {
+                        continue;
+                    }
+                    double projection = 0.0;
+                    for (size_t i = 0; i < n; ++i) {
+                        projection += u(i, f) * x[i];
+                    }
+                    for (size_t i = 0; i < n; ++i) {
+                        x[i] -= projection * u(i, f);
+                    }
+                }
+            }
+            double norm = kernels::nrm2(n, x.data());
+            if (norm > 0.5) {
+                for (size_t i = 0; i < n; ++i) {
+                    u(i, k) = x[i] / norm;
+                }
+                filled[k] = true;
+                break;
+            }
+        }
+    }
+}
+
+} // namespace
+
+// ========== DECOMPOSITION ==========
+
+SingularValueDecomposition::SingularValueDecomposition(const Matrix& a)
+    : rows_(a.rows()), cols_(a.cols()) {
+    compute(a);
+}
+
+void SingularValueDecomposition::compute(const Matrix& a) {
+    // Work on the tall orientation, B = A or A^T (M x N with M >= N)
+    bool wide = a.rows() < a.cols();
+    Matrix b = wide ? a.transpose() : a;
+    size_t n = b.cols();
+    if (n == 0) {
+        u_ = Matrix(rows_, 0);
+        v_ = Matrix(cols_, 0);
+        return;
+    }
+    int exponent = normalizeScale(b);
+
+    // B = Q * R, and Jacobi runs on the columns of R^T, i.e. the rows of
+    // R (Drmac and Veselic: R^T is much closer to orthogonal columns than
+    // B, so far fewer sweeps are needed). R^T * W = X * diag(s) then gives
+    // B = (Q * W) * diag(s) * X^T.
+    QRDecomposition qr(std::move(b));
+    Matrix g = qr.r();
+    Matrix vt = Matrix::identity(n);
+    jacobiSweeps(g, vt);
+
+    // Column norms are the singular values; sort them descending
+    std::vector<double> sigma(n);
+    for (size_t j = 0; j < n; ++j) {
+        sigma[j] = kernels::nrm2(n, g.data() + j * n);
+    }
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t i, size_t j) { return sigma[i] > sigma[j]; });
+
+    singular_values_.resize(n);
+    Matrix left(n, n);
+    Matrix right(n, n);
+    std::vector<size_t> missing;
+    for (size_t k = 0; k < n; ++k) {
+        size_t j = order[k];
+        singular_values_[k] = std::ldexp(sigma[j], exponent);
+        const double* g_j = g.data() + j * n;
+        const double* v_j = vt.data() + j * n;
+        bool zero = sigma[j] < std::numeric_limits<double>::min();
+        if (zero) {
+            missing.push_back(k);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            left(i, k) = zero ? 0.0 : g_j[i] / sigma[j];
+            right(i, k) = v_j[i];
+        }
+    }
+    completeBasis(left, missing);
+
+    // left holds X (right singular vectors of B), right holds W
+    Matrix u = qr.q() * right;
+    if (wide) {
+        u_ = std::move(left);
+        v_ = std::move(u);
+    } else {
+        u_ = std::move(u);
+        v_ = std::move(left);
+    }
+}
+
+// ========== RESULTS ==========
+
+const std::vector<double>& SingularValueDecomposition::singularValues() const {
+    return singular_values_;
+}
+
+const Matrix& SingularValueDecomposition::u() const {
+    return u_;
+}
+
+const Matrix& SingularValueDecomposition::v() const {
+    return v_;
+}
+
+size_t SingularValueDecomposition::rank() const {
+    if (singular_values_.empty()) {
+        return 0;
+    }
+    double tol = static_cast<double>(std::max(rows_, cols_)) *
+                 std::numeric_limits<double>::epsilon() * singular_values_[0];
+    size_t rank = 0;
+    while (rank < singular_values_.size() && singular_values_[rank] > tol) {
+        ++rank;
+    }
+    return rank;
+}
+
+size_t SingularValueDecomposition::rows() const {
+    return rows_;
+}
+
+size_t SingularValueDecomposition::cols() const {
+    return cols_;
+}
@@ -0,0 +1,49 @@
+#ifndef SVD_H
+#define SVD_H
+
+#include <vector>
+#include <cstddef>
+#include "matrix.h"
+
+// Thin singular value decomposition: A = U * diag(s) * V^T for an m x n
+// matrix A, with k = min(m, n) singular values.
+//
+// Computed by one-sided (Hestenes) Jacobi, which finds small singular
+// values to high relative accuracy. A (or A^T, if A is wide) is first
+// factored by the blocked QR decomposition and the Jacobi sweeps run on
+// R^T: they work on k x k data however tall A is, and R^T needs far fewer
+// sweeps than A itself. Each sweep orthogonalizes every pair of columns
+// once, in round-robin order: the k / 2 pairs of a round are disjoint and
+// are rotated in parallel on the global thread pool.
+class SingularValueDecomposition {
+private:
+    std::vector<double> singular_values_;
+    Matrix u_;
+    Matrix v_;
+    size_t rows_;
+    size_t cols_;
+
+    void compute(const Matrix& a);
+
+public:
+    // Sweeps allowed before giving up (std::runtime_error)
+    static constexpr int MAX_SWEEPS = 60;
+
+    explicit SingularValueDecomposition(const Matrix& a);
+
+    // Singular values in descending order
+    const std::vector<double>& singularValues() const;
+
+    // Left singular vectors (m x k) and right singular vectors (n x k) as
+    // orthonormal columns, column j belonging to singularValues()[j]
+    const Matrix& u() const;
+    const Matrix& v() const;
+
+    // Number of singular values above max(m, n) * eps * s[0]
+    size_t rank() const;
+
+    size_t rows() const;
+    size_t cols() const;
+};
+
+#endif // SVD_H
@@ -0,0 +1,166 @@
+#include "thread_pool.h"
+#include <memory>
+#include <algorithm>
+
+namespace kernels {
+
+namespace {
+
+// Set while a thread is executing pool tasks, so nested parallelFor
+// calls run inline instead of deadlocking on the busy pool
+thread_local bool t_inside_pool = false;
+
+std::mutex g_pool_mutex;
+std::unique_ptr<ThreadPool> g_pool;
+
+size_t defaultThreadCount() {
+    size_t hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 1 : hw;
+}
+
+} // namespace
+
+// ========== CONSTRUCTORS & DESTRUCTOR ==========
+
+ThreadPool::ThreadPool(size_t num_threads)
+    : task_(nullptr), task_count_(0), next_index_(0), active_workers_(0),
+      generation_(0), stopping_(false) {
+    size_t num_workers = std::max<size_t>(num_threads, 1) - 1;
+    workers_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+// ========== JOB EXECUTION ==========
+
+size_t ThreadPool::size() const {
+    return workers_.size() + 1;
+}
+
+void ThreadPool::drain(const std::function<void(size_t)>& task, size_t count) {
+    bool was_inside = t_inside_pool;
+    t_inside_pool = true;
+    for (size_t i = next_index_.fetch_add(1); i < count; i = next_index_.fetch_add(1)) {
+        try {
+            task(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+            // Skip the remaining indices; the job is failing anyway
+            next_index_.store(count);
+        }
+    }
+    t_inside_pool = was_inside;
+}
+
+void ThreadPool::workerLoop() {
+    size_t seen_generation = 0;
+    while (true) {
+        const std::function<void(size_t)>* task;
+        size_t count;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+            if (task_ == nullptr) {
+                // Woke up after the job had already been finished by others
+                continue;
+            }
+            task = task_;
+            count = task_count_;
+            ++active_workers_;
+        }
+
+        drain(*task, count);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --active_workers_;
+        }
+        done_.notify_one();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+    if (workers_.empty() || count == 1 || t_inside_pool) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit_lock(submit_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        task_count_ = count;
+        next_index_.store(0);
+        error_ = nullptr;
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    // The caller works on the job too instead of sleeping
+    drain(task, count);
+
+    std::exception_ptr error;
+    {
+        // Workers that woke up late find no indices left and leave quickly;
+        // wait for every worker that picked up this job to let go of it
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&] { return active_workers_ == 0; });
+        task_ = nullptr;
+        error = error_;
+        error_ = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// ========== GLOBAL POOL ==========
+
+ThreadPool& ThreadPool::global() {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    if (!g_pool) {
+        g_pool = std::make_unique<ThreadPool>(defaultThreadCount());
+    }
+    return *g_pool;
+}
+
+void setNumThreads(size_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = defaultThreadCount();
+    }
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    if (!g_pool || g_pool->size() != num_threads) {
+        g_pool.reset();
+        g_pool = std::make_unique<ThreadPool>(num_threads);
+    }
+}
+
+size_t numThreads() {
+    return ThreadPool::global().size();
+}
+
+} // namespace kernels
@@ -0,0 +1,74 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <cstddef>
+
+namespace kernels {
+
+// Persistent pool of worker threads for data-parallel kernels.
+// Workers are started once and sleep between jobs, so a parallel kernel
+// costs a wake-up rather than a thread spawn.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers_;
+
+    // Serializes jobs submitted from different user threads
+    std::mutex submit_mutex_;
+
+    // Protects the job description below
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    const std::function<void(size_t)>* task_;
+    size_t task_count_;
+    std::atomic<size_t> next_index_;
+    size_t active_workers_;
+    size_t generation_;
+    bool stopping_;
+    std::exception_ptr error_;
+
+    void workerLoop();
+
+    // Claim and run task indices until none are left
+    void drain(const std::function<void(size_t)>& task, size_t count);
+
+public:
+    // Start a pool that runs jobs on num_threads threads in total; the
+    // calling thread counts as one of them, so num_threads - 1 workers
+    // are spawned
+    explicit ThreadPool(size_t num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of threads that take part in a job (workers plus caller)
+    size_t size() const;
+
+    // Run task(i) for every i in [0, count) and block until all are done.
+    // The first exception thrown by a task is rethrown here. Calls made
+    // from inside a running task execute serially on the calling thread.
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+    // Process-wide pool shared by all kernels
+    static ThreadPool& global();
+};
+
+// Set the number of threads used by the global pool (0 = one per
+// hardware thread). Must not be called while a parallel kernel is running.
+void setNumThreads(size_t num_threads);
+
+// Number of threads the global pool runs jobs on
+size_t numThreads();
+
+} // namespace kernels
+
+#endif // THREAD_POOL_H
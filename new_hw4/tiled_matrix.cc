@@ -0,0 +1,831 @@
+#include "tiled_matrix.h"
+#include "aligned_allocator.h"
+#include "elementwise.h"
+#include "gemm.h"
+#include "transpose.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char TILED_MAGIC[4] = {'M', 'T', 'I', 'L'};
+
+// Temporary files get a process-wide sequence number
+std::atomic<size_t> temporary_count(0);
+
+std::string temporaryPath(const std::filesystem::path& directory) {
+    std::string name = "tiled-" + std::to_string(::getpid()) + "-" +
+                       std::to_string(temporary_count.fetch_add(1)) + ".mtil";
+    return (directory / name).string();
+}
+
+size_t ceilDiv(size_t value, size_t divisor) {
+    return (value + divisor - 1) / divisor;
+}
+
+// pread/pwrite of exactly bytes bytes at offset, retrying short transfers
+void readFully(int fd, void* buffer, size_t bytes, size_t offset, const std::string& path) {
+    char* out = static_cast<char*>(buffer);
+    while (bytes > 0) {
+        ssize_t got = ::pread(fd, out, bytes, static_cast<off_t>(offset));
+        if (got <= 0) {
+            throw std::runtime_error("Cannot read tiled matrix file: " + path);
+        }
+        out += got;
+        bytes -= static_cast<size_t>(got);
+        offset += static_cast<size_t>(got);
+    }
+}
+
+void writeFully(int fd, const void* buffer, size_t bytes, size_t offset,
+                const std::string& path) {
+    const char* in = static_cast<const char*>(buffer);
+    while (bytes > 0) {
+        ssize_t put = ::pwrite(fd, in, bytes, static_cast<off_t>(offset));
+        if (put <= 0) {
+            throw std::runtime_error("Cannot write tiled matrix file: " + path);
+        }
+        in += put;
+        bytes -= static_cast<size_t>(put);
+        offset += static_cast<size_t>(put);
+    }
+}
+
+} // namespace
+
+// ========== TILE STORE ==========
+
+// One cached tile. ready is false while it is being read from disk.
+struct Tile {
+    std::vector<double, AlignedAllocator<double>> data;
+    std::list<size_t>::iterator lru;
+    bool ready = false;
+    bool dirty = false;
+    bool failed = false;
+};
+
+// The file and its tile cache. A tile handed out by acquire() is pinned:
+// the cache holds one reference and every user another, and only tiles
+// nobody else holds are evicted. All cache state is guarded by mutex_;
+// tiles are read from disk outside it, so the prefetch thread and the
+// caller can load different tiles at the same time.
+class TileStore {
+public:
+    std::string path;
+    bool temporary;
+    size_t rows;
+    size_t cols;
+    size_t tile_size;
+    size_t tile_rows;
+    size_t tile_cols;
+    size_t budget;
+    bool prefetching;
+
+    TileStore(const std::string& path, bool temporary, int fd, size_t rows, size_t cols,
+              size_t tile_size, const TiledMatrixOptions& options);
+    ~TileStore();
+
+    size_t tileElements() const { return tile_size * tile_size; }
+    size_t tileBytes() const { return tileElements() * sizeof(double); }
+    size_t index(size_t tile_row, size_t tile_col) const {
+        return tile_row * tile_cols + tile_col;
+    }
+
+    // Trimmed extent of a tile row or column
+    size_t rowsIn(size_t tile_row) const {
+        return std::min(tile_size, rows - tile_row * tile_size);
+    }
+    size_t colsIn(size_t tile_col) const {
+        return std::min(tile_size, cols - tile_col * tile_size);
+    }
+
+    // Pin a tile, reading it unless overwrite is set (the caller then
+    // replaces its whole contents, so a fresh tile is left zero)
+    std::shared_ptr<Tile> acquire(size_t index, bool overwrite = false);
+
+    // Record that the caller changed a pinned tile
+    void markDirty(Tile& tile);
+
+    void prefetch(size_t index);
+    void flush();
+
+    size_t cachedBytes() const;
+    TileCacheStats stats() const;
+
+private:
+    int fd_;
+    mutable std::mutex mutex_;
+    std::condition_variable loaded_;
+    std::condition_variable queued_;
+    std::unordered_map<size_t, std::shared_ptr<Tile>> tiles_;
+    std::list<size_t> lru_; // most recently used first
+    size_t cached_bytes_;
+    TileCacheStats stats_;
+    std::deque<size_t> queue_;
+    bool stopping_;
+    std::thread worker_; // started on the first prefetch
+
+    size_t offset(size_t index) const {
+        return sizeof(TiledMatrixFileHeader) + index * tileBytes();
+    }
+
+    // Drop least recently used unpinned tiles, writing back dirty ones,
+    // until the cache fits the budget
+    void evict();
+
+    void runPrefetch();
+};
+
+TileStore::TileStore(const std::string& path, bool temporary, int fd, size_t rows,
+                     size_t cols, size_t tile_size, const TiledMatrixOptions& options)
+    : path(path), temporary(temporary), rows(rows), cols(cols), tile_size(tile_size),
+      tile_rows(ceilDiv(rows, tile_size)), tile_cols(ceilDiv(cols, tile_size)),
+      budget(options.memory_budget), prefetching(options.prefetch), fd_(fd),
+      cached_bytes_(0), stopping_(false) {}
+
+TileStore::~TileStore() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    queued_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    try {
+        flush();
+    } catch (...) {
+    }
+    ::close(fd_);
+    if (temporary) {
+        ::unlink(path.c_str());
+    }
+}
+
+std::shared_ptr<Tile> TileStore::acquire(size_t index, bool overwrite) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto found = tiles_.find(index);
+    if (found != tiles_.end()) {
+        std::shared_ptr<Tile> tile = found->second;
+        ++stats_.hits;
+        lru_.splice(lru_.begin(), lru_, tile->lru);
+        loaded_.wait(lock, [&] { return tile->ready || tile->failed; });
+        if (tile->failed) {
+            throw std::runtime_error("Cannot read tiled matrix file: " + path);
+        }
+        return tile;
+    }
+
+    ++stats_.misses;
+    cached_bytes_ += tileBytes();
+    try {
+        evict();
+    } catch (...) {
+        cached_bytes_ -= tileBytes();
+        throw;
+    }
+    auto tile = std::make_shared<Tile>();
+    tile->data.resize(tileElements());
+    lru_.push_front(index);
+    tile->lru = lru_.begin();
+    tiles_.emplace(index, tile);
+    if (overwrite) {
+        tile->ready = true;
+        return tile;
+    }
+
+    lock.unlock();
+    try {
+        readFully(fd_, tile->data.data(), tileBytes(), offset(index), path);
+    } catch (...) {
+        lock.lock();
+        tile->failed = true;
+        lru_.erase(tile->lru);
+        tiles_.erase(index);
+        cached_bytes_ -= tileBytes();
+        loaded_.notify_all();
+        throw;
+    }
+    lock.lock();
+    tile->ready = true;
+    loaded_.notify_all();
+    return tile;
+}
+
+void TileStore::markDirty(Tile& tile) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tile.dirty = true;
+}
+
+void TileStore::evict() {
+    for (auto it = lru_.end(); it != lru_.begin() && cached_bytes_ > budget;) {
+        --it;
+        auto found = tiles_.find(*it);
+        const std::shared_ptr<Tile>& tile = found->second;
+        if (tile.use_count() > 1 || !tile->ready) {
+            continue;
+        }
+        // Written back under the lock, so no reader can fetch the stale
+        // copy from disk in the meantime
+        if (tile->dirty) {
+            writeFully(fd_, tile->data.data(), tileBytes(), offset(*it), path);
+            ++stats_.writes;
+        }
+        tiles_.erase(found);
+        it = lru_.erase(it);
+        cached_bytes_ -= tileBytes();
+        ++stats_.evictions;
+    }
+}
+
+void TileStore::prefetch(size_t index) {
+    if (!prefetching) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (tiles_.count(index) != 0 ||
+            std::find(queue_.begin(), queue_.end(), index) != queue_.end()) {
+            return;
+        }
+        queue_.push_back(index);
+        if (!worker_.joinable()) {
+            worker_ = std::thread([this] { runPrefetch(); });
+        }
+    }
+    queued_.notify_one();
+}
+
+void TileStore::runPrefetch() {
+    while (true) {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queued_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            index = queue_.front();
+            queue_.pop_front();
+        }
+        // A failed read is reported again when the tile is actually used
+        try {
+            acquire(index);
+        } catch (...) {
+        }
+    }
+}
+
+void TileStore::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : tiles_) {
+        Tile& tile = *entry.second;
+        if (tile.ready && tile.dirty) {
+            writeFully(fd_, tile.data.data(), tileBytes(), offset(entry.first), path);
+            tile.dirty = false;
+            ++stats_.writes;
+        }
+    }
+}
+
+size_t TileStore::cachedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cached_bytes_;
+}
+
+TileCacheStats TileStore::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+namespace {
+
+// Visit every tile of layout in row-major order, asking each store in
+// inputs to prefetch the next tile first so its read overlaps body
+template <typename Body>
+void forEachTile(const TileStore& layout, std::initializer_list<TileStore*> inputs,
+                 Body body) {
+    size_t count = layout.tile_rows * layout.tile_cols;
+    for (size_t t = 0; t < count; ++t) {
+        if (t + 1 < count) {
+            for (TileStore* input : inputs) {
+                input->prefetch(t + 1);
+            }
+        }
+        body(t / layout.tile_cols, t % layout.tile_cols);
+    }
+}
+
+void requireDistinctPath(const std::string& path, const TileStore& input) {
+    if (!path.empty() && std::filesystem::exists(path) &&
+        std::filesystem::equivalent(path, input.path)) {
+        throw std::invalid_argument("Output of tiled operation must not alias an input");
+    }
+}
+
+} // namespace
+
+// ========== CONSTRUCTION ==========
+
+TiledMatrix::TiledMatrix(std::unique_ptr<TileStore> store) : store_(std::move(store)) {}
+
+TiledMatrix::~TiledMatrix() = default;
+
+TiledMatrix::TiledMatrix(TiledMatrix&& other) noexcept = default;
+
+TiledMatrix& TiledMatrix::operator=(TiledMatrix&& other) noexcept = default;
+
+TiledMatrix TiledMatrix::create(const std::string& path, size_t rows, size_t cols,
+                                const TiledMatrixOptions& options) {
+    size_t tile = options.tile_size;
+    if (tile == 0) {
+        throw std::invalid_argument("Tile size must be positive");
+    }
+    if (options.memory_budget / 2 / sizeof(double) / tile < tile) {
+        throw std::invalid_argument("Memory budget must hold at least two tiles");
+    }
+    size_t tiles = ceilDiv(rows, tile) * ceilDiv(cols, tile);
+    if (tiles != 0 && tiles > SIZE_MAX / sizeof(double) / tile / tile) {
+        throw std::invalid_argument("Tiled matrix dimensions too large");
+    }
+
+    bool temporary = path.empty();
+    std::string file = temporary ? temporaryPath(std::filesystem::temp_directory_path()) : path;
+    int fd = ::open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create tiled matrix file: " + file);
+    }
+
+    TiledMatrixFileHeader header = {};
+    std::memcpy(header.magic, TILED_MAGIC, sizeof(TILED_MAGIC));
+    header.version = TILED_FILE_VERSION;
+    header.dtype = MatrixDataType::Float64;
+    header.byte_order = hostByteOrder();
+    header.rows = rows;
+    header.cols = cols;
+    header.tile_size = tile;
+    try {
+        writeFully(fd, &header, sizeof(header), 0, file);
+        // Extending the file leaves the tiles as zeros (and sparse on disk)
+        off_t size = static_cast<off_t>(sizeof(header) + tiles * tile * tile * sizeof(double));
+        if (::ftruncate(fd, size) != 0) {
+            throw std::runtime_error("Cannot create tiled matrix file: " + file);
+        }
+    } catch (...) {
+        ::close(fd);
+        ::unlink(file.c_str());
+        throw;
+    }
+    return TiledMatrix(std::make_unique<TileStore>(file, temporary, fd, rows, cols, tile, options));
+}
+
+TiledMatrix TiledMatrix::open(const std::string& path, const TiledMatrixOptions& options) {
+    int fd = ::open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open tiled matrix file: " + path);
+    }
+    TiledMatrixFileHeader header;
+    try {
+        readFully(fd, &header, sizeof(header), 0, path);
+        if (std::memcmp(header.magic, TILED_MAGIC, sizeof(TILED_MAGIC)) != 0) {
+            throw std::runtime_error("Not a tiled matrix file: " + path);
+        }
+        if (header.version != TILED_FILE_VERSION) {
+            throw std::runtime_error("Unsupported tiled matrix file version: " + path);
+        }
+        if (header.dtype != MatrixDataType::Float64) {
+            throw std::runtime_error("Unsupported matrix element type: " + path);
+        }
+        if (header.byte_order != hostByteOrder()) {
+            throw std::runtime_error("Tiled matrix file byte order differs from host: " + path);
+        }
+        if (header.tile_size == 0 ||
+            header.tile_size > SIZE_MAX / sizeof(double) / header.tile_size) {
+            throw std::runtime_error("Invalid tile size in tiled matrix file: " + path);
+        }
+        size_t tile_bytes = header.tile_size * header.tile_size * sizeof(double);
+        size_t tiles = ceilDiv(header.rows, header.tile_size) *
+                       ceilDiv(header.cols, header.tile_size);
+        struct stat info;
+        if (::fstat(fd, &info) != 0 ||
+            (static_cast<size_t>(info.st_size) - sizeof(header)) / tile_bytes < tiles) {
+            throw std::runtime_error("Truncated tiled matrix file: " + path);
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+
+    TiledMatrixOptions opened = options;
+    opened.tile_size = header.tile_size;
+    if (opened.memory_budget / 2 / sizeof(double) / opened.tile_size < opened.tile_size) {
+        ::close(fd);
+        throw std::invalid_argument("Memory budget must hold at least two tiles");
+    }
+    return TiledMatrix(std::make_unique<TileStore>(path, false, fd, header.rows, header.cols,
+                                                   header.tile_size, opened));
+}
+
+TiledMatrix TiledMatrix::fromMatrix(ConstMatrixView m, const std::string& path,
+                                    const TiledMatrixOptions& options) {
+    TiledMatrix result = create(path, m.rows(), m.cols(), options);
+    for (size_t i = 0; i < result.tileRows(); ++i) {
+        for (size_t j = 0; j < result.tileCols(); ++j) {
+            result.writeTile(i, j, m.block(i * result.tileSize(), j * result.tileSize(),
+                                           result.store_->rowsIn(i), result.store_->colsIn(j)));
+        }
+    }
+    return result;
+}
+
+TiledMatrix TiledMatrix::like(size_t rows, size_t cols, const std::string& path) const {
+    TiledMatrixOptions options;
+    options.tile_size = store_->tile_size;
+    options.memory_budget = store_->budget;
+    options.prefetch = store_->prefetching;
+    if (!path.empty()) {
+        return create(path, rows, cols, options);
+    }
+    std::filesystem::path directory = std::filesystem::path(store_->path).parent_path();
+    TiledMatrix result = create(temporaryPath(directory.empty() ? "." : directory),
+                                rows, cols, options);
+    result.store_->temporary = true;
+    return result;
+}
+
+Matrix TiledMatrix::toMatrix() const {
+    Matrix result(rows(), cols());
+    TileStore& s = *store_;
+    forEachTile(s, {&s}, [&](size_t i, size_t j) {
+        std::shared_ptr<Tile> tile = s.acquire(s.index(i, j));
+        for (size_t r = 0; r < s.rowsIn(i); ++r) {
+            std::copy_n(tile->data.data() + r * s.tile_size, s.colsIn(j),
+                        result.data() + (i * s.tile_size + r) * cols() + j * s.tile_size);
+        }
+    });
+    return result;
+}
+
+// ========== ELEMENT ACCESS ==========
+
+double TiledMatrix::operator()(size_t row, size_t col) const {
+    TileStore& s = *store_;
+    std::shared_ptr<Tile> tile = s.acquire(s.index(row / s.tile_size, col / s.tile_size));
+    return tile->data[(row % s.tile_size) * s.tile_size + col % s.tile_size];
+}
+
+void TiledMatrix::set(size_t row, size_t col, double value) {
+    TileStore& s = *store_;
+    std::shared_ptr<Tile> tile = s.acquire(s.index(row / s.tile_size, col / s.tile_size));
+    tile->data[(row % s.tile_size) * s.tile_size + col % s.tile_size] = value;
+    s.markDirty(*tile);
+}
+
+double TiledMatrix::at(size_t row, size_t col) const {
+    if (row >= rows() || col >= cols()) {
+        throw std::out_of_range("Matrix index out of range");
+    }
+    return (*this)(row, col);
+}
+
+void TiledMatrix::setAt(size_t row, size_t col, double value) {
+    if (row >= rows() || col >= cols()) {
+        throw std::out_of_range("Matrix index out of range");
+    }
+    set(row, col, value);
+}
+
+// ========== SIZE AND TILES ==========
+
+size_t TiledMatrix::rows() const {
+    return store_->rows;
+}
+
+size_t TiledMatrix::cols() const {
+    return store_->cols;
+}
+
+bool TiledMatrix::isEmpty() const {
+    return rows() == 0 || cols() == 0;
+}
+
+const std::string& TiledMatrix::path() const {
+    return store_->path;
+}
+
+size_t TiledMatrix::tileSize() const {
+    return store_->tile_size;
+}
+
+size_t TiledMatrix::tileRows() const {
+    return store_->tile_rows;
+}
+
+size_t TiledMatrix::tileCols() const {
+    return store_->tile_cols;
+}
+
+Matrix TiledMatrix::readTile(size_t tile_row, size_t tile_col) const {
+    TileStore& s = *store_;
+    if (tile_row >= s.tile_rows || tile_col >= s.tile_cols) {
+        throw std::out_of_range("Tile index out of range");
+    }
+    std::shared_ptr<Tile> tile = s.acquire(s.index(tile_row, tile_col));
+    Matrix result(s.rowsIn(tile_row), s.colsIn(tile_col));
+    for (size_t r = 0; r < result.rows(); ++r) {
+        std::copy_n(tile->data.data() + r * s.tile_size, result.cols(),
+                    result.data() + r * result.cols());
+    }
+    return result;
+}
+
+void TiledMatrix::writeTile(size_t tile_row, size_t tile_col, ConstMatrixView block) {
+    TileStore& s = *store_;
+    if (tile_row >= s.tile_rows || tile_col >= s.tile_cols) {
+        throw std::out_of_range("Tile index out of range");
+    }
+    if (block.rows() != s.rowsIn(tile_row) || block.cols() != s.colsIn(tile_col)) {
+        throw std::invalid_argument("Block has the wrong shape for this tile");
+    }
+    std::shared_ptr<Tile> tile = s.acquire(s.index(tile_row, tile_col), true);
+    for (size_t r = 0; r < block.rows(); ++r) {
+        for (size_t c = 0; c < block.cols(); ++c) {
+            tile->data[r * s.tile_size + c] = block(r, c);
+        }
+    }
+    s.markDirty(*tile);
+}
+
+void TiledMatrix::prefetch(size_t tile_row, size_t tile_col) const {
+    if (tile_row >= tileRows() || tile_col >= tileCols()) {
+        throw std::out_of_range("Tile index out of range");
+    }
+    store_->prefetch(store_->index(tile_row, tile_col));
+}
+
+// ========== CACHE ==========
+
+void TiledMatrix::flush() {
+    store_->flush();
+}
+
+size_t TiledMatrix::memoryBudget() const {
+    return store_->budget;
+}
+
+size_t TiledMatrix::cachedBytes() const {
+    return store_->cachedBytes();
+}
+
+TileCacheStats TiledMatrix::stats() const {
+    return store_->stats();
+}
+
+// ========== OPERATIONS ==========
+
+TiledMatrix TiledMatrix::multiply(const TiledMatrix& other, const std::string& path) const {
+    if (cols() != other.rows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    if (tileSize() != other.tileSize()) {
+        throw std::invalid_argument("Tile sizes must match for tiled operations");
+    }
+    requireDistinctPath(path, *store_);
+    requireDistinctPath(path, *other.store_);
+
+    TiledMatrix result = like(rows(), other.cols(), path);
+    TileStore& a = *store_;
+    TileStore& b = *other.store_;
+    TileStore& c = *result.store_;
+    size_t steps = a.tile_cols;
+    forEachTile(c, {}, [&](size_t i, size_t j) {
+        std::shared_ptr<Tile> out = c.acquire(c.index(i, j), true);
+        for (size_t k = 0; k < steps; ++k) {
+            // Queue the pair for the next step (or the next output tile)
+            size_t next_i = i, next_j = j, next_k = k + 1;
+            if (next_k == steps) {
+                next_k = 0;
+                next_j = j + 1 < c.tile_cols ? j + 1 : 0;
+                next_i = next_j == 0 ? i + 1 : i;
+            }
+            if (next_i < c.tile_rows) {
+                a.prefetch(a.index(next_i, next_k));
+                b.prefetch(b.index(next_k, next_j));
+            }
+
+            std::shared_ptr<Tile> left = a.acquire(a.index(i, k));
+            std::shared_ptr<Tile> right = b.acquire(b.index(k, j));
+            kernels::gemm(c.rowsIn(i), c.colsIn(j), a.colsIn(k), 1.0,
+                          left->data.data(), a.tile_size, 1,
+                          right->data.data(), b.tile_size, 1,
+                          out->data.data(), c.tile_size);
+        }
+        c.markDirty(*out);
+    });
+    return result;
+}
+
+TiledMatrix TiledMatrix::transpose(const std::string& path) const {
+    requireDistinctPath(path, *store_);
+    TiledMatrix result = like(cols(), rows(), path);
+    TileStore& a = *store_;
+    TileStore& c = *result.store_;
+    forEachTile(a, {&a}, [&](size_t i, size_t j) {
+        std::shared_ptr<Tile> in = a.acquire(a.index(i, j));
+        std::shared_ptr<Tile> out = c.acquire(c.index(j, i), true);
+        kernels::transpose(a.rowsIn(i), a.colsIn(j), in->data.data(), a.tile_size,
+                           out->data.data(), c.tile_size);
+        c.markDirty(*out);
+    });
+    return result;
+}
+
+TiledMatrix TiledMatrix::combine(const TiledMatrix& other, bool negate,
+                                 const std::string& path) const {
+    if (rows() != other.rows() || cols() != other.cols()) {
+        throw std::invalid_argument(negate ? "Matrix dimensions must match for subtraction"
+                                           : "Matrix dimensions must match for addition");
+    }
+    if (tileSize() != other.tileSize()) {
+        throw std::invalid_argument("Tile sizes must match for tiled operations");
+    }
+    requireDistinctPath(path, *store_);
+    requireDistinctPath(path, *other.store_);
+
+    TiledMatrix result = like(rows(), cols(), path);
+    TileStore& a = *store_;
+    TileStore& b = *other.store_;
+    TileStore& c = *result.store_;
+    // Padding is zero in both inputs, so whole tiles can be combined
+    forEachTile(a, {&a, &b}, [&](size_t i, size_t j) {
+        std::shared_ptr<Tile> left = a.acquire(a.index(i, j));
+        std::shared_ptr<Tile> right = b.acquire(b.index(i, j));
+        std::shared_ptr<Tile> out = c.acquire(c.index(i, j), true);
+        if (!negate) {
+            kernels::add(a.tileElements(), left->data.data(), right->data.data(),
+                         out->data.data());
+        } else {
+            kernels::subtract(a.tileElements(), left->data.data(), right->data.data(),
+                              out->data.data());
+        }
+        c.markDirty(*out);
+    });
+    return result;
+}
+
+TiledMatrix TiledMatrix::add(const TiledMatrix& other, const std::string& path) const {
+    return combine(other, false, path);
+}
+
+TiledMatrix TiledMatrix::subtract(const TiledMatrix& other, const std::string& path) const {
+    return combine(other, true, path);
+}
+
+TiledMatrix TiledMatrix::scale(double scalar, const std::string& path) const {
+    requireDistinctPath(path, *store_);
+    TiledMatrix result = like(rows(), cols(), path);
+    TileStore& a = *store_;
+    TileStore& c = *result.store_;
+    forEachTile(a, {&a}, [&](size_t i, size_t j) {
+        std::shared_ptr<Tile> in = a.acquire(a.index(i, j));
+        std::shared_ptr<Tile> out = c.acquire(c.index(i, j), true);
+        kernels::scale(a.tileElements(), scalar, in->data.data(), out->data.data());
+        c.markDirty(*out);
+    });
+    return result;
+}
+
+void TiledMatrix::fill(double value) {
+    TileStore& s = *store_;
+    forEachTile(s, {}, [&](size_t i, size_t j) {
+        std::shared_ptr<Tile> tile = s.acquire(s.index(i, j), true);
+        // Only the trimmed part: padding must stay zero
+        for (size_t r = 0; r < s.rowsIn(i); ++r) {
+            kernels::fill(s.colsIn(j), value, tile->data.data() + r * s.tile_size);
+        }
+        s.markDirty(*tile);
+    });
+}
+
+// ========== OPERATORS ==========
+
+TiledMatrix TiledMatrix::operator+(const TiledMatrix& other) const {
+    return add(other);
+}
+
+TiledMatrix TiledMatrix::operator-(const TiledMatrix& other) const {
+    return subtract(other);
+}
+
+TiledMatrix TiledMatrix::operator*(const TiledMatrix& other) const {
+    return multiply(other);
+}
+
+TiledMatrix TiledMatrix::operator*(double scalar) const {
+    return scale(scalar);
+}
+
+TiledMatrix operator*(double scalar, const TiledMatrix& m) {
+    return m.scale(scalar);
+}
+
+TiledMatrix& TiledMatrix::operator+=(const TiledMatrix& other) {
+    if (rows() != other.rows() || cols() != other.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for addition");
+    }
+    if (tileSize() != other.tileSize()) {
+        throw std::invalid_argument("Tile sizes must match for tiled operations");
+    }
+    TileStore& a = *store_;
+    TileStore& b = *other.store_;
+    forEachTile(a, {&a, &b}, [&](size_t i, size_t j) {
+        std::shared_ptr<Tile> left = a.acquire(a.index(i, j));
+        std::shared_ptr<Tile> right = b.acquire(b.index(i, j));
+        kernels::add(a.tileElements(), left->data.data(), right->data.data(),
+                     left->data.data());
+        a.markDirty(*left);
+    });
+    return *this;
+}
+
+TiledMatrix& TiledMatrix::operator-=(const TiledMatrix& other) {
+    if (rows() != other.rows() || cols() != other.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match for subtraction");
+    }
+    if (tileSize() != other.tileSize()) {
+        throw std::invalid_argument("Tile sizes must match for tiled operations");
+    }
+    TileStore& a = *store_;
+    TileStore& b = *other.store_;
+    forEachTile(a, {&a, &b}, [&](size_t i, size_t j) {
+        std::shared_ptr<Tile> left = a.acquire(a.index(i, j));
+        std::shared_ptr<Tile> right = b.acquire(b.index(i, j));
+        kernels::subtract(a.tileElements(), left->data.data(), right->data.data(),
+                          left->data.data());
+        a.markDirty(*left);
+    });
+    return *this;
+}
+
+TiledMatrix& TiledMatrix::operator*=(double scalar) {
+    TileStore& a = *store_;
+    forEachTile(a, {&a}, [&](size_t i, size_t j) {
+        std::shared_ptr<Tile> tile = a.acquire(a.index(i, j));
+        kernels::scale(a.tileElements(), scalar, tile->data.data(), tile->data.data());
+        a.markDirty(*tile);
+    });
+    return *this;
+}
+
+bool TiledMatrix::operator==(const TiledMatrix& other) const {
+    if (rows() != other.rows() || cols() != other.cols()) {
+        return false;
+    }
+    if (tileSize() != other.tileSize()) {
+        for (size_t i = 0; i < rows(); ++i) {
+            for (size_t j = 0; j < cols(); ++j) {
+                if (std::abs((*this)(i, j) - other(i, j)) >= EPSILON) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    TileStore& a = *store_;
+    TileStore& b = *other.store_;
+    bool equal = true;
+    forEachTile(a, {&a, &b}, [&](size_t i, size_t j) {
+        if (!equal) {
+            return;
+        }
+        std::shared_ptr<Tile> left = a.acquire(a.index(i, j));
+        std::shared_ptr<Tile> right = b.acquire(b.index(i, j));
+        for (size_t k = 0; k < a.tileElements(); ++k) {
+            if (std::abs(left->data[k] - right->data[k]) >= EPSILON) {
+                equal = false;
+                return;
+            }
+        }
+    });
+    return equal;
+}
+
+bool TiledMatrix::operator!=(const TiledMatrix& other) const {
+    return !(*this == other);
+}
@@ -0,0 +1,194 @@
+#ifndef TILED_MATRIX_H
+#define TILED_MATRIX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "matrix.h"
+#include "matrix_io.h"
+
+// Out-of-core matrix stored on disk as square tiles.
+//
+// Only the tiles in use live in memory: an LRU cache per matrix holds them
+// up to a configurable byte budget, writing modified tiles back when they are
+// evicted or flushed. Tiles can be prefetched on a background I/O thread
+// so that reading the next tile overlaps computing on the current one;
+// the tiled operations below do this themselves. Every operation works
+// tile by tile, so matrices far larger than RAM can be multiplied,
+// transposed and combined element-wise.
+//
+// Results are written to a new file. An operation given an empty path (and
+// every operator) creates a temporary file next to its left operand that
+// is deleted when the result is destroyed. All I/O failures throw
+// std::runtime_error.
+
+// ========== FILE FORMAT ==========
+
+// A tiled file is this 64-byte header followed by the tiles in row-major
+// tile order. Every tile occupies tile_size^2 elements, row-major; tiles
+// on the bottom and right edges are padded with zeros.
+struct TiledMatrixFileHeader {
+    char magic[4];              // "MTIL"
+    uint8_t version;            // TILED_FILE_VERSION
+    MatrixDataType dtype;
+    MatrixByteOrder byte_order; // must be the host's
+    uint8_t reserved;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t tile_size;
+    uint8_t padding[32];
+};
+
+static_assert(sizeof(TiledMatrixFileHeader) == 64, "Tiled file header must be 64 bytes");
+
+constexpr uint8_t TILED_FILE_VERSION = 1;
+
+struct TiledMatrixOptions {
+    // Tile edge in elements (512 gives 2 MB tiles)
+    size_t tile_size = 512;
+
+    // Bytes of tiles this matrix keeps in memory. The budget is per
+    // matrix: every matrix has its own cache, results of operations get
+    // their left operand's budget, and an operation can hold up to the
+    // budgets of its operands and result together (3x for a * b). An
+    // operation pins one tile of each matrix and prefetches the next, so
+    // this must hold at least two tiles (std::invalid_argument otherwise).
+    size_t memory_budget = size_t(256) << 20;
+
+    // Load tiles ahead of use on a background thread
+    bool prefetch = true;
+};
+
+// Tile cache counters, for tuning the budget and tile size
+struct TileCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t writes = 0;
+};
+
+class TileStore;
+
+class TiledMatrix {
+private:
+    std::unique_ptr<TileStore> store_;
+
+    static constexpr double EPSILON = 1e-9;
+
+    explicit TiledMatrix(std::unique_ptr<TileStore> store);
+
+    // New matrix of the given shape with this matrix's tile size, budget
+    // and prefetch setting (temporary if path is empty)
+    TiledMatrix like(size_t rows, size_t cols, const std::string& path) const;
+
+    // Helper for the element-wise operations: this + other, or this - other
+    // when negate is set
+    TiledMatrix combine(const TiledMatrix& other, bool negate,
+                        const std::string& path) const;
+
+public:
+    // ========== CONSTRUCTION ==========
+
+    // Create a zero rows x cols matrix in a new file (replacing any file
+    // at path). An empty path creates a temporary file in the system
+    // temporary directory.
+    static TiledMatrix create(const std::string& path, size_t rows, size_t cols,
+                              const TiledMatrixOptions& options = TiledMatrixOptions());
+
+    // Open an existing tiled file for reading and writing. Its own tile
+    // size is used; options.tile_size is ignored.
+    static TiledMatrix open(const std::string& path,
+                            const TiledMatrixOptions& options = TiledMatrixOptions());
+
+    // Write a dense matrix out as a new tiled file
+    static TiledMatrix fromMatrix(ConstMatrixView m, const std::string& path,
+                                  const TiledMatrixOptions& options = TiledMatrixOptions());
+
+    // Flushes modified tiles (errors are swallowed; call flush() to see
+    // them) and deletes the file if it is temporary
+    ~TiledMatrix();
+
+    TiledMatrix(TiledMatrix&& other) noexcept;
+    TiledMatrix& operator=(TiledMatrix&& other) noexcept;
+    TiledMatrix(const TiledMatrix&) = delete;
+    TiledMatrix& operator=(const TiledMatrix&) = delete;
+
+    // Whole matrix in memory (only sensible when it fits)
+    Matrix toMatrix() const;
+
+    // ========== ELEMENT ACCESS ==========
+
+    // Element reads and writes go through the tile cache. Elements are
+    // not returned by reference, since their tile may be evicted.
+    double operator()(size_t row, size_t col) const;
+    void set(size_t row, size_t col, double value);
+
+    // Same with bounds checking (throw std::out_of_range)
+    double at(size_t row, size_t col) const;
+    void setAt(size_t row, size_t col, double value);
+
+    // ========== SIZE AND TILES ==========
+
+    size_t rows() const;
+    size_t cols() const;
+    bool isEmpty() const;
+    const std::string& path() const;
+
+    size_t tileSize() const;
+    size_t tileRows() const;
+    size_t tileCols() const;
+
+    // Copy of tile (tile_row, tile_col), trimmed to the matrix edge
+    Matrix readTile(size_t tile_row, size_t tile_col) const;
+
+    // Overwrite tile (tile_row, tile_col); block must have its trimmed shape
+    void writeTile(size_t tile_row, size_t tile_col, ConstMatrixView block);
+
+    // Start loading a tile in the background (no-op if it is cached or
+    // prefetching is disabled)
+    void prefetch(size_t tile_row, size_t tile_col) const;
+
+    // ========== CACHE ==========
+
+    // Write every modified tile back to the file
+    void flush();
+
+    size_t memoryBudget() const;
+    size_t cachedBytes() const;
+    TileCacheStats stats() const;
+
+    // ========== OPERATIONS ==========
+
+    // C = this * other, one output tile at a time: for each C(i, j) the
+    // tiles A(i, k) and B(k, j) are streamed through the cache and
+    // accumulated with the GEMM kernel. Tile sizes must match.
+    TiledMatrix multiply(const TiledMatrix& other, const std::string& path = "") const;
+
+    TiledMatrix transpose(const std::string& path = "") const;
+
+    TiledMatrix add(const TiledMatrix& other, const std::string& path = "") const;
+    TiledMatrix subtract(const TiledMatrix& other, const std::string& path = "") const;
+    TiledMatrix scale(double scalar, const std::string& path = "") const;
+
+    void fill(double value);
+
+    // ========== OPERATORS ==========
+
+    // Same semantics as Matrix; results are temporary tiled matrices
+    TiledMatrix operator+(const TiledMatrix& other) const;
+    TiledMatrix operator-(const TiledMatrix& other) const;
+    TiledMatrix operator*(const TiledMatrix& other) const;
+    TiledMatrix operator*(double scalar) const;
+    friend TiledMatrix operator*(double scalar, const TiledMatrix& m);
+
+    TiledMatrix& operator+=(const TiledMatrix& other);
+    TiledMatrix& operator-=(const TiledMatrix& other);
+    TiledMatrix& operator*=(double scalar);
+
+    // Same shape and every element within EPSILON
+    bool operator==(const TiledMatrix& other) const;
+    bool operator!=(const TiledMatrix& other) const;
+};
+
+#endif // TILED_MATRIX_H
@@ -0,0 +1,96 @@
+#include "transpose.h"
+#include <vector>
+#include <utility>
+
+namespace kernels {
+
+namespace {
+
+// Swap the h x w block at a with the transpose of the w x h block at b
+void swapTransposed(size_t h, size_t w, double* a, double* b, size_t ld) {
+    if (h <= TRANSPOSE_BLOCK && w <= TRANSPOSE_BLOCK) {
+        for (size_t i = 0; i < h; ++i) {
+            for (size_t j = 0; j < w; ++j) {
+                std::swap(a[i * ld + j], b[j * ld + i]);
+            }
+        }
+    } else if (h >= w) {
+        size_t half = h / 2;
+        swapTransposed(half, w, a, b, ld);
+        swapTransposed(h - half, w, a + half * ld, b + half, ld);
+    } else {
+        size_t half = w / 2;
+        swapTransposed(h, half, a, b, ld);
+        swapTransposed(h, w - half, a + half, b + half * ld, ld);
+    }
+}
+
+} // namespace
+
+void transpose(size_t rows, size_t cols, const double* src, size_t ld_src,
+               double* dst, size_t ld_dst) {
+    if (rows <= TRANSPOSE_BLOCK && cols <= TRANSPOSE_BLOCK) {
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                dst[j * ld_dst + i] = src[i * ld_src + j];
+            }
+        }
+    } else if (rows >= cols) {
+        size_t half = rows / 2;
+        transpose(half, cols, src, ld_src, dst, ld_dst);
+        transpose(rows - half, cols, src + half * ld_src, ld_src, dst + half, ld_dst);
+    } else {
+        size_t half = cols / 2;
+        transpose(rows, half, src, ld_src, dst, ld_dst);
+        transpose(rows, cols - half, src + half, ld_src, dst + half * ld_dst, ld_dst);
+    }
+}
+
+void transposeSquareInPlace(size_t n, double* a, size_t ld) {
+    if (n <= TRANSPOSE_BLOCK) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i + 1; j < n; ++j) {
+                std::swap(a[i * ld + j], a[j * ld + i]);
+            }
+        }
+        return;
+    }
+
+    // [A B; C D]^T = [A^T C^T; B^T D^T]: transpose the diagonal blocks in
+    // place and swap B with C^T
+    size_t half = n / 2;
+    transposeSquareInPlace(half, a, ld);
+    transposeSquareInPlace(n - half, a + half * ld + half, ld);
+    swapTransposed(half, n - half, a + half, a + half * ld, ld);
+}
+
+void transposeInPlace(size_t rows, size_t cols, double* a) {
+    if (rows == cols) {
+        transposeSquareInPlace(rows, a, cols);
+        return;
+    }
+    size_t size = rows * cols;
+    if (rows <= 1 || cols <= 1) {
+        return;  // A vector's storage is the same either way
+    }
+
+    // The element at index k = i * cols + j moves to j * rows + i, which is
+    // k * rows mod (size - 1). The first and last elements never move.
+    size_t modulus = size - 1;
+    std::vector<bool> visited(size, false);
+    for (size_t start = 1; start < modulus; ++start) {
+        if (visited[start]) {
+            continue;
+        }
+        double carried = a[start];
+        size_t k = start;
+        do {
+            size_t next = (k % cols) * rows + k / cols;
+            std::swap(carried, a[next]);
+            visited[next] = true;
+            k = next;
+        } while (k != start);
+    }
+}
+
+} // namespace kernels
@@ -0,0 +1,30 @@
+#ifndef TRANSPOSE_H
+#define TRANSPOSE_H
+
+#include <cstddef>
+
+namespace kernels {
+
+// Below this many elements a block is transposed with a plain double loop;
+// 32 x 32 doubles of source plus destination fit comfortably in L1
+constexpr size_t TRANSPOSE_BLOCK = 32;
+
+// dst (cols x rows) = src (rows x cols)^T, both row-major with the given
+// row strides. Recursively halves the longer dimension until the block
+// fits in cache, so it is cache- and TLB-friendly at every level of the
+// memory hierarchy without tuning.
+void transpose(size_t rows, size_t cols, const double* src, size_t ld_src,
+               double* dst, size_t ld_dst);
+
+// Transpose an n x n block in place by swapping mirrored tiles
+void transposeSquareInPlace(size_t n, double* a, size_t ld);
+
+// Transpose a contiguous rows x cols matrix in place, leaving it as a
+// contiguous cols x rows matrix. Follows the cycles of the index
+// permutation, using one bit of bookkeeping per element instead of a
+// second copy of the data.
+void transposeInPlace(size_t rows, size_t cols, double* a);
+
+} // namespace kernels
+
+#endif // TRANSPOSE_H
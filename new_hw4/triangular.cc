@@ -0,0 +1,118 @@
+#include "triangular.h"
+#include "gemm.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace kernels {
+
+namespace {
+
+void checkShapes(ConstMatrixView T, MatrixView B) {
+    if (T.rows() != T.cols() || T.rows() != B.rows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for triangular solve");
+    }
+    if (B.colStride() != 1) {
+        throw std::invalid_argument("Triangular solve needs unit column stride");
+    }
+}
+
+// Row-oriented substitution within one diagonal block: each row of X is
+// an axpy over whole rows of B, which is contiguous
+void substituteLower(ConstMatrixView L, MatrixView B, bool unit_diagonal) {
+    size_t k = B.cols();
+    for (size_t i = 0; i < L.rows(); ++i) {
+        double* b_i = &B(i, 0);
+        for (size_t p = 0; p < i; ++p) {
+            double l_ip = L(i, p);
+            const double* b_p = &B(p, 0);
+            for (size_t j = 0; j < k; ++j) {
+                b_i[j] -= l_ip * b_p[j];
+            }
+        }
+        if (!unit_diagonal) {
+            double inv = 1.0 / L(i, i);
+            for (size_t j = 0; j < k; ++j) {
+                b_i[j] *= inv;
+            }
+        }
+    }
+}
+
+void substituteUpper(ConstMatrixView U, MatrixView B, bool unit_diagonal) {
+    size_t k = B.cols();
+    for (size_t i = U.rows(); i-- > 0;) {
+        double* b_i = &B(i, 0);
+        for (size_t p = i + 1; p < U.rows(); ++p) {
+            double u_ip = U(i, p);
+            const double* b_p = &B(p, 0);
+            for (size_t j = 0; j < k; ++j) {
+                b_i[j] -= u_ip * b_p[j];
+            }
+        }
+        if (!unit_diagonal) {
+            double inv = 1.0 / U(i, i);
+            for (size_t j = 0; j < k; ++j) {
+                b_i[j] *= inv;
+            }
+        }
+    }
+}
+
+} // namespace
+
+void solveLower(ConstMatrixView L, MatrixView B, bool unit_diagonal) {
+    checkShapes(L, B);
+    size_t n = L.rows();
+    size_t k = B.cols();
+    if (n == 0 || k == 0) {
+        return;
+    }
+
+    for (size_t i0 = 0; i0 < n; i0 += TRSM_BLOCK) {
+        size_t ib = std::min(TRSM_BLOCK, n - i0);
+        substituteLower(L.block(i0, i0, ib, ib), B.block(i0, 0, ib, k), unit_diagonal);
+
+        // B[below] -= L[below, block] * X[block]
+        size_t i1 = i0 + ib;
+        if (i1 < n) {
+            ConstMatrixView l21 = L.block(i1, i0, n - i1, ib);
+            MatrixView x1 = B.block(i0, 0, ib, k);
+            MatrixView b2 = B.block(i1, 0, n - i1, k);
+            gemm(n - i1, k, ib, -1.0,
+                 l21.data(), l21.rowStride(), l21.colStride(),
+                 x1.data(), x1.rowStride(), 1,
+                 b2.data(), b2.rowStride());
+        }
+    }
+}
+
+void solveUpper(ConstMatrixView U, MatrixView B, bool unit_diagonal) {
+    checkShapes(U, B);
+    size_t n = U.rows();
+    size_t k = B.cols();
+    if (n == 0 || k == 0) {
+        return;
+    }
+
+    // Walk the diagonal blocks bottom-up
+    size_t i1 = n;
+    while (i1 > 0) {
+        size_t ib = std::min(TRSM_BLOCK, i1);
+        size_t i0 = i1 - ib;
+        substituteUpper(U.block(i0, i0, ib, ib), B.block(i0, 0, ib, k), unit_diagonal);
+
+        // B[above] -= U[above, block] * X[block]
+        if (i0 > 0) {
+            ConstMatrixView u01 = U.block(0, i0, i0, ib);
+            MatrixView x1 = B.block(i0, 0, ib, k);
+            MatrixView b0 = B.block(0, 0, i0, k);
+            gemm(i0, k, ib, -1.0,
+                 u01.data(), u01.rowStride(), u01.colStride(),
+                 x1.data(), x1.rowStride(), 1,
+                 b0.data(), b0.rowStride());
+        }
+        i1 = i0;
+    }
+}
+
+} // namespace kernels
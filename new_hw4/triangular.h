@@ -0,0 +1,28 @@
+#ifndef TRIANGULAR_H
+#define TRIANGULAR_H
+
+#include <cstddef>
+#include "matrix_view.h"
+
+namespace kernels {
+
+// Row block size for the blocked triangular solves
+constexpr size_t TRSM_BLOCK = 64;
+
+// Triangular solves with multiple right-hand sides, in place: B (n x k)
+// is overwritten with X. Only the relevant triangle of the n x n factor
+// is read, so packed factorizations (LU, Cholesky) can be passed as is,
+// and a transposed factor is just a view with swapped strides.
+//
+// Both are blocked: after each diagonal block is solved, the rest of B is
+// updated with one GEMM call. B must have unit column stride.
+
+// Solve L * X = B for lower-triangular L
+void solveLower(ConstMatrixView L, MatrixView B, bool unit_diagonal);
+
+// Solve U * X = B for upper-triangular U
+void solveUpper(ConstMatrixView U, MatrixView B, bool unit_diagonal);
+
+} // namespace kernels
+
+#endif // TRIANGULAR_H
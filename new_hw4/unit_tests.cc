@@ -3,6 +3,37 @@
 #include <float.h>
 #include <assert.h>
 #include "matrix.h"
+#include "gemm.h"
+#include "thread_pool.h"
+#include "transpose.h"
+#include "strassen.h"
+#include "batched.h"
+#include "lu.h"
+#include "cholesky.h"
+#include "qr.h"
+#include "eigen.h"
+#include "svd.h"
+#include "sparse_matrix.h"
+#include "krylov.h"
+#include "preconditioner.h"
+#include "matrix_io.h"
+#include "tiled_matrix.h"
+#include "matrix_text.h"
+#include "elementwise.h"
+#include "fixed_matrix.h"
+#include "vector.h"
+#include "gemv.h"
+#include "reduce.h"
+#include "shared_matrix.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <type_traits>
+#include <thread>
 #include "gtest/gtest.h"
 
 namespace {
@@ -118,146 +149,2922 @@ TEST(MatrixConstructors, SelfAssignment) {
     EXPECT_DOUBLE_EQ(1.0, m(0, 0));
 }
 
+TEST(MatrixConstructors, MoveConstructor) {
+    Matrix m1 = {{1, 2},
+                 {3, 4}};
+    const double* buffer = m1.data();
+    Matrix m2(std::move(m1));
+    
+    EXPECT_EQ(buffer, m2.data());
+    EXPECT_DOUBLE_EQ(4.0, m2(1, 1));
+    EXPECT_TRUE(m1.isEmpty());
+}
+
+TEST(MatrixConstructors, MoveAssignment) {
+    Matrix m1 = {{1, 2},
+                 {3, 4}};
+    const double* buffer = m1.data();
+    Matrix m2(5, 5);
+    m2 = std::move(m1);
+    
+    EXPECT_EQ(buffer, m2.data());
+    EXPECT_EQ(2, m2.rows());
+    EXPECT_EQ(0, m1.rows());
+    EXPECT_EQ(0, m1.cols());
+}
+
 // ========== ADDITION TESTS ==========
 
-TEST(MatrixAddition, BasicAddition) {
-    Matrix m1 = {{1, 2},
-                 {3, 4}};
-    Matrix m2 = {{5, 6},
-                 {7, 8}};
-    Matrix result = m1 + m2;
+TEST(MatrixAddition, BasicAddition) {
+    Matrix m1 = {{1, 2},
+                 {3, 4}};
+    Matrix m2 = {{5, 6},
+                 {7, 8}};
+    Matrix result = m1 + m2;
+    
+    EXPECT_EQ(2, result.rows());
+    EXPECT_EQ(2, result.cols());
+    EXPECT_DOUBLE_EQ(6.0, result(0, 0));
+    EXPECT_DOUBLE_EQ(8.0, result(0, 1));
+    EXPECT_DOUBLE_EQ(10.0, result(1, 0));
+    EXPECT_DOUBLE_EQ(12.0, result(1, 1));
+}
+
+TEST(MatrixAddition, AdditionWithNegatives) {
+    Matrix m1 = {{1, -2},
+                 {-3, 4}};
+    Matrix m2 = {{-1, 2},
+                 {3, -4}};
+    Matrix result = m1 + m2;
+    
+    EXPECT_DOUBLE_EQ(0.0, result(0, 0));
+    EXPECT_DOUBLE_EQ(0.0, result(0, 1));
+    EXPECT_DOUBLE_EQ(0.0, result(1, 0));
+    EXPECT_DOUBLE_EQ(0.0, result(1, 1));
+}
+
+TEST(MatrixAddition, AdditionWithZero) {
+    Matrix m1 = {{1, 2},
+                 {3, 4}};
+    Matrix zero = Matrix::zeros(2, 2);
+    Matrix result = m1 + zero;
+    
+    EXPECT_EQ(m1, result);
+}
+
+TEST(MatrixAddition, AdditionNonSquare) {
+    Matrix m1 = {{1, 2, 3},
+                 {4, 5, 6}};
+    Matrix m2 = {{7, 8, 9},
+                 {10, 11, 12}};
+    Matrix result = m1 + m2;
+    
+    EXPECT_EQ(2, result.rows());
+    EXPECT_EQ(3, result.cols());
+    EXPECT_DOUBLE_EQ(8.0, result(0, 0));
+    EXPECT_DOUBLE_EQ(10.0, result(0, 1));
+    EXPECT_DOUBLE_EQ(12.0, result(0, 2));
+}
+
+TEST(MatrixAddition, DimensionMismatchRows) {
+    Matrix m1(2, 3);
+    Matrix m2(3, 3);
+    bool threw = false;
+    try {
+        Matrix result = m1 + m2;
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+TEST(MatrixAddition, DimensionMismatchCols) {
+    Matrix m1(3, 2);
+    Matrix m2(3, 3);
+    bool threw = false;
+    try {
+        Matrix result = m1 + m2;
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+TEST(MatrixAddition, CompoundAddition) {
+    Matrix m1 = {{1, 2},
+                 {3, 4}};
+    Matrix m2 = {{5, 6},
+                 {7, 8}};
+    Matrix& result = (m1 += m2);
+    
+    EXPECT_EQ(&m1, &result);  // Should return reference to self
+    EXPECT_DOUBLE_EQ(6.0, m1(0, 0));
+    EXPECT_DOUBLE_EQ(8.0, m1(0, 1));
+    EXPECT_DOUBLE_EQ(10.0, m1(1, 0));
+    EXPECT_DOUBLE_EQ(12.0, m1(1, 1));
+}
+
+TEST(MatrixAddition, CompoundAdditionChaining) {
+    Matrix m1 = {{1, 1},
+                 {1, 1}};
+    Matrix m2 = {{1, 1},
+                 {1, 1}};
+    Matrix m3 = {{1, 1},
+                 {1, 1}};
+    
+    m1 += m2 += m3;
+    
+    EXPECT_DOUBLE_EQ(3.0, m1(0, 0));
+    EXPECT_DOUBLE_EQ(2.0, m2(0, 0));
+}
+
+TEST(MatrixAddition, Associativity) {
+    Matrix m1 = {{1, 2},
+                 {3, 4}};
+    Matrix m2 = {{5, 6},
+                 {7, 8}};
+    Matrix m3 = {{9, 10},
+                 {11, 12}};
+    
+    Matrix result1 = (m1 + m2) + m3;
+    Matrix result2 = m1 + (m2 + m3);
+    
+    EXPECT_EQ(result1, result2);
+}
+
+TEST(MatrixAddition, Commutativity) {
+    Matrix m1 = {{1, 2},
+                 {3, 4}};
+    Matrix m2 = {{5, 6},
+                 {7, 8}};
+    
+    Matrix result1 = m1 + m2;
+    Matrix result2 = m2 + m1;
+    
+    EXPECT_EQ(result1, result2);
+}
+
+TEST(MatrixAddition, LargeMatrix) {
+    Matrix m1 = Matrix::ones(100, 100);
+    Matrix m2 = Matrix::ones(100, 100);
+    Matrix result = m1 + m2;
+    
+    EXPECT_EQ(100, result.rows());
+    EXPECT_EQ(100, result.cols());
+    EXPECT_DOUBLE_EQ(2.0, result(0, 0));
+    EXPECT_DOUBLE_EQ(2.0, result(99, 99));
+}
+
+// ========== MULTIPLICATION TESTS ==========
+
+// Straightforward i-j-k product used as a reference for the fast kernels
+Matrix referenceMultiply(const Matrix& a, const Matrix& b) {
+    Matrix result(a.rows(), b.cols());
+    for (size_t i = 0; i < a.rows(); ++i) {
+        for (size_t j = 0; j < b.cols(); ++j) {
+            double sum = 0.0;
+            for (size_t k = 0; k < a.cols(); ++k) {
+                sum += a(i, k) * b(k, j);
+            }
+            result(i, j) = sum;
+        }
+    }
+    return result;
+}
+
+// Deterministic, non-trivial fill so kernel bugs show up as mismatches
+Matrix patternMatrix(size_t rows, size_t cols, double seed) {
+    Matrix m(rows, cols);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            m(i, j) = std::sin(seed + 0.37 * i + 0.11 * j);
+        }
+    }
+    return m;
+}
+
+TEST(MatrixMultiplication, BasicMultiplication) {
+    Matrix m1 = {{1, 2},
+                 {3, 4}};
+    Matrix m2 = {{5, 6},
+                 {7, 8}};
+    Matrix result = m1 * m2;
+    
+    EXPECT_DOUBLE_EQ(19.0, result(0, 0));
+    EXPECT_DOUBLE_EQ(22.0, result(0, 1));
+    EXPECT_DOUBLE_EQ(43.0, result(1, 0));
+    EXPECT_DOUBLE_EQ(50.0, result(1, 1));
+}
+
+TEST(MatrixMultiplication, NonSquare) {
+    Matrix m1 = {{1, 2, 3},
+                 {4, 5, 6}};
+    Matrix m2 = {{7, 8},
+                 {9, 10},
+                 {11, 12}};
+    Matrix result = m1 * m2;
+    
+    EXPECT_EQ(2, result.rows());
+    EXPECT_EQ(2, result.cols());
+    EXPECT_DOUBLE_EQ(58.0, result(0, 0));
+    EXPECT_DOUBLE_EQ(64.0, result(0, 1));
+    EXPECT_DOUBLE_EQ(139.0, result(1, 0));
+    EXPECT_DOUBLE_EQ(154.0, result(1, 1));
+}
+
+TEST(MatrixMultiplication, DimensionMismatch) {
+    Matrix m1(2, 3);
+    Matrix m2(2, 3);
+    bool threw = false;
+    try {
+        Matrix result = m1 * m2;
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+TEST(MatrixMultiplication, IdentityIsNeutral) {
+    Matrix m = patternMatrix(70, 70, 0.5);
+    Matrix I = Matrix::identity(70);
+    
+    EXPECT_EQ(m, m * I);
+    EXPECT_EQ(m, I * m);
+}
+
+TEST(MatrixMultiplication, BlockedMatchesReference) {
+    // Odd sizes exercise partial register tiles and a K loop longer than KC
+    Matrix a = patternMatrix(101, 300, 0.1);
+    Matrix b = patternMatrix(300, 37, 0.7);
+    
+    EXPECT_EQ(referenceMultiply(a, b), a * b);
+}
+
+TEST(MatrixMultiplication, BlockedKernelWithStrides) {
+    // Multiply A^T * B by handing the kernel swapped strides for A
+    Matrix a = patternMatrix(40, 29, 0.3);
+    Matrix b = patternMatrix(40, 23, 0.9);
+    Matrix c(29, 23);
+    kernels::gemmBlocked(29, 23, 40, 1.0,
+                         &a(0, 0), 1, a.cols(),
+                         &b(0, 0), b.cols(), 1,
+                         &c(0, 0), c.cols());
+    
+    EXPECT_EQ(referenceMultiply(a.transpose(), b), c);
+}
+
+TEST(MatrixMultiplication, SmallKernelAccumulates) {
+    Matrix a = {{1, 2},
+                {3, 4}};
+    Matrix c = Matrix::ones(2, 2);
+    kernels::gemmSmall(2, 2, 2, 2.0, &a(0, 0), 2, 1, &a(0, 0), 2, 1, &c(0, 0), 2);
+    
+    // C = 1 + 2 * A * A
+    EXPECT_DOUBLE_EQ(15.0, c(0, 0));
+    EXPECT_DOUBLE_EQ(21.0, c(0, 1));
+    EXPECT_DOUBLE_EQ(31.0, c(1, 0));
+    EXPECT_DOUBLE_EQ(45.0, c(1, 1));
+}
+
+TEST(MatrixMultiplication, CompoundMultiplication) {
+    Matrix m1 = {{1, 2},
+                 {3, 4}};
+    Matrix m2 = {{0, 1},
+                 {1, 0}};
+    m1 *= m2;
+    
+    EXPECT_DOUBLE_EQ(2.0, m1(0, 0));
+    EXPECT_DOUBLE_EQ(1.0, m1(0, 1));
+    EXPECT_DOUBLE_EQ(4.0, m1(1, 0));
+    EXPECT_DOUBLE_EQ(3.0, m1(1, 1));
+}
+
+// ========== PARALLEL MULTIPLICATION TESTS ==========
+
+TEST(ThreadPool, RunsEveryIndexOnce) {
+    kernels::ThreadPool pool(4);
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallelFor(hits.size(), [&](size_t i) { hits[i]++; });
+    
+    for (const auto& hit : hits) {
+        EXPECT_EQ(1, hit.load());
+    }
+}
+
+TEST(ThreadPool, NestedCallsRunInline) {
+    kernels::ThreadPool pool(3);
+    std::atomic<int> total(0);
+    pool.parallelFor(8, [&](size_t) {
+        pool.parallelFor(8, [&](size_t) { total++; });
+    });
+    
+    EXPECT_EQ(64, total.load());
+}
+
+TEST(ThreadPool, PropagatesExceptions) {
+    kernels::ThreadPool pool(4);
+    bool threw = false;
+    try {
+        pool.parallelFor(100, [](size_t i) {
+            if (i == 42) {
+                throw std::runtime_error("task failed");
+            }
+        });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+    
+    // The pool stays usable after a failed job
+    std::atomic<int> count(0);
+    pool.parallelFor(10, [&](size_t) { count++; });
+    EXPECT_EQ(10, count.load());
+}
+
+TEST(MatrixParallelMultiplication, MatchesReference) {
+    size_t saved_threshold = kernels::gemmParallelThreshold();
+    kernels::setNumThreads(4);
+    kernels::setGemmParallelThreshold(0);
+    
+    Matrix a = patternMatrix(130, 90, 0.2);
+    Matrix b = patternMatrix(90, 75, 0.4);
+    Matrix result = a * b;
+    
+    kernels::setGemmParallelThreshold(saved_threshold);
+    kernels::setNumThreads(0);
+    EXPECT_EQ(referenceMultiply(a, b), result);
+}
+
+TEST(MatrixParallelMultiplication, CompoundMultiplication) {
+    size_t saved_threshold = kernels::gemmParallelThreshold();
+    kernels::setNumThreads(3);
+    kernels::setGemmParallelThreshold(0);
+    
+    Matrix a = patternMatrix(80, 80, 0.6);
+    Matrix b = patternMatrix(80, 80, 0.8);
+    Matrix expected = referenceMultiply(a, b);
+    a *= b;
+    
+    kernels::setGemmParallelThreshold(saved_threshold);
+    kernels::setNumThreads(0);
+    EXPECT_EQ(expected, a);
+}
+
+TEST(MatrixParallelMultiplication, ThreadCountIsConfigurable) {
+    kernels::setNumThreads(5);
+    EXPECT_EQ(5, kernels::numThreads());
+    kernels::setNumThreads(1);
+    EXPECT_EQ(1, kernels::numThreads());
+    kernels::setNumThreads(0);
+    EXPECT_LE(1, kernels::numThreads());
+}
+
+TEST(MatrixStrassen, MatchesClassicalProduct) {
+    // Odd and uneven shapes exercise the peeling at several levels
+    size_t shapes[][3] = {{64, 64, 64}, {101, 87, 93}, {130, 70, 75}, {33, 150, 41}};
+    for (auto& shape : shapes) {
+        size_t m = shape[0], n = shape[1], k = shape[2];
+        Matrix a = patternMatrix(m, k, 0.3);
+        Matrix b = patternMatrix(k, n, 0.8);
+        Matrix c(m, n, 99.0);
+        kernels::strassen(m, n, k, a.data(), k, b.data(), n, c.data(), n, 8);
+        
+        Matrix expected = referenceMultiply(a, b);
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                EXPECT_NEAR(expected(i, j), c(i, j), 1e-10);
+            }
+        }
+    }
+}
+
+TEST(MatrixStrassen, ParallelTopLevel) {
+    Matrix a = patternMatrix(90, 70, 0.1);
+    Matrix b = patternMatrix(70, 85, 0.5);
+    
+    // Operands and result are blocks of larger matrices
+    Matrix big_a(95, 80);
+    Matrix big_c(92, 90);
+    big_a.block(2, 3, 90, 70) = a;
+    kernels::setNumThreads(4);
+    kernels::strassen(90, 85, 70, big_a.data() + 2 * 80 + 3, 80, b.data(), 85,
+                      big_c.data() + 90 + 1, 90, 10);
+    kernels::setNumThreads(0);
+    
+    Matrix expected = referenceMultiply(a, b);
+    Matrix result = big_c.block(1, 1, 90, 85);
+    for (size_t i = 0; i < 90; ++i) {
+        for (size_t j = 0; j < 85; ++j) {
+            EXPECT_NEAR(expected(i, j), result(i, j), 1e-10);
+        }
+    }
+    EXPECT_DOUBLE_EQ(0.0, big_c(0, 0));
+    EXPECT_DOUBLE_EQ(0.0, big_c(91, 89));
+}
+
+TEST(MatrixStrassen, MatrixProductsUseThreshold) {
+    size_t saved_threshold = kernels::strassenThreshold();
+    EXPECT_EQ(0u, saved_threshold);  // Opt-in
+    kernels::setStrassenThreshold(40);
+    EXPECT_TRUE(kernels::useStrassen(40, 50, 60));
+    EXPECT_FALSE(kernels::useStrassen(39, 50, 60));
+    
+    Matrix a = patternMatrix(50, 45, 0.2);
+    Matrix b = patternMatrix(45, 60, 0.6);
+    Matrix product = a * b;
+    Matrix into(50, 60);
+    multiply_into(a, b, MatrixView(into));
+    
+    kernels::setStrassenThreshold(0);
+    EXPECT_FALSE(kernels::useStrassen(5000, 5000, 5000));
+    kernels::setStrassenThreshold(saved_threshold);
+    EXPECT_EQ(referenceMultiply(a, b), product);
+    EXPECT_EQ(product, into);
+}
+
+// ========== BATCHED MULTIPLY TESTS ==========
+
+// batch rows x cols pattern matrices, contiguous
+std::vector<double> patternBatch(size_t batch, size_t rows, size_t cols, double seed) {
+    std::vector<double> data;
+    for (size_t b = 0; b < batch; ++b) {
+        Matrix m = patternMatrix(rows, cols, seed + 0.1 * b);
+        data.insert(data.end(), m.data(), m.data() + rows * cols);
+    }
+    return data;
+}
+
+// Check every product in a contiguous batch against referenceMultiply
+void expectBatchProducts(size_t batch, size_t m, size_t n, size_t k,
+                         const std::vector<double>& a, const std::vector<double>& b,
+                         const std::vector<double>& c) {
+    for (size_t t = 0; t < batch; ++t) {
+        Matrix a_t(m, k), b_t(k, n);
+        std::copy(a.begin() + t * m * k, a.begin() + (t + 1) * m * k, a_t.data());
+        std::copy(b.begin() + t * k * n, b.begin() + (t + 1) * k * n, b_t.data());
+        Matrix expected = referenceMultiply(a_t, b_t);
+        for (size_t e = 0; e < m * n; ++e) {
+            EXPECT_NEAR(expected.data()[e], c[t * m * n + e], 1e-12);
+        }
+    }
+}
+
+TEST(MatrixBatched, ContiguousMatchesReference) {
+    // Unrolled square sizes and a generic rectangular shape
+    size_t shapes[][3] = {{2, 2, 2}, {3, 3, 3}, {4, 4, 4}, {8, 8, 8}, {2, 5, 3}};
+    for (auto& shape : shapes) {
+        size_t m = shape[0], n = shape[1], k = shape[2], batch = 21;
+        std::vector<double> a = patternBatch(batch, m, k, 0.2);
+        std::vector<double> b = patternBatch(batch, k, n, 0.7);
+        std::vector<double> c(batch * m * n, 99.0);
+        kernels::batchedMultiply(batch, m, n, k, a.data(), b.data(), c.data());
+        
+        expectBatchProducts(batch, m, n, k, a, b, c);
+    }
+}
+
+TEST(MatrixBatched, InterleaveRoundTrip) {
+    size_t lanes = kernels::BATCH_LANES;
+    size_t batch = lanes + 3;
+    std::vector<double> a = patternBatch(batch, 3, 2, 0.4);
+    ASSERT_EQ(2 * lanes * 6, kernels::interleavedSize(batch, 3, 2));
+    std::vector<double> mixed(kernels::interleavedSize(batch, 3, 2), 99.0);
+    std::vector<double> back(a.size());
+    kernels::interleave(batch, 3, 2, a.data(), mixed.data());
+    kernels::deinterleave(batch, 3, 2, mixed.data(), back.data());
+    
+    EXPECT_EQ(a[1 * 6 + 4], mixed[4 * lanes + 1]);  // Element 4 of matrix 1
+    EXPECT_EQ(a[(lanes + 2) * 6 + 5], mixed[6 * lanes + 5 * lanes + 2]);
+    EXPECT_EQ(0.0, mixed.back());  // Padding lane
+    EXPECT_EQ(a, back);
+}
+
+TEST(MatrixBatched, InterleavedMatchesReference) {
+    // Batch sizes that leave a partial lane block
+    size_t shapes[][3] = {{3, 3, 3}, {4, 4, 4}, {6, 6, 6}, {3, 1, 3}};
+    for (auto& shape : shapes) {
+        size_t m = shape[0], n = shape[1], k = shape[2], batch = 19;
+        std::vector<double> a = patternBatch(batch, m, k, 0.3);
+        std::vector<double> b = patternBatch(batch, k, n, 0.9);
+        std::vector<double> a_mixed(kernels::interleavedSize(batch, m, k));
+        std::vector<double> b_mixed(kernels::interleavedSize(batch, k, n));
+        kernels::interleave(batch, m, k, a.data(), a_mixed.data());
+        kernels::interleave(batch, k, n, b.data(), b_mixed.data());
+        
+        std::vector<double> c_mixed(kernels::interleavedSize(batch, m, n), 99.0);
+        std::vector<double> c(batch * m * n);
+        kernels::batchedMultiplyInterleaved(batch, m, n, k, a_mixed.data(), b_mixed.data(),
+                                            c_mixed.data());
+        kernels::deinterleave(batch, m, n, c_mixed.data(), c.data());
+        
+        expectBatchProducts(batch, m, n, k, a, b, c);
+    }
+}
+
+TEST(MatrixBatched, ParallelBatches) {
+    size_t batch = 203;
+    std::vector<double> a = patternBatch(batch, 4, 4, 0.5);
+    std::vector<double> b = patternBatch(batch, 4, 4, 0.1);
+    std::vector<double> a_mixed(kernels::interleavedSize(batch, 4, 4));
+    std::vector<double> b_mixed(a_mixed.size()), c_mixed(a_mixed.size());
+    kernels::interleave(batch, 4, 4, a.data(), a_mixed.data());
+    kernels::interleave(batch, 4, 4, b.data(), b_mixed.data());
+    
+    std::vector<double> c(a.size()), c_back(a.size());
+    size_t saved_threshold = kernels::gemmParallelThreshold();
+    kernels::setGemmParallelThreshold(1);
+    kernels::setNumThreads(4);
+    kernels::batchedMultiply(batch, 4, 4, 4, a.data(), b.data(), c.data());
+    kernels::batchedMultiplyInterleaved(batch, 4, 4, 4, a_mixed.data(), b_mixed.data(),
+                                        c_mixed.data());
+    kernels::setNumThreads(0);
+    kernels::setGemmParallelThreshold(saved_threshold);
+    kernels::deinterleave(batch, 4, 4, c_mixed.data(), c_back.data());
+    
+    expectBatchProducts(batch, 4, 4, 4, a, b, c);
+    expectBatchProducts(batch, 4, 4, 4, a, b, c_back);
+}
+
+// ========== EXPRESSION TEMPLATE TESTS ==========
+
+TEST(MatrixExpressions, ElementWiseOperatorsAreLazy) {
+    Matrix a(2, 2);
+    Matrix b(2, 2);
+    
+    EXPECT_FALSE((std::is_same<decltype(a + b), Matrix>::value));
+    EXPECT_FALSE((std::is_same<decltype(a - b * 2.0), Matrix>::value));
+    EXPECT_FALSE((std::is_same<decltype(-a / 2.0), Matrix>::value));
+    EXPECT_TRUE((std::is_same<decltype(a * b), Matrix>::value));
+}
+
+TEST(MatrixExpressions, FusedExpression) {
+    Matrix a = {{1, 2},
+                {3, 4}};
+    Matrix b = {{5, 6},
+                {7, 8}};
+    Matrix c = {{1, 1},
+                {1, 1}};
+    Matrix result = a + b * 2.0 - c;
+    
+    EXPECT_DOUBLE_EQ(10.0, result(0, 0));
+    EXPECT_DOUBLE_EQ(13.0, result(0, 1));
+    EXPECT_DOUBLE_EQ(16.0, result(1, 0));
+    EXPECT_DOUBLE_EQ(19.0, result(1, 1));
+}
+
+TEST(MatrixExpressions, ScalarOperators) {
+    Matrix a = {{2, -4},
+                {6, 8}};
+    Matrix scaled = 0.5 * a;
+    Matrix divided = a / 2.0;
+    Matrix negated = -a;
+    
+    EXPECT_EQ(scaled, divided);
+    EXPECT_DOUBLE_EQ(-2.0, negated(0, 0));
+    EXPECT_DOUBLE_EQ(4.0, negated(0, 1));
+    EXPECT_DOUBLE_EQ(-8.0, negated(1, 1));
+}
+
+TEST(MatrixExpressions, DivisionByZero) {
+    Matrix a = Matrix::ones(2, 2);
+    bool threw = false;
+    try {
+        Matrix result = (a + a) / 0.0;
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+TEST(MatrixExpressions, NestedDimensionMismatch) {
+    Matrix a(2, 2);
+    Matrix b(2, 2);
+    Matrix c(2, 3);
+    bool threw = false;
+    try {
+        Matrix result = (a + b) * 3.0 - c;
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+TEST(MatrixExpressions, AssignmentReadingTarget) {
+    Matrix a = {{1, 2},
+                {3, 4}};
+    Matrix b = {{10, 20},
+                {30, 40}};
+    a = a * 2.0 + b - a;
+    
+    EXPECT_DOUBLE_EQ(11.0, a(0, 0));
+    EXPECT_DOUBLE_EQ(22.0, a(0, 1));
+    EXPECT_DOUBLE_EQ(33.0, a(1, 0));
+    EXPECT_DOUBLE_EQ(44.0, a(1, 1));
+}
+
+TEST(MatrixExpressions, AssignmentResizesTarget) {
+    Matrix target(1, 1);
+    Matrix a = Matrix::ones(2, 3);
+    target = a + a;
+    
+    EXPECT_EQ(2, target.rows());
+    EXPECT_EQ(3, target.cols());
+    EXPECT_EQ(Matrix(2, 3, 2.0), target);
+}
+
+TEST(MatrixExpressions, CompoundAssignment) {
+    Matrix a = Matrix::ones(2, 2);
+    Matrix b = {{1, 2},
+                {3, 4}};
+    a += b * 2.0;
+    a -= -b;
+    
+    EXPECT_DOUBLE_EQ(4.0, a(0, 0));
+    EXPECT_DOUBLE_EQ(13.0, a(1, 1));
+}
+
+TEST(MatrixExpressions, MatrixMethodsOnExpressions) {
+    Matrix a = {{1, 2},
+                {3, 4}};
+    Matrix b = Matrix::identity(2);
+    
+    EXPECT_DOUBLE_EQ(7.0, (a + b).trace());
+    EXPECT_DOUBLE_EQ(0.0, (a - a).norm());
+    EXPECT_EQ(a.transpose() * 2.0, (a * 2.0).transpose());
+    EXPECT_EQ(a, (a + b - b).eval());
+}
+
+TEST(MatrixExpressions, FullConstInterfaceOnExpressions) {
+    Matrix a = {{1, 2},
+                {3, 4}};
+    Matrix b = Matrix::identity(2);
+
+    EXPECT_EQ(2u, (a + b).rows());
+    EXPECT_EQ(2u, (a + b).cols());
+    EXPECT_FALSE((a + b).isEmpty());
+    EXPECT_TRUE((a * 2.0).isSquare());
+    EXPECT_FALSE((Matrix() * 2.0).isSquare());
+    EXPECT_DOUBLE_EQ(2.0, (a + b).at(0, 0));
+    EXPECT_THROW((a + b).at(2, 0), std::out_of_range);
+    EXPECT_EQ(Matrix({{0}, {3}}), (a - b).diagonal());
+
+    EXPECT_DOUBLE_EQ(12.0, (a + b).sum());
+    EXPECT_DOUBLE_EQ(-4.0, (-a).min());
+    EXPECT_DOUBLE_EQ(8.0, (a * 2.0).max());
+    EXPECT_EQ(Matrix({{3}, {7}}), (a - b + b).rowSums());
+    EXPECT_EQ(Matrix({{4, 6}}), (a + b - b).columnSums());
+
+    EXPECT_DOUBLE_EQ(-2.0, (a + b - b).determinant());
+    EXPECT_EQ(a.inverse(), (a * 1.0).inverse());
+    EXPECT_EQ(a.solve(b), (a + b - b).solve(b));
+}
+
+TEST(MatrixExpressions, ProductOfExpressions) {
+    Matrix a = {{1, 2},
+                {3, 4}};
+    Matrix b = {{1, 0},
+                {0, 1}};
+    Matrix product = (a + b) * (a - b);
+    Matrix expected = {{6, 10},
+                       {15, 21}};
+    
+    EXPECT_EQ(expected, product);
+    EXPECT_EQ(a * 2.0, (a * 2.0) * b);
+}
+
+// ========== ALLOCATION-FREE KERNEL TESTS ==========
+
+TEST(MatrixRvalueOperators, ReuseExpiringBuffer) {
+    Matrix a = {{1, 2},
+                {3, 4}};
+    Matrix b = Matrix::ones(2, 2);
+    
+    Matrix tmp = a * 1.0;
+    const double* buffer = tmp.data();
+    Matrix sum = std::move(tmp) + b;
+    EXPECT_EQ(buffer, sum.data());
+    EXPECT_DOUBLE_EQ(5.0, sum(1, 1));
+    
+    Matrix diff = b - std::move(sum);
+    EXPECT_EQ(buffer, diff.data());
+    EXPECT_DOUBLE_EQ(-4.0, diff(1, 1));
+    
+    Matrix scaled = -(std::move(diff) * 2.0);
+    EXPECT_EQ(buffer, scaled.data());
+    EXPECT_DOUBLE_EQ(8.0, scaled(1, 1));
+}
+
+TEST(MatrixRvalueOperators, ProductChains) {
+    Matrix a = {{1, 2},
+                {3, 4}};
+    Matrix i = Matrix::identity(2);
+    Matrix result = a * i + a * i - a;
+    
+    EXPECT_EQ(a, result);
+}
+
+TEST(MatrixIntoKernels, AddAndSubtract) {
+    Matrix a = {{1, 2},
+                {3, 4}};
+    Matrix b = {{4, 3},
+                {2, 1}};
+    Matrix out(2, 2);
+    const double* buffer = out.data();
+    
+    add_into(a, b, out);
+    EXPECT_EQ(Matrix(2, 2, 5.0), out);
+    subtract_into(out, b, out);
+    EXPECT_EQ(a, out);
+    EXPECT_EQ(buffer, out.data());
+}
+
+TEST(MatrixIntoKernels, Multiply) {
+    Matrix a = patternMatrix(30, 20, 0.1);
+    Matrix b = patternMatrix(20, 10, 0.2);
+    Matrix out(30, 10, 7.0);
+    const double* buffer = out.data();
+    
+    multiply_into(a, b, out);
+    EXPECT_EQ(referenceMultiply(a, b), out);
+    EXPECT_EQ(buffer, out.data());
+}
+
+TEST(MatrixIntoKernels, MultiplyRejectsAliasing) {
+    Matrix a = Matrix::identity(3);
+    bool threw = false;
+    try {
+        multiply_into(a, a, a);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+TEST(MatrixIntoKernels, TransposeResizesOutput) {
+    Matrix a = {{1, 2, 3},
+                {4, 5, 6}};
+    Matrix out;
+    transpose_into(a, out);
+    
+    EXPECT_EQ(a.transpose(), out);
+    EXPECT_EQ(3, out.rows());
+    EXPECT_EQ(2, out.cols());
+}
+
+TEST(MatrixIntoKernels, DimensionMismatch) {
+    Matrix a(2, 2);
+    Matrix b(3, 3);
+    Matrix out;
+    bool threw = false;
+    try {
+        add_into(a, b, out);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+TEST(MatrixBlasUpdates, GemmTransposeFlags) {
+    Matrix a = patternMatrix(30, 20, 0.1);
+    Matrix b = patternMatrix(20, 10, 0.2);
+    Matrix c0 = patternMatrix(30, 10, 0.3);
+    Matrix expected = 2.0 * referenceMultiply(a, b) + 0.5 * c0;
+    Matrix at = a.transpose();
+    Matrix bt = b.transpose();
+
+    Matrix c = c0;
+    const double* buffer = c.data();
+    gemm(2.0, a, false, b, false, 0.5, c);
+    EXPECT_EQ(expected, c);
+    EXPECT_EQ(buffer, c.data());
+
+    c = c0;
+    gemm(2.0, at, true, b, false, 0.5, c);
+    EXPECT_EQ(expected, c);
+    c = c0;
+    gemm(2.0, a, false, bt, true, 0.5, c);
+    EXPECT_EQ(expected, c);
+    c = c0;
+    gemm(2.0, at, true, bt, true, 0.5, c);
+    EXPECT_EQ(expected, c);
+}
+
+TEST(MatrixBlasUpdates, GemmBetaZeroDoesNotReadC) {
+    Matrix a = patternMatrix(8, 5, 0.4);
+    Matrix b = patternMatrix(5, 6, 0.5);
+    Matrix c(8, 6, std::numeric_limits<double>::quiet_NaN());
+
+    gemm(1.0, a, false, b, false, 0.0, c);
+    EXPECT_EQ(referenceMultiply(a, b), c);
+}
+
+TEST(MatrixBlasUpdates, GemmIntoViews) {
+    Matrix a = patternMatrix(12, 7, 0.6);
+    Matrix b = patternMatrix(7, 9, 0.7);
+    Matrix product = referenceMultiply(a, b);
+
+    // Block of a larger matrix: the rest is untouched
+    Matrix big(20, 20, 1.0);
+    gemm(1.0, a, false, b, false, 1.0, big.block(4, 5, 12, 9));
+    EXPECT_EQ(product + Matrix(12, 9, 1.0), Matrix(big.block(4, 5, 12, 9)));
+    EXPECT_DOUBLE_EQ(1.0, big(0, 0));
+    EXPECT_DOUBLE_EQ(1.0, big(19, 19));
+
+    // Column-major output (unit row stride)
+    Matrix storage(9, 12);
+    gemm(1.0, a, false, b, false, 0.0, MatrixView(storage.data(), 12, 9, 1, 12));
+    EXPECT_EQ(product.transpose(), storage);
+
+    // Neither stride is one
+    Matrix wide(12, 18);
+    gemm(1.0, a, false, b, false, 0.0, MatrixView(wide.data(), 12, 9, 18, 2));
+    EXPECT_EQ(product, Matrix(ConstMatrixView(wide.data(), 12, 9, 18, 2)));
+}
+
+TEST(MatrixBlasUpdates, GemmRejectsBadShapesAndAliasing) {
+    Matrix a = patternMatrix(4, 3, 0.8);
+    Matrix c(4, 4);
+    EXPECT_THROW(gemm(1.0, a, false, a, false, 0.0, c), std::invalid_argument);
+    EXPECT_THROW(gemm(1.0, a, false, a, true, 0.0, c.block(0, 0, 4, 3)), std::invalid_argument);
+
+    Matrix square = Matrix::identity(4);
+    EXPECT_THROW(gemm(1.0, square, false, square, false, 0.0, square), std::invalid_argument);
+}
+
+TEST(MatrixBlasUpdates, GemmUpdatesTrailingBlockInPlace) {
+    // C22 -= A21 * A12 within one matrix, as a blocked LU step does
+    Matrix m = patternMatrix(4, 4, 0.4);
+    Matrix expected = m;
+    expected.block(2, 2, 2, 2) = Matrix(m.block(2, 2, 2, 2)) -
+        referenceMultiply(Matrix(m.block(2, 0, 2, 2)), Matrix(m.block(0, 2, 2, 2)));
+    gemm(-1.0, m.block(2, 0, 2, 2), false, m.block(0, 2, 2, 2), false, 1.0, m.block(2, 2, 2, 2));
+    EXPECT_EQ(expected, m);
+
+    // Larger, with a transposed operand read from the same matrix
+    Matrix big = patternMatrix(40, 40, 0.2);
+    Matrix before = big;
+    gemm(-1.0, big.block(0, 0, 10, 30), true, big.block(0, 30, 10, 10), false, 1.0,
+         big.block(10, 30, 30, 10));
+    Matrix update = referenceMultiply(Matrix(before.block(0, 0, 10, 30)).transpose(),
+                                      Matrix(before.block(0, 30, 10, 10)));
+    EXPECT_EQ(Matrix(before.block(10, 30, 30, 10)) - update, Matrix(big.block(10, 30, 30, 10)));
+    EXPECT_EQ(Matrix(before.block(0, 0, 10, 40)), Matrix(big.block(0, 0, 10, 40)));
+
+    EXPECT_THROW(gemm(-1.0, m.block(1, 1, 2, 2), false, m.block(0, 2, 2, 2), false, 1.0,
+                      m.block(2, 2, 2, 2)),
+                 std::invalid_argument);
+}
+
+TEST(MatrixBlasUpdates, AxpyAndScal) {
+    Matrix x = patternMatrix(6, 5, 0.9);
+    Matrix y = patternMatrix(6, 5, 1.0);
+    Matrix expected = y + 3.0 * x;
+    const double* buffer = y.data();
+
+    axpy(3.0, x, y);
+    EXPECT_EQ(expected, y);
+    EXPECT_EQ(buffer, y.data());
+
+    scal(-0.5, y);
+    EXPECT_EQ(-0.5 * expected, y);
+
+    // Strided views, and x overlapping y through a different layout
+    Matrix s = {{1, 2},
+                {3, 4}};
+    axpy(1.0, ConstMatrixView(s.data(), 2, 2, 1, 2), s);
+    EXPECT_EQ((Matrix{{2, 5}, {5, 8}}), s);
+    scal(2.0, s.col(1));
+    EXPECT_EQ((Matrix{{2, 10}, {5, 16}}), s);
+
+    EXPECT_THROW(axpy(1.0, x, s), std::invalid_argument);
+}
+
+// ========== MATRIX VIEW TESTS ==========
+
+TEST(MatrixViews, BlockReadsAndWritesThrough) {
+    Matrix m = {{1, 2, 3},
+                {4, 5, 6},
+                {7, 8, 9}};
+    MatrixView b = m.block(1, 1, 2, 2);
+    
+    EXPECT_EQ(2, b.rows());
+    EXPECT_EQ(2, b.cols());
+    EXPECT_DOUBLE_EQ(5.0, b(0, 0));
+    EXPECT_DOUBLE_EQ(9.0, b(1, 1));
+    
+    b(0, 1) = 60;
+    b *= 2.0;
+    EXPECT_DOUBLE_EQ(120.0, m(1, 2));
+    EXPECT_DOUBLE_EQ(16.0, m(2, 1));
+    EXPECT_DOUBLE_EQ(1.0, m(0, 0));
+}
+
+TEST(MatrixViews, RowColAndDiagonal) {
+    Matrix m = {{1, 2, 3},
+                {4, 5, 6}};
+    ConstMatrixView r = m.row(1);
+    ConstMatrixView c = m.col(2);
+    ConstMatrixView d = m.diagonal_view();
+    
+    EXPECT_EQ(1, r.rows());
+    EXPECT_EQ(3, r.cols());
+    EXPECT_DOUBLE_EQ(5.0, r(0, 1));
+    EXPECT_EQ(2, c.rows());
+    EXPECT_DOUBLE_EQ(6.0, c(1, 0));
+    EXPECT_EQ(m.diagonal(), Matrix(d));
+    
+    m.diagonal_view().fill(0.0);
+    EXPECT_DOUBLE_EQ(0.0, m(1, 1));
+    EXPECT_DOUBLE_EQ(2.0, m(0, 1));
+}
+
+TEST(MatrixViews, BoundsChecking) {
+    Matrix m(3, 3);
+    bool threw = false;
+    try {
+        m.block(2, 2, 2, 1);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+    
+    bool threw_at = false;
+    try {
+        m.row(0).at(1, 0);
+    } catch (const std::out_of_range&) {
+        threw_at = true;
+    }
+    EXPECT_TRUE(threw_at);
+}
+
+TEST(MatrixViews, ElementWiseExpressions) {
+    Matrix m = {{1, 2, 3, 4},
+                {5, 6, 7, 8}};
+    Matrix sum = m.block(0, 0, 2, 2) + m.block(0, 2, 2, 2) * 10.0;
+    Matrix expected = {{31, 42},
+                       {75, 86}};
+    
+    EXPECT_EQ(expected, sum);
+    
+    m.block(0, 0, 2, 2) += Matrix::ones(2, 2);
+    m.row(1) -= m.row(0);
+    EXPECT_DOUBLE_EQ(2.0, m(0, 0));
+    EXPECT_DOUBLE_EQ(4.0, m(1, 0));
+    EXPECT_DOUBLE_EQ(4.0, m(1, 3));
+}
+
+TEST(MatrixViews, OverlappingAssignment) {
+    Matrix m = {{1, 2, 3, 4}};
+    // Shift right by one; a naive element loop would smear m(0, 0)
+    m.block(0, 1, 1, 3) = m.block(0, 0, 1, 3);
+    
+    Matrix expected = {{1, 1, 2, 3}};
+    EXPECT_EQ(expected, m);
+    
+    m = m.block(0, 1, 1, 2) * 2.0;
+    EXPECT_EQ(Matrix({{2, 4}}), m);
+}
+
+TEST(MatrixViews, MultiplyBlocksWithoutCopying) {
+    Matrix big = patternMatrix(90, 80, 0.3);
+    Matrix a = Matrix(big.block(5, 10, 70, 40));
+    Matrix b = Matrix(big.block(20, 30, 40, 50));
+    
+    Matrix product = big.block(5, 10, 70, 40) * big.block(20, 30, 40, 50);
+    EXPECT_EQ(referenceMultiply(a, b), product);
+    
+    // Multiply straight into the bottom-right block of another matrix
+    Matrix c = Matrix::ones(100, 100);
+    multiply_into(a, b, c.block(30, 50, 70, 50));
+    EXPECT_EQ(Matrix(referenceMultiply(a, b)), Matrix(c.block(30, 50, 70, 50)));
+    EXPECT_DOUBLE_EQ(1.0, c(29, 50));
+    EXPECT_DOUBLE_EQ(1.0, c(30, 49));
+}
+
+TEST(MatrixViews, MultiplyDisjointBlocksOfOneMatrix) {
+    // The blocks' address ranges interleave, but they share no element
+    Matrix m = patternMatrix(4, 4, 0.5);
+    Matrix expected = m;
+    expected.block(2, 2, 2, 2) =
+        referenceMultiply(Matrix(m.block(2, 0, 2, 2)), Matrix(m.block(0, 2, 2, 2)));
+    multiply_into(m.block(2, 0, 2, 2), m.block(0, 2, 2, 2), m.block(2, 2, 2, 2));
+    EXPECT_EQ(expected, m);
+
+    // Same for transposed views of one column-major buffer
+    Matrix storage = patternMatrix(4, 4, 0.9);
+    ConstMatrixView left(storage.data() + 2, 2, 2, 1, 4);
+    ConstMatrixView right(storage.data() + 8, 2, 2, 1, 4);
+    Matrix product = referenceMultiply(Matrix(left), Matrix(right));
+    multiply_into(left, right, MatrixView(storage.data() + 10, 2, 2, 1, 4));
+    EXPECT_EQ(product, Matrix(ConstMatrixView(storage.data() + 10, 2, 2, 1, 4)));
+
+    // Blocks that do share elements are still rejected
+    EXPECT_THROW(multiply_into(m.block(0, 0, 2, 2), m.block(1, 1, 2, 2), m.block(1, 0, 2, 2)),
+                 std::invalid_argument);
+    EXPECT_THROW(multiply_into(m.block(0, 0, 2, 3), m.block(0, 0, 3, 2), m.block(1, 2, 2, 2)),
+                 std::invalid_argument);
+}
+
+TEST(MatrixViews, TransposeOfView) {
+    Matrix m = patternMatrix(6, 5, 0.1);
+    Matrix t;
+    transpose_into(m.block(1, 1, 4, 3), t);
+    
+    EXPECT_EQ(Matrix(m.block(1, 1, 4, 3)).transpose(), t);
+}
+
+// ========== LINEAR SOLVER TESTS ==========
+
+// Diagonally dominant matrix, so it is well conditioned
+Matrix wellConditioned(size_t n, double seed) {
+    Matrix m = patternMatrix(n, n, seed);
+    for (size_t i = 0; i < n; ++i) {
+        m(i, i) += n;
+    }
+    return m;
+}
+
+TEST(MatrixLU, SolveSmallSystem) {
+    Matrix a = {{2, 1, 1},
+                {4, -6, 0},
+                {-2, 7, 2}};
+    Matrix b = {{5},
+                {-2},
+                {9}};
+    Matrix x = a.solve(b);
+    
+    EXPECT_NEAR(1.0, x(0, 0), 1e-12);
+    EXPECT_NEAR(1.0, x(1, 0), 1e-12);
+    EXPECT_NEAR(2.0, x(2, 0), 1e-12);
+}
+
+TEST(MatrixLU, Determinant) {
+    Matrix a = {{0, 2},
+                {3, 4}};  // Needs a row swap
+    Matrix b = {{6, 1, 1},
+                {4, -2, 5},
+                {2, 8, 7}};
+    
+    EXPECT_NEAR(-6.0, a.determinant(), 1e-12);
+    EXPECT_NEAR(-306.0, b.determinant(), 1e-9);
+    EXPECT_NEAR(1.0, Matrix::identity(4).determinant(), 1e-12);
+}
+
+TEST(MatrixLU, FactorsReproduceMatrix) {
+    Matrix a = patternMatrix(9, 9, 0.3);
+    LUDecomposition lu(a);
+    
+    EXPECT_EQ(lu.permutation() * a, lu.lower() * lu.upper());
+}
+
+TEST(MatrixLU, BlockedFactorizationSolves) {
+    // Larger than one panel, so the GEMM trailing update is exercised
+    size_t n = 150;
+    Matrix a = wellConditioned(n, 0.2);
+    Matrix b = patternMatrix(n, 3, 0.9);
+    Matrix x = LUDecomposition(a).solve(b);
+    
+    Matrix residual = a * x - b;
+    EXPECT_LT(residual.norm(), 1e-9);
+}
+
+TEST(MatrixLU, ReuseFactorization) {
+    Matrix a = wellConditioned(20, 0.4);
+    LUDecomposition lu(a);
+    
+    for (int k = 0; k < 3; ++k) {
+        std::vector<double> b(20, 1.0 + k);
+        std::vector<double> x = lu.solve(b);
+        Matrix xm(20, 1);
+        for (size_t i = 0; i < 20; ++i) {
+            xm(i, 0) = x[i];
+        }
+        EXPECT_EQ(Matrix(20, 1, 1.0 + k), a * xm);
+    }
+}
+
+TEST(MatrixLU, Inverse) {
+    Matrix a = wellConditioned(70, 0.1);
+    Matrix inv = a.inverse();
+    
+    EXPECT_EQ(Matrix::identity(70), a * inv);
+    EXPECT_EQ(Matrix::identity(70), inv * a);
+}
+
+TEST(MatrixLU, SingularMatrix) {
+    Matrix a = {{1, 2},
+                {2, 4}};
+    EXPECT_DOUBLE_EQ(0.0, a.determinant());
+    
+    bool threw = false;
+    try {
+        a.inverse();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+TEST(MatrixLU, NumericallySingularMatrix) {
+    // Rank 2, but rounding leaves a pivot of about 1e-16 instead of zero
+    Matrix a = {{1, 2, 3},
+                {4, 5, 6},
+                {7, 8, 9}};
+    EXPECT_TRUE(LUDecomposition(a).isSingular());
+    EXPECT_DOUBLE_EQ(0.0, a.determinant());
+    EXPECT_THROW(a.inverse(), std::runtime_error);
+    EXPECT_THROW(a.solve(Matrix::ones(3, 1)), std::runtime_error);
+
+    // Scale does not matter, only the pivots relative to the entries
+    Matrix tiny = Matrix::identity(3) * 1e-200;
+    EXPECT_FALSE(LUDecomposition(tiny).isSingular());
+    EXPECT_EQ(Matrix::identity(3), tiny.inverse() * 1e-200);
+}
+
+TEST(MatrixLU, NonSquare) {
+    Matrix a(2, 3);
+    bool threw = false;
+    try {
+        a.determinant();
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+TEST(MatrixCholesky, SmallKnownFactor) {
+    Matrix a = {{4, 12, -16},
+                {12, 37, -43},
+                {-16, -43, 98}};
+    CholeskyDecomposition chol(a);
+    Matrix expected = {{2, 0, 0},
+                       {6, 1, 0},
+                       {-8, 5, 3}};
+    
+    EXPECT_EQ(expected, chol.lower());
+    EXPECT_NEAR(36.0, chol.determinant(), 1e-9);
+}
+
+TEST(MatrixCholesky, BlockedFactorizationSolves) {
+    size_t n = 140;
+    Matrix b = patternMatrix(n, n, 0.7);
+    Matrix spd = b.transpose() * b + Matrix::identity(n) * static_cast<double>(n);
+    CholeskyDecomposition chol(spd);
+    
+    EXPECT_EQ(spd, chol.lower() * chol.lower().transpose());
+    
+    Matrix rhs = patternMatrix(n, 2, 0.1);
+    Matrix x = chol.solve(rhs);
+    EXPECT_LT((spd * x - rhs).norm(), 1e-9);
+}
+
+TEST(MatrixCholesky, NotPositiveDefinite) {
+    Matrix a = {{1, 2},
+                {2, 1}};
+    bool threw = false;
+    try {
+        CholeskyDecomposition chol(a);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+TEST(MatrixQR, FactorsReproduceMatrix) {
+    // Tall and wider than one panel, so the blocked WY update runs
+    Matrix a = patternMatrix(120, 75, 0.5);
+    QRDecomposition qr(a);
+    Matrix q = qr.q();
+    Matrix r = qr.r();
+    
+    EXPECT_EQ(120, q.rows());
+    EXPECT_EQ(75, q.cols());
+    EXPECT_EQ(a, q * r);
+    EXPECT_EQ(Matrix::identity(75), q.transpose() * q);
+    for (size_t i = 0; i < r.rows(); ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            EXPECT_DOUBLE_EQ(0.0, r(i, j));
+        }
+    }
+}
+
+TEST(MatrixQR, WideMatrix) {
+    Matrix a = patternMatrix(40, 70, 0.2);
+    QRDecomposition qr(a);
+    
+    EXPECT_EQ(a, qr.q() * qr.r());
+}
+
+TEST(MatrixQR, LeastSquaresMatchesNormalEquations) {
+    Matrix a = patternMatrix(90, 40, 0.8);
+    a.diagonal_view() += Matrix::ones(40, 1) * 5.0;  // Full column rank
+    Matrix b = patternMatrix(90, 2, 0.3);
+    Matrix x = QRDecomposition(a).solve(b);
+    Matrix at = a.transpose();
+    Matrix expected = (at * a).solve(at * b);
+    
+    EXPECT_EQ(expected, x);
+}
+
+TEST(MatrixQR, ExactOverdeterminedSystem) {
+    // Points on the line y = 2x + 1
+    Matrix a = {{1, 0},
+                {1, 1},
+                {1, 2},
+                {1, 3}};
+    Matrix b = {{1}, {3}, {5}, {7}};
+    Matrix x = QRDecomposition(a).solve(b);
+    
+    EXPECT_NEAR(1.0, x(0, 0), 1e-12);
+    EXPECT_NEAR(2.0, x(1, 0), 1e-12);
+}
+
+TEST(MatrixQR, ExtremeScales) {
+    // Squaring these entries overflows or underflows
+    for (double s : {1e200, 1e-170, 1e-200}) {
+        Matrix a = {{3 * s, 1 * s},
+                    {4 * s, 2 * s},
+                    {0, 1 * s}};
+        QRDecomposition qr(a);
+        Matrix r = qr.r();
+        EXPECT_NEAR(5.0, std::abs(r(0, 0) / s), 1e-12);
+        Matrix diff = qr.q() * r - a;
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t j = 0; j < 2; ++j) {
+                EXPECT_NEAR(0.0, diff(i, j) / s, 1e-12);
+            }
+        }
+
+        // Least squares for b = A * (1, 2)^T, so the solution is exact
+        Matrix b = {{5 * s}, {8 * s}, {2 * s}};
+        Matrix x = qr.solve(b);
+        EXPECT_NEAR(1.0, x(0, 0), 1e-12);
+        EXPECT_NEAR(2.0, x(1, 0), 1e-12);
+    }
+}
+
+TEST(MatrixQR, RankDeficientSolveRejected) {
+    // patternMatrix is rank 2, but rounding leaves R(i, i) of about 1e-16
+    Matrix a = patternMatrix(30, 12, 0.5);
+    EXPECT_THROW(QRDecomposition(a).solve(Matrix::ones(30, 1)), std::runtime_error);
+
+    // Two equal columns
+    Matrix b = {{1, 1},
+                {2, 2},
+                {3, 3 + 1e-17}};
+    EXPECT_THROW(QRDecomposition(b).solve(Matrix::ones(3, 1)), std::runtime_error);
+}
+
+TEST(MatrixQR, UnderdeterminedSolveRejected) {
+    Matrix a(2, 3, 1.0);
+    bool threw = false;
+    try {
+        QRDecomposition(a).solve(Matrix(2, 1));
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+// ========== MATRIX FUNCTION TESTS ==========
+
+TEST(MatrixFunctions, PowMatchesRepeatedMultiplication) {
+    Matrix a = patternMatrix(6, 6, 0.4) * 0.5;
+    Matrix expected = Matrix::identity(6);
+    for (int n = 0; n <= 13; ++n) {
+        EXPECT_EQ(expected, a.pow(n));
+        expected *= a;
+    }
+}
+
+TEST(MatrixFunctions, PowFibonacci) {
+    Matrix q = {{1, 1},
+                {1, 0}};
+    Matrix q30 = q.pow(30);
+    
+    EXPECT_DOUBLE_EQ(1346269.0, q30(0, 0));  // F(31)
+    EXPECT_DOUBLE_EQ(832040.0, q30(0, 1));   // F(30)
+}
+
+TEST(MatrixFunctions, NegativePowUsesInverse) {
+    Matrix a = wellConditioned(5, 0.6);
+    
+    EXPECT_EQ(Matrix::identity(5), a.pow(-3) * a.pow(3));
+    EXPECT_EQ(a.inverse(), a.pow(-1));
+}
+
+TEST(MatrixFunctions, PowRequiresSquareMatrix) {
+    Matrix a(2, 3, 1.0);
+    bool threw = false;
+    try {
+        a.pow(2);
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+    
+    Matrix singular(3, 3, 1.0);
+    threw = false;
+    try {
+        singular.pow(-2);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+TEST(MatrixFunctions, ExpmOfDiagonalMatrix) {
+    // Norms on both sides of the degree-13 range, so the scaled path runs
+    for (double d : {0.001, 0.2, 1.5, 4.0, 30.0}) {
+        Matrix e = Matrix::diagonal({d, -d, 0.5 * d}).expm();
+        
+        EXPECT_NEAR(1.0, e(0, 0) / std::exp(d), 1e-13);
+        EXPECT_NEAR(1.0, e(1, 1) / std::exp(-d), 1e-13);
+        EXPECT_NEAR(1.0, e(2, 2) / std::exp(0.5 * d), 1e-13);
+        EXPECT_EQ(0.0, e(0, 1));
+    }
+}
+
+TEST(MatrixFunctions, ExpmOfRotationGenerator) {
+    for (double t : {0.01, 0.5, 2.0, 10.0}) {
+        Matrix a = {{0, -t},
+                    {t, 0}};
+        Matrix expected = {{std::cos(t), -std::sin(t)},
+                           {std::sin(t), std::cos(t)}};
+        
+        EXPECT_LT((a.expm() - expected).norm(), 1e-12);
+    }
+}
+
+TEST(MatrixFunctions, ExpmOfNilpotentMatrix) {
+    Matrix a = {{0, 1, 0},
+                {0, 0, 1},
+                {0, 0, 0}};
+    Matrix expected = {{1, 1, 0.5},
+                       {0, 1, 1},
+                       {0, 0, 1}};
+    
+    EXPECT_EQ(expected, a.expm());
+}
+
+TEST(MatrixFunctions, ExpmOfNegationIsInverse) {
+    Matrix a = patternMatrix(8, 8, 0.2) * 2.0;
+    
+    EXPECT_EQ(Matrix::identity(8), a.expm() * (-a).expm());
+    EXPECT_EQ(Matrix::identity(4), Matrix(4, 4).expm());
+}
+
+// ========== EIGENVALUE AND SVD TESTS ==========
+
+// Symmetric, full-rank test matrix (entries depend on i + j and i * j)
+Matrix symmetricPattern(size_t n, double seed) {
+    Matrix m(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            m(i, j) = std::sin(seed + 0.37 * (i + j) + 0.13 * i * j);
+        }
+    }
+    return m;
+}
+
+// Full-rank general test matrix
+Matrix generalPattern(size_t rows, size_t cols, double seed) {
+    Matrix m(rows, cols);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            m(i, j) = std::sin(seed + 0.37 * i + 0.11 * j + 0.05 * i * j);
+        }
+    }
+    return m;
+}
+
+// Columns of q are orthonormal
+void expectOrthonormalColumns(const Matrix& q) {
+    EXPECT_EQ(Matrix::identity(q.cols()), q.transpose() * q);
+}
+
+TEST(MatrixEigen, SmallKnownEigenvalues) {
+    Matrix a = {{2, 1},
+                {1, 2}};
+    SymmetricEigenDecomposition eig(a);
+    
+    EXPECT_NEAR(1.0, eig.eigenvalues()[0], 1e-14);
+    EXPECT_NEAR(3.0, eig.eigenvalues()[1], 1e-14);
+    EXPECT_NEAR(std::abs(eig.eigenvectors()(0, 1)), std::sqrt(0.5), 1e-14);
+    
+    Matrix b = {{4, 0, 0},
+                {0, -1, 0},
+                {0, 0, 4}};
+    std::vector<double> expected = {-1.0, 4.0, 4.0};
+    EXPECT_EQ(expected, SymmetricEigenDecomposition(b).eigenvalues());
+}
+
+TEST(MatrixEigen, DecomposesLargerMatrices) {
+    // Sizes below, at and across several reduction panels
+    for (size_t n : {1, 5, 32, 33, 100}) {
+        Matrix a = symmetricPattern(n, 0.3);
+        SymmetricEigenDecomposition eig(a);
+        const Matrix& v = eig.eigenvectors();
+        const std::vector<double>& w = eig.eigenvalues();
+        
+        expectOrthonormalColumns(v);
+        EXPECT_EQ(a * v, v * Matrix::diagonal(w));
+        EXPECT_TRUE(std::is_sorted(w.begin(), w.end()));
+        EXPECT_NEAR(a.trace(), std::accumulate(w.begin(), w.end(), 0.0), 1e-10);
+    }
+}
+
+TEST(MatrixEigen, ReadsLowerTriangleOnly) {
+    Matrix a = symmetricPattern(40, 0.7);
+    Matrix lower = a;
+    for (size_t i = 0; i < 40; ++i) {
+        for (size_t j = i + 1; j < 40; ++j) {
+            lower(i, j) = 99.0;
+        }
+    }
+    
+    EXPECT_EQ(SymmetricEigenDecomposition(a).eigenvectors(),
+              SymmetricEigenDecomposition(lower).eigenvectors());
+}
+
+TEST(MatrixEigen, ValuesOnly) {
+    Matrix a = symmetricPattern(50, 0.1);
+    SymmetricEigenDecomposition full(a);
+    SymmetricEigenDecomposition values(a, false);
+    
+    EXPECT_FALSE(values.hasEigenvectors());
+    EXPECT_EQ(Matrix::diagonal(full.eigenvalues()), Matrix::diagonal(values.eigenvalues()));
+    EXPECT_THROW(values.eigenvectors(), std::logic_error);
+    EXPECT_THROW(SymmetricEigenDecomposition(Matrix(2, 3)), std::logic_error);
+    EXPECT_EQ(0, SymmetricEigenDecomposition(Matrix()).size());
+}
+
+TEST(MatrixEigen, ExtremeScales) {
+    // Squared entries overflow at 1e200 and underflow at 1e-200
+    Matrix spd = {{2, 1, 0.5},
+                  {1, 3, 0.2},
+                  {0.5, 0.2, 1}};
+    Matrix pattern = symmetricPattern(40, 0.6);
+    for (const Matrix* a : {&spd, &pattern}) {
+        std::vector<double> expected = SymmetricEigenDecomposition(*a, false).eigenvalues();
+        for (double s : {1e200, 1e-200}) {
+            SymmetricEigenDecomposition eig(*a * s);
+            for (size_t i = 0; i < expected.size(); ++i) {
+                EXPECT_NEAR(expected[i], eig.eigenvalues()[i] / s, 1e-12 * a->norm());
+            }
+            expectOrthonormalColumns(eig.eigenvectors());
+        }
+    }
+}
+
+TEST(MatrixSVD, ReconstructsTallWideAndSquare) {
+    for (auto shape : {std::make_pair(60, 20), std::make_pair(20, 60), std::make_pair(35, 35)}) {
+        Matrix a = generalPattern(shape.first, shape.second, 0.2);
+        SingularValueDecomposition svd(a);
+        const std::vector<double>& s = svd.singularValues();
+        
+        ASSERT_EQ(std::min(a.rows(), a.cols()), s.size());
+        EXPECT_EQ(a.rows(), svd.u().rows());
+        EXPECT_EQ(a.cols(), svd.v().rows());
+        EXPECT_TRUE(std::is_sorted(s.rbegin(), s.rend()));
+        expectOrthonormalColumns(svd.u());
+        expectOrthonormalColumns(svd.v());
+        EXPECT_EQ(a, svd.u() * Matrix::diagonal(s) * svd.v().transpose());
+    }
+}
+
+TEST(MatrixSVD, ParallelSweepsAndRotations) {
+    // Large enough for the threaded Jacobi rounds and QL rotations
+    kernels::setNumThreads(4);
+    Matrix a = generalPattern(150, 140, 0.4);
+    SingularValueDecomposition svd(a);
+    Matrix s = symmetricPattern(300, 0.8);
+    SymmetricEigenDecomposition eig(s);
+    kernels::setNumThreads(0);
+    
+    expectOrthonormalColumns(svd.v());
+    EXPECT_EQ(a, svd.u() * Matrix::diagonal(svd.singularValues()) * svd.v().transpose());
+    expectOrthonormalColumns(eig.eigenvectors());
+    EXPECT_EQ(s * eig.eigenvectors(), eig.eigenvectors() * Matrix::diagonal(eig.eigenvalues()));
+}
+
+TEST(MatrixSVD, RankDeficient) {
+    // patternMatrix is a sum of two outer products, so rank 2
+    Matrix a = patternMatrix(30, 12, 0.5);
+    SingularValueDecomposition svd(a);
+    
+    EXPECT_EQ(2u, svd.rank());
+    expectOrthonormalColumns(svd.u());
+    EXPECT_EQ(a, svd.u() * Matrix::diagonal(svd.singularValues()) * svd.v().transpose());
+    
+    SingularValueDecomposition zero(Matrix(4, 3));
+    EXPECT_EQ(0u, zero.rank());
+    expectOrthonormalColumns(zero.u());
+}
+
+TEST(MatrixSVD, MatchesEigenvaluesOfSymmetricPositiveDefinite) {
+    Matrix b = generalPattern(40, 40, 0.9);
+    Matrix a = b.transpose() * b;
+    std::vector<double> w = SymmetricEigenDecomposition(a, false).eigenvalues();
+    std::vector<double> s = SingularValueDecomposition(a).singularValues();
+    
+    for (size_t i = 0; i < w.size(); ++i) {
+        EXPECT_NEAR(w[w.size() - 1 - i], s[i], 1e-10 * s[0]);
+    }
+}
+
+TEST(MatrixSVD, ExtremeScales) {
+    Matrix small = {{1, 0.1},
+                    {0.1, 1}};
+    Matrix pattern = generalPattern(30, 20, 0.7);
+    for (const Matrix* a : {&small, &pattern}) {
+        std::vector<double> expected = SingularValueDecomposition(*a).singularValues();
+        for (double s : {1e200, 1e-170, 1e-200}) {
+            SingularValueDecomposition svd(*a * s);
+            for (size_t i = 0; i < expected.size(); ++i) {
+                EXPECT_NEAR(expected[i], svd.singularValues()[i] / s, 1e-12 * expected[0]);
+            }
+            expectOrthonormalColumns(svd.u());
+            expectOrthonormalColumns(svd.v());
+        }
+    }
+    EXPECT_NEAR(1.1, SingularValueDecomposition(small * 1e-170).singularValues()[0] / 1e-170,
+                1e-14);
+}
+
+// ========== SPARSE MATRIX TESTS ==========
+
+// Banded test matrix with a few entries per row
+SparseMatrix bandedSparse(size_t rows, size_t cols, double seed) {
+    std::vector<SparseMatrix::Triplet> triplets;
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = (i > 2 ? i - 2 : 0); j < std::min(cols, i + 3); j += 2) {
+            triplets.push_back({i, j, std::sin(seed + 0.37 * i + 0.11 * j)});
+        }
+    }
+    return SparseMatrix::fromTriplets(rows, cols, triplets);
+}
+
+TEST(SparseMatrix, DenseRoundTrip) {
+    Matrix dense = {{1, 0, 0},
+                    {0, 0, 2},
+                    {3, 4, 0}};
+    SparseMatrix s = SparseMatrix::fromDense(dense);
+    
+    EXPECT_EQ(4, s.nonZeros());
+    EXPECT_DOUBLE_EQ(2.0, s(1, 2));
+    EXPECT_DOUBLE_EQ(0.0, s(1, 1));
+    EXPECT_EQ(dense, s.toDense());
+    EXPECT_THROW(s.at(3, 0), std::out_of_range);
+}
+
+TEST(SparseMatrix, TripletsAreSortedAndSummed) {
+    SparseMatrix s = SparseMatrix::fromTriplets(2, 3, {{1, 2, 1.0}, {0, 1, 2.0},
+                                                       {1, 0, 3.0}, {1, 2, 4.0}});
+    
+    EXPECT_EQ(3, s.nonZeros());
+    EXPECT_EQ((std::vector<size_t>{0, 1, 3}), s.rowPointers());
+    EXPECT_EQ((std::vector<size_t>{1, 0, 2}), s.columnIndices());
+    EXPECT_DOUBLE_EQ(5.0, s(1, 2));
+    EXPECT_THROW(SparseMatrix::fromTriplets(2, 2, {{2, 0, 1.0}}), std::out_of_range);
+}
+
+TEST(SparseMatrix, InvalidCsrRejected) {
+    EXPECT_NO_THROW(SparseMatrix(2, 2, {0, 1, 2}, {1, 0}, {1.0, 2.0}));
+    EXPECT_THROW(SparseMatrix(2, 2, {0, 2, 2}, {1, 0}, {1.0, 2.0}), std::invalid_argument);
+    EXPECT_THROW(SparseMatrix(2, 2, {0, 1, 2}, {1, 2}, {1.0, 2.0}), std::invalid_argument);
+}
+
+TEST(SparseMatrix, VectorProduct) {
+    SparseMatrix s = bandedSparse(50, 40, 0.3);
+    std::vector<double> x(40);
+    Matrix x_col(40, 1);
+    for (size_t i = 0; i < 40; ++i) {
+        x[i] = x_col(i, 0) = std::cos(0.2 * i);
+    }
+    
+    std::vector<double> y = s * x;
+    Matrix expected = s.toDense() * x_col;
+    ASSERT_EQ(50, y.size());
+    for (size_t i = 0; i < 50; ++i) {
+        EXPECT_NEAR(expected(i, 0), y[i], 1e-12);
+    }
+    EXPECT_THROW(s * std::vector<double>(3), std::invalid_argument);
+}
+
+TEST(SparseMatrix, MatrixProduct) {
+    SparseMatrix s = bandedSparse(30, 20, 0.5);
+    Matrix b = patternMatrix(20, 7, 0.1);
+    
+    EXPECT_EQ(referenceMultiply(s.toDense(), b), s * b);
+    
+    // Strided operands need no copy
+    Matrix bt = b.transpose();
+    EXPECT_EQ(s * b, s * ConstMatrixView(bt.data(), 20, 7, 1, 20));
+}
+
+TEST(SparseMatrix, ParallelProductsMatchSerial) {
+    SparseMatrix s = bandedSparse(20000, 20000, 0.7);
+    std::vector<double> x(20000);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = std::cos(0.01 * i);
+    }
+    Matrix b(20000, 4);
+    for (size_t i = 0; i < b.rows(); ++i) {
+        for (size_t j = 0; j < b.cols(); ++j) {
+            b(i, j) = x[i] + j;
+        }
+    }
+    
+    kernels::setNumThreads(1);
+    std::vector<double> serial_y = s * x;
+    Matrix serial_c = s * b;
+    kernels::setNumThreads(4);
+    std::vector<double> parallel_y = s * x;
+    Matrix parallel_c = s * b;
+    kernels::setNumThreads(0);
+    
+    EXPECT_EQ(serial_y, parallel_y);
+    EXPECT_EQ(serial_c, parallel_c);
+}
+
+TEST(SparseMatrix, Transpose) {
+    SparseMatrix s = bandedSparse(12, 9, 0.2);
+    SparseMatrix t = s.transpose();
+    
+    EXPECT_EQ(9, t.rows());
+    EXPECT_EQ(12, t.cols());
+    EXPECT_EQ(s.nonZeros(), t.nonZeros());
+    EXPECT_EQ(s.toDense().transpose(), t.toDense());
+    EXPECT_EQ(s, t.transpose());
+}
+
+TEST(SparseMatrix, AdditionAndSubtraction) {
+    SparseMatrix a = bandedSparse(10, 10, 0.1);
+    SparseMatrix b = SparseMatrix::identity(10) * 2.0;
+    
+    EXPECT_EQ(a.toDense() + b.toDense(), (a + b).toDense());
+    EXPECT_EQ(a.toDense() - b.toDense(), (a - b).toDense());
+    EXPECT_EQ(SparseMatrix(10, 10), a - a);
+    EXPECT_THROW(a + SparseMatrix(10, 9), std::invalid_argument);
+}
+
+TEST(SparseMatrix, Prune) {
+    SparseMatrix a = bandedSparse(10, 10, 0.1);
+    SparseMatrix zero = a - a;
+    EXPECT_EQ(a.nonZeros(), zero.nonZeros());
+    
+    zero.prune();
+    EXPECT_EQ(0, zero.nonZeros());
+    EXPECT_EQ((std::vector<size_t>(11, 0)), zero.rowPointers());
+}
+
+TEST(SparseMatrix, NonFiniteEntriesAreKept) {
+    Matrix dense = {{NAN, 0, 1e-12},
+                    {0, INFINITY, 0}};
+    SparseMatrix s = SparseMatrix::fromDense(dense, 1e-9);
+    EXPECT_EQ(2, s.nonZeros());
+    EXPECT_TRUE(std::isnan(s(0, 0)));
+    EXPECT_TRUE(std::isinf(s(1, 1)));
+    
+    s.prune(1e300);
+    EXPECT_EQ(2, s.nonZeros());
+    EXPECT_TRUE(std::isnan(s.toDense()(0, 0)));
+    EXPECT_EQ(0.0, s.toDense()(0, 2));
+}
+
+// ========== ITERATIVE SOLVER TESTS ==========
+
+// 5-point Laplacian on a grid x grid mesh (SPD), optionally with a
+// convection term that makes it nonsymmetric
+SparseMatrix poisson2D(size_t grid, double convection = 0.0) {
+    std::vector<SparseMatrix::Triplet> triplets;
+    size_t n = grid * grid;
+    for (size_t i = 0; i < grid; ++i) {
+        for (size_t j = 0; j < grid; ++j) {
+            size_t row = i * grid + j;
+            triplets.push_back({row, row, 4.0});
+            if (i > 0) triplets.push_back({row, row - grid, -1.0 - convection});
+            if (i + 1 < grid) triplets.push_back({row, row + grid, -1.0 + convection});
+            if (j > 0) triplets.push_back({row, row - 1, -1.0});
+            if (j + 1 < grid) triplets.push_back({row, row + 1, -1.0});
+        }
+    }
+    return SparseMatrix::fromTriplets(n, n, triplets);
+}
+
+// Smooth right-hand side
+Vector rightHandSide(size_t n, double seed) {
+    Vector v(n);
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = std::sin(seed + 0.37 * i);
+    }
+    return v;
+}
+
+// ||b - A * x|| / ||b||
+double relativeResidual(const SparseMatrix& a, const Vector& b, const Vector& x) {
+    Vector ax;
+    multiply_into(a, x, ax);
+    return (b - ax).norm() / b.norm();
+}
+
+TEST(SparseMatrix, VectorKernel) {
+    SparseMatrix a = bandedSparse(40, 30, 0.2);
+    Vector x = rightHandSide(30, 0.5);
+    Vector y(3, 1.0);
+    
+    multiply_into(a, x, y);
+    EXPECT_EQ(a.toDense() * x, y);
+    EXPECT_THROW(multiply_into(a, y, x), std::invalid_argument);
+}
+
+TEST(KrylovSolvers, ConjugateGradientOnPoisson) {
+    SparseMatrix a = poisson2D(20);
+    Vector b = rightHandSide(a.rows(), 0.3);
+    Vector x;
+    
+    SolverResult result = ConjugateGradientSolver().solve(a, b, x);
+    EXPECT_TRUE(result.converged);
+    EXPECT_LT(relativeResidual(a, b, x), 1e-9);
+    EXPECT_EQ(result.iterations + 1, result.residual_history.size());
+    EXPECT_DOUBLE_EQ(1.0, result.residual_history.front());
+    EXPECT_DOUBLE_EQ(result.residual, result.residual_history.back());
+}
+
+TEST(KrylovSolvers, NonsymmetricSystems) {
+    SparseMatrix a = poisson2D(16, 0.4);
+    Vector b = rightHandSide(a.rows(), 0.7);
+    
+    Vector x;
+    SolverResult result = BiCGSTABSolver().solve(a, b, x);
+    EXPECT_TRUE(result.converged);
+    EXPECT_LT(relativeResidual(a, b, x), 1e-8);
+    
+    SolverOptions options;
+    options.restart = 20;
+    Vector y;
+    result = GMRESSolver().solve(a, b, y, options);
+    EXPECT_TRUE(result.converged);
+    EXPECT_GT(result.iterations, options.restart);
+    EXPECT_LE(result.residual, options.tolerance);
+    EXPECT_LT(relativeResidual(a, b, y), 1e-9);
+}
+
+TEST(KrylovSolvers, DenseAndCallbackOperators) {
+    Matrix dense = poisson2D(6, 0.2).toDense();
+    Vector b = rightHandSide(dense.rows(), 1.1);
+    Vector expected = Vector(LUDecomposition(dense).solve(b.toMatrix()));
+    
+    Vector x;
+    EXPECT_TRUE(GMRESSolver().solve(dense, b, x).converged);
+    EXPECT_EQ(expected, x);
+    
+    size_t products = 0;
+    LinearOperator op(dense.rows(), [&](const Vector& v, Vector& out) {
+        ++products;
+        multiply_into(dense, v, out);
+    });
+    Vector y;
+    SolverResult result = BiCGSTABSolver().solve(op, b, y);
+    EXPECT_TRUE(result.converged);
+    EXPECT_EQ(expected, y);
+    EXPECT_GE(products, 2 * result.iterations);
+}
+
+TEST(KrylovSolvers, PreconditionersReduceIterations) {
+    // Badly scaled rows hurt plain CG; Jacobi removes the scaling
+    SparseMatrix poisson = poisson2D(24);
+    auto scale = [](size_t i) { return 1.0 + 50.0 * (i % 7); };
+    std::vector<double> values = poisson.values();
+    for (size_t i = 0; i < poisson.rows(); ++i) {
+        for (size_t k = poisson.rowPointers()[i]; k < poisson.rowPointers()[i + 1]; ++k) {
+            values[k] *= scale(i) * scale(poisson.columnIndices()[k]);
+        }
+    }
+    SparseMatrix a(poisson.rows(), poisson.cols(), poisson.rowPointers(),
+                   poisson.columnIndices(), values);
+    Vector b = rightHandSide(a.rows(), 0.9);
+    
+    ConjugateGradientSolver cg;
+    SolverOptions options;
+    Vector x;
+    size_t plain = cg.solve(a, b, x, options).iterations;
+    
+    JacobiPreconditioner jacobi(a);
+    options.preconditioner = &jacobi;
+    x = Vector();
+    SolverResult result = cg.solve(a, b, x, options);
+    EXPECT_TRUE(result.converged);
+    EXPECT_LT(result.iterations, plain);
+    EXPECT_LT(relativeResidual(a, b, x), 1e-9);
+    
+    ILU0Preconditioner ilu(a);
+    options.preconditioner = &ilu;
+    x = Vector();
+    size_t ilu_iterations = GMRESSolver().solve(a, b, x, options).iterations;
+    EXPECT_LT(ilu_iterations, result.iterations);
+    EXPECT_LT(relativeResidual(a, b, x), 1e-9);
+}
+
+TEST(KrylovSolvers, ILU0IsExactForTridiagonal) {
+    // No fill-in is dropped, so M = A and one iteration suffices
+    std::vector<SparseMatrix::Triplet> triplets;
+    for (size_t i = 0; i < 50; ++i) {
+        triplets.push_back({i, i, 3.0 + std::sin(0.3 * i)});
+        if (i > 0) triplets.push_back({i, i - 1, -1.0});
+        if (i + 1 < 50) triplets.push_back({i, i + 1, -0.5});
+    }
+    SparseMatrix a = SparseMatrix::fromTriplets(50, 50, triplets);
+    ILU0Preconditioner ilu(a);
+    Vector b = rightHandSide(50, 0.2);
+    
+    Vector z;
+    ilu.apply(b, z);
+    EXPECT_LT(relativeResidual(a, b, z), 1e-14);
+    
+    SolverOptions options;
+    options.preconditioner = &ilu;
+    Vector x;
+    EXPECT_EQ(1, BiCGSTABSolver().solve(a, b, x, options).iterations);
+}
+
+TEST(KrylovSolvers, MonitorAndWorkspaceReuse) {
+    SparseMatrix a = poisson2D(12);
+    Vector b = rightHandSide(a.rows(), 0.4);
+    std::vector<double> seen;
+    SolverOptions options;
+    options.monitor = [&](size_t iteration, double residual) {
+        EXPECT_EQ(seen.size(), iteration);
+        seen.push_back(residual);
+    };
+    
+    GMRESSolver gmres;
+    Vector x;
+    SolverResult first = gmres.solve(a, b, x, options);
+    EXPECT_EQ(first.residual_history, seen);
+    
+    // Same solver, warm start from the solution: nothing left to do
+    seen.clear();
+    SolverResult second = gmres.solve(a, b, x, options);
+    EXPECT_TRUE(second.converged);
+    EXPECT_EQ(0, second.iterations);
+    EXPECT_EQ(1, seen.size());
+    
+    // Zero right-hand side gives x = 0 immediately
+    Vector zero(a.rows());
+    EXPECT_TRUE(ConjugateGradientSolver().solve(a, zero, x).converged);
+    EXPECT_EQ(Vector(a.rows()), x);
+}
+
+TEST(KrylovSolvers, IterationLimitAndErrors) {
+    SparseMatrix a = poisson2D(20);
+    Vector b = rightHandSide(a.rows(), 0.3);
+    SolverOptions options;
+    options.max_iterations = 5;
+    Vector x;
+    
+    SolverResult result = ConjugateGradientSolver().solve(a, b, x, options);
+    EXPECT_FALSE(result.converged);
+    EXPECT_EQ(5, result.iterations);
+    
+    EXPECT_THROW(ConjugateGradientSolver().solve(Matrix(3, 4), Vector(3), x),
+                 std::logic_error);
+    EXPECT_THROW(BiCGSTABSolver().solve(a, Vector(7), x), std::invalid_argument);
+    options.restart = 0;
+    EXPECT_THROW(GMRESSolver().solve(a, b, x, options), std::invalid_argument);
+    
+    JacobiPreconditioner small(SparseMatrix::identity(3));
+    options = SolverOptions();
+    options.preconditioner = &small;
+    EXPECT_THROW(ConjugateGradientSolver().solve(a, b, x, options), std::invalid_argument);
+    
+    EXPECT_THROW(JacobiPreconditioner(Matrix(2, 2)), std::runtime_error);
+    // Row 1 of the banded pattern has no diagonal entry
+    EXPECT_THROW(ILU0Preconditioner(bandedSparse(6, 6, 0.0)), std::runtime_error);
+    EXPECT_THROW(ILU0Preconditioner(SparseMatrix(3, 4)), std::logic_error);
+}
+
+// ========== BINARY I/O TESTS ==========
+
+std::string tempMatrixPath(const std::string& name) {
+    return ::testing::TempDir() + "matrix_io_" + name + ".bin";
+}
+
+TEST(MatrixBinaryIO, SaveAndLoadRoundTrip) {
+    Matrix m = patternMatrix(37, 23, 0.4);
+    std::string path = tempMatrixPath("round_trip");
+    saveBinary(m, path);
+    
+    Matrix loaded = loadBinary(path);
+    EXPECT_EQ(37, loaded.rows());
+    EXPECT_EQ(23, loaded.cols());
+    for (size_t i = 0; i < m.rows(); ++i) {
+        for (size_t j = 0; j < m.cols(); ++j) {
+            EXPECT_EQ(m(i, j), loaded(i, j));  // bit-exact
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST(MatrixBinaryIO, HeaderLayout) {
+    std::string path = tempMatrixPath("header");
+    saveBinary(Matrix(3, 5, 1.0), path);
+    
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    EXPECT_EQ(64 + 3 * 5 * sizeof(double), static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    MatrixFileHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    EXPECT_EQ(0, std::memcmp(header.magic, "MTRX", 4));
+    EXPECT_EQ(MatrixDataType::Float64, header.dtype);
+    EXPECT_EQ(hostByteOrder(), header.byte_order);
+    EXPECT_EQ(3, header.rows);
+    EXPECT_EQ(5, header.cols);
+    std::remove(path.c_str());
+}
+
+TEST(MatrixBinaryIO, ForeignByteOrderIsConverted) {
+    std::string path = tempMatrixPath("swapped");
+    MatrixFileHeader header = {};
+    std::memcpy(header.magic, "MTRX", 4);
+    header.version = MATRIX_FILE_VERSION;
+    header.dtype = MatrixDataType::Float64;
+    header.byte_order = hostByteOrder() == MatrixByteOrder::Little ?
+                        MatrixByteOrder::Big : MatrixByteOrder::Little;
+    header.rows = __builtin_bswap64(1);
+    header.cols = __builtin_bswap64(2);
+    double values[2] = {1.5, -2.25};
+    uint64_t words[2];
+    std::memcpy(words, values, sizeof(values));
+    words[0] = __builtin_bswap64(words[0]);
+    words[1] = __builtin_bswap64(words[1]);
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(words), sizeof(words));
+    }
+    
+    EXPECT_EQ(Matrix({{1.5, -2.25}}), loadBinary(path));
+    EXPECT_THROW(MappedMatrix mapped(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(MatrixBinaryIO, MalformedFilesRejected) {
+    std::string path = tempMatrixPath("malformed");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "this is not a matrix file, just some text padding it out to 64+ bytes";
+    }
+    EXPECT_THROW(loadBinary(path), std::runtime_error);
+    EXPECT_THROW(MappedMatrix mapped(path), std::runtime_error);
+    
+    // Header promises more elements than the file holds
+    saveBinary(Matrix(4, 4, 1.0), path);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::in);
+        MatrixFileHeader header;
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        header.rows = 5;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    EXPECT_THROW(loadBinary(path), std::runtime_error);
+    EXPECT_THROW(MappedMatrix mapped(path), std::runtime_error);
+
+    // Terabytes promised: rejected before anything is allocated
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::in);
+        MatrixFileHeader header;
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        header.rows = size_t(1) << 20;
+        header.cols = size_t(1) << 20;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    EXPECT_THROW(loadBinary(path), std::runtime_error);
+
+    std::remove(path.c_str());
+    EXPECT_THROW(loadBinary(path), std::runtime_error);
+}
+
+TEST(MatrixBinaryIO, MappedMatrixViewsFile) {
+    Matrix m = patternMatrix(40, 30, 0.9);
+    std::string path = tempMatrixPath("mapped");
+    saveBinary(m, path);
+    
+    MappedMatrix mapped(path);
+    EXPECT_EQ(40, mapped.rows());
+    EXPECT_EQ(30, mapped.cols());
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(mapped.data()) % 64);
+    EXPECT_EQ(m, mapped.toMatrix());
+    
+    // The view takes part in expressions and products without a copy
+    Matrix doubled = mapped.view() * 2.0;
+    EXPECT_EQ(m * 2.0, doubled);
+    EXPECT_EQ(m, mapped.view() * Matrix::identity(30));
+    
+    MappedMatrix moved(std::move(mapped));
+    EXPECT_EQ(40, moved.rows());
+    EXPECT_DOUBLE_EQ(m(3, 7), moved(3, 7));
+    std::remove(path.c_str());
+}
+
+TEST(MatrixBinaryIO, StreamingWriter) {
+    Matrix m = patternMatrix(25, 6, 0.2);
+    std::string path = tempMatrixPath("stream");
+    {
+        MatrixWriter writer(path, 6);
+        writer.writeRow(&m(0, 0));
+        writer.writeRows(m.block(1, 0, 10, 6));
+        
+        // Strided rows are gathered before writing
+        Matrix mt = m.transpose();
+        writer.writeRows(ConstMatrixView(mt.data() + 11, 14, 6, 1, 25));
+        EXPECT_EQ(25, writer.rows());
+        EXPECT_THROW(writer.writeRows(Matrix(1, 5)), std::invalid_argument);
+    }
+    EXPECT_EQ(m, loadBinary(path));
+    std::remove(path.c_str());
+}
+
+TEST(MatrixBinaryIO, EmptyMatrix) {
+    std::string path = tempMatrixPath("empty");
+    saveBinary(Matrix(0, 4), path);
+    
+    Matrix loaded = loadBinary(path);
+    EXPECT_EQ(0, loaded.rows());
+    EXPECT_EQ(4, loaded.cols());
+    MappedMatrix mapped(path);
+    EXPECT_EQ(0, mapped.rows());
+    std::remove(path.c_str());
+}
+
+// ========== TILED MATRIX TESTS ==========
+
+// Small tiles and a budget of a few tiles, so the tests exercise edge
+// tiles, eviction and write-back on tiny matrices
+TiledMatrixOptions smallTiles(size_t tile_size, size_t tiles_in_budget) {
+    TiledMatrixOptions options;
+    options.tile_size = tile_size;
+    options.memory_budget = tiles_in_budget * tile_size * tile_size * sizeof(double);
+    return options;
+}
+
+TEST(TiledMatrix, RoundTripThroughFile) {
+    Matrix m = patternMatrix(37, 23, 0.4);
+    std::string path = tempMatrixPath("tiled");
+    {
+        TiledMatrix tiled = TiledMatrix::fromMatrix(m, path, smallTiles(8, 4));
+        EXPECT_EQ(5, tiled.tileRows());
+        EXPECT_EQ(3, tiled.tileCols());
+        EXPECT_EQ(m(36, 22), tiled(36, 22));
+        EXPECT_EQ(m.block(8, 16, 8, 7), tiled.readTile(1, 2));
+        EXPECT_LE(tiled.cachedBytes(), tiled.memoryBudget());
+        EXPECT_GT(tiled.stats().evictions, 0);
+        
+        tiled.set(0, 0, 42.0);
+        EXPECT_THROW(tiled.at(37, 0), std::out_of_range);
+    }
+    
+    // Reopening sees every write, including those still cached at close
+    TiledMatrix reopened = TiledMatrix::open(path, smallTiles(16, 3));
+    EXPECT_EQ(8, reopened.tileSize());
+    m(0, 0) = 42.0;
+    EXPECT_EQ(m, reopened.toMatrix());
+    std::remove(path.c_str());
+    
+    EXPECT_THROW(TiledMatrix::open(path), std::runtime_error);
+    EXPECT_THROW(TiledMatrix::create("", 10, 10, smallTiles(8, 1)), std::invalid_argument);
+}
+
+TEST(TiledMatrix, MultiplyAndTranspose) {
+    Matrix a = patternMatrix(45, 30, 0.1);
+    Matrix b = patternMatrix(30, 19, 0.7);
+    TiledMatrix ta = TiledMatrix::fromMatrix(a, "", smallTiles(8, 6));
+    TiledMatrix tb = TiledMatrix::fromMatrix(b, "", smallTiles(8, 6));
+    
+    TiledMatrix product = ta * tb;
+    EXPECT_EQ(45, product.rows());
+    EXPECT_EQ(19, product.cols());
+    EXPECT_EQ(referenceMultiply(a, b), product.toMatrix());
+    EXPECT_EQ(a.transpose(), ta.transpose().toMatrix());
+    
+    EXPECT_THROW(ta * ta, std::invalid_argument);
+    TiledMatrix other_tiles = TiledMatrix::fromMatrix(b, "", smallTiles(4, 6));
+    EXPECT_THROW(ta * other_tiles, std::invalid_argument);
+    EXPECT_THROW(ta.multiply(tb, ta.path()), std::invalid_argument);
+}
+
+TEST(TiledMatrix, BudgetIsPerMatrix) {
+    // Two tiles per matrix is enough: one in use and one prefetched
+    Matrix a = patternMatrix(40, 32, 0.3);
+    Matrix b = patternMatrix(32, 24, 0.8);
+    TiledMatrix ta = TiledMatrix::fromMatrix(a, "", smallTiles(8, 2));
+    TiledMatrix tb = TiledMatrix::fromMatrix(b, "", smallTiles(8, 2));
+    
+    TiledMatrix product = ta * tb;
+    EXPECT_EQ(referenceMultiply(a, b), product.toMatrix());
+    EXPECT_EQ(ta.memoryBudget(), product.memoryBudget());
+    EXPECT_LE(ta.cachedBytes(), ta.memoryBudget());
+    EXPECT_LE(tb.cachedBytes(), tb.memoryBudget());
+    EXPECT_LE(product.cachedBytes(), product.memoryBudget());
+}
+
+TEST(TiledMatrix, ElementWiseOperations) {
+    Matrix a = patternMatrix(20, 13, 0.2);
+    Matrix b = patternMatrix(20, 13, 0.9);
+    TiledMatrix ta = TiledMatrix::fromMatrix(a, "", smallTiles(6, 5));
+    TiledMatrix tb = TiledMatrix::fromMatrix(b, "", smallTiles(6, 5));
+    
+    EXPECT_EQ(a + b, (ta + tb).toMatrix());
+    EXPECT_EQ(a - b, (ta - tb).toMatrix());
+    EXPECT_EQ(a * 2.5, (2.5 * ta).toMatrix());
+    
+    ta += tb;
+    ta -= tb;
+    ta *= 3.0;
+    EXPECT_EQ(a * 3.0, ta.toMatrix());
+    EXPECT_TRUE(ta == TiledMatrix::fromMatrix(Matrix(a * 3.0), "", smallTiles(4, 5)));
+    EXPECT_TRUE(ta != tb);
+    
+    ta.fill(1.0);
+    EXPECT_EQ(Matrix(20, 13, 1.0), ta.toMatrix());
+    // Padding stays zero, so products over filled edge tiles are exact
+    EXPECT_EQ(Matrix(20, 20, 13.0), (ta * ta.transpose()).toMatrix());
+}
+
+TEST(TiledMatrix, TemporaryFilesAreRemoved) {
+    std::string path;
+    {
+        TiledMatrix t = TiledMatrix::create("", 10, 10, smallTiles(4, 3));
+        path = t.path();
+        TiledMatrix copy = std::move(t);
+        EXPECT_TRUE(std::ifstream(path).good());
+    }
+    EXPECT_FALSE(std::ifstream(path).good());
+}
+
+// ========== TEXT I/O TESTS ==========
+
+TEST(MatrixTextIO, ParseInfersDimensions) {
+    Matrix m = parseMatrix("1, 2, 3\n4,5,6\n\n");
+    EXPECT_EQ(Matrix({{1, 2, 3}, {4, 5, 6}}), m);
+    
+    EXPECT_EQ(Matrix({{1.5, -2e3}, {+3, 0.25}}), parseMatrix("1.5\t-2e3\r\n+3 0.25"));
+    EXPECT_TRUE(parseMatrix("").isEmpty());
+}
+
+TEST(MatrixTextIO, ParseRejectsMalformedInput) {
+    EXPECT_THROW(parseMatrix("1, 2\n3"), std::invalid_argument);
+    EXPECT_THROW(parseMatrix("1, x"), std::invalid_argument);
+    EXPECT_THROW(parseMatrix("1.5.2"), std::invalid_argument);
+}
+
+TEST(MatrixTextIO, FormatRoundTripsExactly) {
+    Matrix m = patternMatrix(17, 9, 0.3);
+    m(0, 0) = 0.1 + 0.2;
+    m(1, 1) = 1e-300;
+    m(2, 2) = -123456789.125;
+    
+    Matrix parsed = parseMatrix(formatMatrix(m));
+    ASSERT_EQ(17, parsed.rows());
+    ASSERT_EQ(9, parsed.cols());
+    for (size_t i = 0; i < m.rows(); ++i) {
+        for (size_t j = 0; j < m.cols(); ++j) {
+            EXPECT_EQ(m(i, j), parsed(i, j));  // bit-exact
+        }
+    }
+    EXPECT_EQ("1;2\n3;4\n", formatMatrix(Matrix({{1, 2}, {3, 4}}), ';'));
+}
+
+TEST(MatrixTextIO, StreamWriteAndRead) {
+    Matrix m = patternMatrix(300, 40, 0.6);
+    std::stringstream stream;
+    writeMatrix(stream, m);
+    EXPECT_EQ(formatMatrix(m), stream.str());
+    
+    Matrix read = readMatrix(stream);
+    EXPECT_EQ(m, read);
+}
+
+TEST(MatrixTextIO, OutputOperatorLayout) {
+    Matrix m = {{1, 2.5},
+                {-3, 4}};
+    std::ostringstream out;
+    out << m;
+    EXPECT_EQ("[[1, 2.5]\n [-3, 4]]", out.str());
+}
+
+TEST(MatrixTextIO, InputOperatorInfersShapeForEmptyMatrix) {
+    Matrix m = {{1, 2.5, 0.1},
+                {-3, 4, 1e10}};
+    std::stringstream stream;
+    stream << m;
+    
+    Matrix read;
+    stream >> read;
+    EXPECT_FALSE(stream.fail());
+    EXPECT_EQ(m, read);
+}
+
+TEST(MatrixTextIO, InputOperatorFillsPresetShape) {
+    std::istringstream in("1 2\n3 4 5, 6\n7");
+    Matrix a(2, 2);
+    Matrix b(1, 3);
+    in >> a >> b;
+    EXPECT_FALSE(in.fail());
+    EXPECT_EQ(Matrix({{1, 2}, {3, 4}}), a);
+    EXPECT_EQ(Matrix({{5, 6, 7}}), b);
+    
+    Matrix c(1, 1);
+    in >> c;
+    EXPECT_TRUE(in.fail());
+    
+    std::istringstream bad("1 two");
+    Matrix d(1, 2);
+    bad >> d;
+    EXPECT_TRUE(bad.fail());
+}
+
+// ========== SIMD KERNEL TESTS ==========
+
+TEST(MatrixSimd, StorageIsAligned) {
+    for (size_t n : {1, 3, 7, 100}) {
+        Matrix m(n, n + 1);
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(m.data()) % MATRIX_ALIGNMENT);
+    }
+    Matrix moved = Matrix(5, 5) + Matrix(5, 5);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(moved.data()) % MATRIX_ALIGNMENT);
+}
+
+TEST(MatrixSimd, KernelsHandleEveryTailLength) {
+    EXPECT_NE(nullptr, kernels::simdLevel());
+    for (size_t n = 0; n < 40; ++n) {
+        std::vector<double> a(n + 1), b(n + 1), out(n + 1);
+        double squares = 0.0;
+        for (size_t i = 0; i < n + 1; ++i) {
+            a[i] = 0.5 * i - 3.0;
+            b[i] = 2.0 * i + 1.0;
+            if (i < n) squares += a[i] * a[i];
+        }
+        
+        // Offset by one element so vector loads are misaligned
+        kernels::add(n, a.data() + 1, b.data() + 1, out.data() + 1);
+        for (size_t i = 1; i <= n; ++i) EXPECT_EQ(a[i] + b[i], out[i]);
+        kernels::subtract(n, a.data() + 1, b.data() + 1, out.data() + 1);
+        for (size_t i = 1; i <= n; ++i) EXPECT_EQ(a[i] - b[i], out[i]);
+        kernels::scale(n, -1.5, a.data() + 1, out.data() + 1);
+        for (size_t i = 1; i <= n; ++i) EXPECT_EQ(-1.5 * a[i], out[i]);
+        kernels::fill(n, 7.0, out.data() + 1);
+        for (size_t i = 1; i <= n; ++i) EXPECT_EQ(7.0, out[i]);
+        
+        EXPECT_DOUBLE_EQ(squares, kernels::sumOfSquares(n, a.data()));
+        EXPECT_DOUBLE_EQ(n * (0.25 * n - 3.25), kernels::sum(n, a.data()));
+        double lo = INFINITY, hi = -INFINITY;
+        kernels::minMax(n, a.data() + 1, &lo, &hi);
+        EXPECT_EQ(n ? a[1] : INFINITY, lo);
+        EXPECT_EQ(n ? a[n] : -INFINITY, hi);
+        EXPECT_EQ(0.0, out[0]);  // nothing written before the range
+    }
+}
+
+TEST(MatrixSimd, ElementwiseOperatorsMatchScalarResults) {
+    Matrix a = patternMatrix(13, 11, 0.1);
+    Matrix b = patternMatrix(13, 11, 0.7);
     
-    EXPECT_EQ(2, result.rows());
-    EXPECT_EQ(2, result.cols());
-    EXPECT_DOUBLE_EQ(6.0, result(0, 0));
-    EXPECT_DOUBLE_EQ(8.0, result(0, 1));
-    EXPECT_DOUBLE_EQ(10.0, result(1, 0));
-    EXPECT_DOUBLE_EQ(12.0, result(1, 1));
+    Matrix sum = a + b;
+    Matrix difference = a - b;
+    Matrix scaled = a * 3.0;
+    Matrix negated = -a;
+    for (size_t i = 0; i < a.rows(); ++i) {
+        for (size_t j = 0; j < a.cols(); ++j) {
+            EXPECT_EQ(a(i, j) + b(i, j), sum(i, j));
+            EXPECT_EQ(a(i, j) - b(i, j), difference(i, j));
+            EXPECT_EQ(a(i, j) * 3.0, scaled(i, j));
+            EXPECT_EQ(-a(i, j), negated(i, j));
+        }
+    }
+    
+    // Strided views fall back to the element loop
+    Matrix block = a.block(1, 2, 4, 5) + b.block(0, 0, 4, 5);
+    EXPECT_DOUBLE_EQ(a(2, 3) + b(1, 1), block(1, 1));
+    
+    a += b;
+    EXPECT_EQ(sum, a);
+    a -= b;
+    a.fill(0.5);
+    EXPECT_DOUBLE_EQ(std::sqrt(0.25 * 13 * 11), a.norm());
 }
 
-TEST(MatrixAddition, AdditionWithNegatives) {
-    Matrix m1 = {{1, -2},
-                 {-3, 4}};
-    Matrix m2 = {{-1, 2},
-                 {3, -4}};
-    Matrix result = m1 + m2;
+// ========== REDUCTION TESTS ==========
+
+TEST(MatrixReductions, ReproducibleForAnyThreadCount) {
+    // Large enough to be split into many leaves and run on the pool
+    Matrix m = patternMatrix(300, 1100, 0.3);
+    for (size_t i = 0; i < m.rows(); ++i) {
+        m(i, (7 * i) % m.cols()) *= 1e6;
+    }
+    Vector v(m.block(0, 0, m.rows(), 1));
     
-    EXPECT_DOUBLE_EQ(0.0, result(0, 0));
-    EXPECT_DOUBLE_EQ(0.0, result(0, 1));
-    EXPECT_DOUBLE_EQ(0.0, result(1, 0));
-    EXPECT_DOUBLE_EQ(0.0, result(1, 1));
+    kernels::setNumThreads(1);
+    double sum = m.sum(), norm = m.norm(), trace = m.block(0, 0, 300, 300).eval().trace();
+    Matrix rows = m.rowSums(), cols = m.columnSums();
+    double dot = kernels::reduceDot(m.rows() * m.cols(), m.data(), m.data());
+    for (size_t threads : {2, 3, 4, 7}) {
+        kernels::setNumThreads(threads);
+        EXPECT_EQ(sum, m.sum());
+        EXPECT_EQ(norm, m.norm());
+        EXPECT_EQ(trace, m.block(0, 0, 300, 300).eval().trace());
+        EXPECT_EQ(dot, kernels::reduceDot(m.rows() * m.cols(), m.data(), m.data()));
+        for (size_t i = 0; i < rows.rows(); ++i) ASSERT_EQ(rows(i, 0), m.rowSums()(i, 0));
+        for (size_t j = 0; j < cols.cols(); ++j) ASSERT_EQ(cols(0, j), m.columnSums()(0, j));
+    }
+    kernels::setNumThreads(0);
+    EXPECT_NEAR(v.dot(v), v.norm() * v.norm(), 1e-9 * v.dot(v));
 }
 
-TEST(MatrixAddition, AdditionWithZero) {
-    Matrix m1 = {{1, 2},
-                 {3, 4}};
-    Matrix zero = Matrix::zeros(2, 2);
-    Matrix result = m1 + zero;
+TEST(MatrixReductions, MatchReferenceSums) {
+    Matrix m = patternMatrix(70, 130, 0.8);
+    Matrix rows = m.rowSums(), cols = m.columnSums();
+    ASSERT_EQ(70, rows.rows());
+    ASSERT_EQ(130, cols.cols());
+    long double total = 0.0L;
+    for (size_t i = 0; i < m.rows(); ++i) {
+        long double row = 0.0L;
+        for (size_t j = 0; j < m.cols(); ++j) row += m(i, j);
+        EXPECT_NEAR(double(row), rows(i, 0), 1e-12);
+        total += row;
+    }
+    for (size_t j = 0; j < m.cols(); ++j) {
+        long double col = 0.0L;
+        for (size_t i = 0; i < m.rows(); ++i) col += m(i, j);
+        EXPECT_NEAR(double(col), cols(0, j), 1e-12);
+    }
+    EXPECT_NEAR(double(total), m.sum(), 1e-10);
+    EXPECT_EQ(Matrix(0, 3).columnSums(), Matrix(1, 3));
     
-    EXPECT_EQ(m1, result);
+    // The pairwise tree keeps a million additions of 0.1 accurate
+    std::vector<double> tenths(1 << 20, 0.1);
+    EXPECT_NEAR(0.1 * tenths.size(), kernels::reduceSum(tenths.size(), tenths.data()), 1e-8);
 }
 
-TEST(MatrixAddition, AdditionNonSquare) {
-    Matrix m1 = {{1, 2, 3},
-                 {4, 5, 6}};
-    Matrix m2 = {{7, 8, 9},
-                 {10, 11, 12}};
-    Matrix result = m1 + m2;
+TEST(MatrixReductions, StridedSum) {
+    Matrix m = patternMatrix(300, 300, 0.4);
+    long double diagonal = 0.0L;
+    for (size_t i = 0; i < m.rows(); ++i) diagonal += m(i, i);
+    EXPECT_NEAR(double(diagonal), m.trace(), 1e-12);
+
+    // Every fourth element of a million: many leaves, split across threads
+    std::vector<double> values(1 << 20);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = (i % 4 == 0) ? 0.1 : 1e9;
+    size_t n = values.size() / 4;
+    double expected = kernels::reduceSum(n, values.data(), 4);
+    EXPECT_NEAR(0.1 * n, expected, 1e-8);
+    for (size_t threads : {2, 3, 7}) {
+        kernels::setNumThreads(threads);
+        EXPECT_EQ(expected, kernels::reduceSum(n, values.data(), 4));
+    }
+    kernels::setNumThreads(0);
+    EXPECT_EQ(kernels::reduceSum(n, values.data()), kernels::reduceSum(n, values.data(), 1));
+}
+
+TEST(MatrixReductions, MinMaxAndNaN) {
+    Matrix m = patternMatrix(40, 150, 0.5);
+    m(17, 99) = -3.0;
+    m(39, 149) = 4.0;
+    EXPECT_EQ(-3.0, m.min());
+    EXPECT_EQ(4.0, m.max());
     
-    EXPECT_EQ(2, result.rows());
-    EXPECT_EQ(3, result.cols());
-    EXPECT_DOUBLE_EQ(8.0, result(0, 0));
-    EXPECT_DOUBLE_EQ(10.0, result(0, 1));
-    EXPECT_DOUBLE_EQ(12.0, result(0, 2));
+    m(5, 5) = NAN;
+    EXPECT_TRUE(std::isnan(m.min()));
+    EXPECT_TRUE(std::isnan(m.max()));
+    EXPECT_THROW(Matrix().min(), std::logic_error);
+    EXPECT_THROW(Matrix().max(), std::logic_error);
 }
 
-TEST(MatrixAddition, DimensionMismatchRows) {
-    Matrix m1(2, 3);
-    Matrix m2(3, 3);
+TEST(MatrixReductions, NormIsOverflowSafe) {
+    Matrix huge(2, 2, 1e200);
+    EXPECT_DOUBLE_EQ(2e200, huge.norm());
+    Matrix tiny(3, 3, 1e-200);
+    EXPECT_DOUBLE_EQ(3e-200, tiny.norm());
+    EXPECT_EQ(0.0, Matrix(4, 4).norm());
+    EXPECT_EQ(0.0, Matrix().norm());
+    EXPECT_DOUBLE_EQ(5e300, Vector({3e300, 4e300}).norm());
+}
+
+// ========== ELEMENT TYPE TESTS ==========
+
+TEST(BasicMatrix, MatrixIsDoubleSpecialization) {
+    EXPECT_TRUE((std::is_same<Matrix, BasicMatrix<double>>::value));
+    EXPECT_EQ(sizeof(float), sizeof(FloatMatrix::value_type));
+}
+
+TEST(BasicMatrix, FloatArithmetic) {
+    FloatMatrix a = {{1, 2},
+                     {3, 4}};
+    FloatMatrix b = FloatMatrix::ones(2, 2);
+    
+    EXPECT_EQ(FloatMatrix({{2, 3}, {4, 5}}), a + b);
+    EXPECT_EQ(FloatMatrix({{0, 1}, {2, 3}}), a - b);
+    EXPECT_EQ(FloatMatrix({{0.5f, 1}, {1.5f, 2}}), a / 2.0f);
+    EXPECT_EQ(FloatMatrix({{7, 10}, {15, 22}}), a * a);
+    EXPECT_EQ(FloatMatrix({{1, 3}, {2, 4}}), a.transpose());
+    EXPECT_FLOAT_EQ(5.0f, a.trace());
+    EXPECT_DOUBLE_EQ(std::sqrt(30.0), a.norm());
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(a.data()) % MATRIX_ALIGNMENT);
+    EXPECT_THROW(a / 0.0f, std::invalid_argument);
+    EXPECT_THROW(a * FloatMatrix(3, 1), std::invalid_argument);
+}
+
+TEST(BasicMatrix, EmptyMatrixMatchesMatrix) {
+    // An empty matrix is not square, as for Matrix
+    EXPECT_EQ(Matrix().isSquare(), FloatMatrix().isSquare());
+    EXPECT_FALSE(FloatMatrix().isSquare());
+    EXPECT_FALSE(BasicMatrix<int>(0, 0).isSquare());
+    EXPECT_TRUE(FloatMatrix().isEmpty());
+    EXPECT_THROW(Matrix().trace(), std::logic_error);
+    EXPECT_THROW(FloatMatrix().trace(), std::logic_error);
+    EXPECT_THROW(BasicMatrix<int>(0, 0).trace(), std::logic_error);
+}
+
+TEST(BasicMatrix, IntegerMatrix) {
+    BasicMatrix<int> a = {{1, 2, 3},
+                          {4, 5, 6}};
+    BasicMatrix<int> product = a * a.transpose();
+    
+    EXPECT_EQ(BasicMatrix<int>({{14, 32}, {32, 77}}), product);
+    EXPECT_EQ(BasicMatrix<int>({{0, 1, 1}, {2, 2, 3}}), a / 2);
+    EXPECT_EQ(BasicMatrix<int>({{-2, -4, -6}, {-8, -10, -12}}), -2 * a);
+    EXPECT_THROW(a.at(2, 0), std::out_of_range);
+    EXPECT_THROW(a / 0, std::invalid_argument);
+}
+
+TEST(BasicMatrix, CastBetweenElementTypes) {
+    Matrix m = {{1.25, -2.5},
+                {3.75, 1e10}};
+    FloatMatrix f = matrix_cast<float>(m);
+    EXPECT_FLOAT_EQ(1.25f, f(0, 0));
+    EXPECT_FLOAT_EQ(1e10f, f(1, 1));
+    
+    Matrix back = matrix_cast<double>(f);
+    EXPECT_EQ(m, back);
+    
+    // Conversion to integers truncates like static_cast
+    EXPECT_EQ(BasicMatrix<int>({{1, -2}}), matrix_cast<int>(Matrix({{1.9, -2.7}})));
+}
+
+TEST(BasicMatrix, MixedPrecisionProductAccumulatesInDouble) {
+    // Summed in float, 1e8 + 1 rounds back to 1e8 and the 1 is lost
+    FloatMatrix a = {{1e8f, 1.0f, -1e8f}};
+    FloatMatrix b = {{1}, {1}, {1}};
+    EXPECT_FLOAT_EQ(1.0f, (a * b)(0, 0));
+}
+
+TEST(BasicMatrix, MixedPrecisionMatchesDoubleReference) {
+    Matrix a = patternMatrix(150, 300, 0.2);
+    Matrix b = patternMatrix(300, 90, 0.9);
+    FloatMatrix fa = matrix_cast<float>(a);
+    FloatMatrix fb = matrix_cast<float>(b);
+    
+    // Reference: the same float inputs multiplied in double
+    Matrix expected = referenceMultiply(matrix_cast<double>(fa), matrix_cast<double>(fb));
+    FloatMatrix product = fa * fb;
+    for (size_t i = 0; i < expected.rows(); ++i) {
+        for (size_t j = 0; j < expected.cols(); ++j) {
+            EXPECT_FLOAT_EQ(static_cast<float>(expected(i, j)), product(i, j));
+        }
+    }
+    
+    // Accumulating into an existing result through strided operands
+    FloatMatrix fat = fa.transpose();
+    FloatMatrix c(150, 90, 1.0f);
+    kernels::gemmMixed(150, 90, 300, 2.0, fat.data(), 1, 150, fb.data(), 90, 1,
+                       c.data(), 90);
+    EXPECT_FLOAT_EQ(static_cast<float>(1.0 + 2.0 * expected(7, 11)), c(7, 11));
+}
+
+TEST(BasicMatrix, SingleAccumulationRunsFloatGemm) {
+    Matrix a = patternMatrix(150, 300, 0.2);
+    Matrix b = patternMatrix(300, 90, 0.9);
+    FloatMatrix fa = matrix_cast<float>(a);
+    FloatMatrix fb = matrix_cast<float>(b);
+    Matrix expected = referenceMultiply(matrix_cast<double>(fa), matrix_cast<double>(fb));
+
+    EXPECT_EQ(kernels::FloatAccumulation::Double, kernels::floatAccumulation());
+    kernels::setFloatAccumulation(kernels::FloatAccumulation::Single);
+    FloatMatrix product = fa * fb;
+    FloatMatrix lost = FloatMatrix({{1e8f, 1.0f, -1e8f}}) * FloatMatrix({{1}, {1}, {1}});
+
+    // Blocked and threaded float engine on a strided, accumulating call
+    kernels::setNumThreads(3);
+    kernels::setGemmParallelThreshold(0);
+    FloatMatrix fat = fa.transpose();
+    FloatMatrix c(150, 90, 1.0f);
+    kernels::gemmFloat(150, 90, 300, 2.0f, fat.data(), 1, 150, fb.data(), 90, 1,
+                       c.data(), 90);
+    kernels::setGemmParallelThreshold(kernels::GEMM_DEFAULT_PARALLEL_THRESHOLD);
+    kernels::setNumThreads(0);
+    kernels::setFloatAccumulation(kernels::FloatAccumulation::Double);
+
+    for (size_t i = 0; i < expected.rows(); ++i) {
+        for (size_t j = 0; j < expected.cols(); ++j) {
+            double tolerance = 1e-5 * (1.0 + std::abs(expected(i, j)));
+            EXPECT_NEAR(expected(i, j), product(i, j), tolerance);
+            EXPECT_NEAR(1.0 + 2.0 * expected(i, j), c(i, j), 2 * tolerance);
+        }
+    }
+    // Summed in float, 1e8 + 1 rounds back to 1e8
+    EXPECT_EQ(0.0f, lost(0, 0));
+}
+
+TEST(BasicMatrix, FloatElementwiseKernels) {
+    // 37 elements leaves a tail after every vector width
+    FloatMatrix a(1, 37);
+    FloatMatrix b(1, 37);
+    for (size_t j = 0; j < 37; ++j) {
+        a(0, j) = 0.5f * j;
+        b(0, j) = 3.0f - j;
+    }
+    FloatMatrix sum = a + b;
+    FloatMatrix difference = a - b;
+    FloatMatrix scaled = 4.0f * a;
+    FloatMatrix negated = -b;
+    for (size_t j = 0; j < 37; ++j) {
+        EXPECT_EQ(a(0, j) + b(0, j), sum(0, j));
+        EXPECT_EQ(a(0, j) - b(0, j), difference(0, j));
+        EXPECT_EQ(4.0f * a(0, j), scaled(0, j));
+        EXPECT_EQ(-b(0, j), negated(0, j));
+    }
+}
+
+// ========== FIXED-SIZE MATRIX TESTS ==========
+
+// True if A * B compiles
+template <typename A, typename B, typename = void>
+struct CanMultiply : std::false_type {};
+
+template <typename A, typename B>
+struct CanMultiply<A, B, std::void_t<decltype(std::declval<A>() * std::declval<B>())>>
+    : std::true_type {};
+
+TEST(FixedMatrix, StorageIsInline) {
+    EXPECT_EQ(12 * sizeof(double), sizeof(FixedMatrix<3, 4>));
+    EXPECT_TRUE((std::is_trivially_copyable<FixedMatrix<4, 4>>::value));
+    
+    FixedMatrix<2, 3> m;
+    EXPECT_EQ(2, m.rows());
+    EXPECT_EQ(3, m.cols());
+    EXPECT_EQ(0.0, m(1, 2));
+    EXPECT_EQ(5.0, (FixedMatrix<2, 2>(5.0)(1, 0)));
+}
+
+TEST(FixedMatrix, ShapesCheckedAtCompileTime) {
+    EXPECT_TRUE((CanMultiply<FixedMatrix<2, 3>, FixedMatrix<3, 4>>::value));
+    EXPECT_FALSE((CanMultiply<FixedMatrix<2, 3>, FixedMatrix<2, 3>>::value));
+    EXPECT_TRUE((std::is_same<FixedMatrix<2, 4>,
+                              decltype(FixedMatrix<2, 3>() * FixedMatrix<3, 4>())>::value));
+    EXPECT_TRUE((std::is_same<FixedMatrix<4, 2>,
+                              decltype(FixedMatrix<2, 4>().transpose())>::value));
+}
+
+TEST(FixedMatrix, ArithmeticMatchesMatrix) {
+    FixedMatrix<3, 3> a = {{2, -1, 0.5},
+                           {1, 3, -2},
+                           {0, 4, 1}};
+    FixedMatrix<3, 2> b = {{1, 2},
+                           {-3, 0.25},
+                           {5, 1}};
+    Matrix da = a.toMatrix();
+    Matrix db = b.toMatrix();
+    
+    EXPECT_EQ(da * db, (a * b).toMatrix());
+    EXPECT_EQ(Matrix(da + da * 2.0 - da / 4.0), (a + a * 2.0 - a / 4.0).toMatrix());
+    EXPECT_EQ(Matrix(-da), (-a).toMatrix());
+    EXPECT_EQ(da.transpose(), a.transpose().toMatrix());
+    EXPECT_DOUBLE_EQ(da.trace(), a.trace());
+    EXPECT_DOUBLE_EQ(da.norm(), a.norm());
+    
+    FixedMatrix<3, 3> c = a;
+    c *= FixedMatrix<3, 3>::identity();
+    EXPECT_EQ(a, c);
+    c += a;
+    EXPECT_EQ(2.0 * a, c);
+    EXPECT_NE(a, c);
+}
+
+TEST(FixedMatrix, ConversionToAndFromMatrix) {
+    Matrix m = patternMatrix(5, 6, 0.3);
+    FixedMatrix<5, 6> f(m);
+    EXPECT_EQ(m, f.toMatrix());
+    EXPECT_EQ(m, Matrix(f.view()));
+    
+    // From a block of a larger matrix
+    FixedMatrix<2, 2> corner(m.block(3, 4, 2, 2));
+    EXPECT_DOUBLE_EQ(m(4, 5), corner(1, 1));
+    
     bool threw = false;
     try {
-        Matrix result = m1 + m2;
+        FixedMatrix<5, 5> wrong(m);
     } catch (const std::invalid_argument&) {
         threw = true;
     }
     EXPECT_TRUE(threw);
 }
 
-TEST(MatrixAddition, DimensionMismatchCols) {
-    Matrix m1(3, 2);
-    Matrix m2(3, 3);
-    bool threw = false;
+TEST(FixedMatrix, ErrorsMatchMatrix) {
+    FixedMatrix<2, 2> m = {{1, 2}, {3, 4}};
+    bool threw_index = false, threw_division = false;
     try {
-        Matrix result = m1 + m2;
+        m.at(2, 0);
+    } catch (const std::out_of_range&) {
+        threw_index = true;
+    }
+    try {
+        m / 0.0;
     } catch (const std::invalid_argument&) {
+        threw_division = true;
+    }
+    EXPECT_TRUE(threw_index);
+    EXPECT_TRUE(threw_division);
+    EXPECT_THROW((FixedMatrix<2, 2>{{1, 2, 3}, {4, 5, 6}}), std::invalid_argument);
+}
+
+TEST(FixedMatrix, ConstexprEvaluation) {
+    constexpr FixedMatrix<3, 3> twice = FixedMatrix<3, 3>::identity() * 2.0;
+    static_assert(twice.trace() == 6.0, "evaluated at compile time");
+    constexpr FixedMatrix<3, 3> square = twice * twice;
+    static_assert(square(1, 1) == 4.0 && square(0, 1) == 0.0, "evaluated at compile time");
+    EXPECT_DOUBLE_EQ(12.0, square.trace());
+}
+
+// ========== VECTOR AND GEMV TESTS ==========
+
+Vector patternVector(size_t n, double seed) {
+    return Vector(patternMatrix(n, 1, seed));
+}
+
+TEST(Vector, ConstructionAndAccess) {
+    Vector v = {1.0, 2.5, -3.0};
+    EXPECT_EQ(3, v.size());
+    EXPECT_EQ(2.5, v[1]);
+    EXPECT_EQ(Vector(4, 0.0), Vector(4));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(Vector(7).data()) % MATRIX_ALIGNMENT);
+    
+    std::ostringstream out;
+    out << v;
+    EXPECT_EQ("[1, 2.5, -3]", out.str());
+    
+    bool threw = false;
+    try {
+        v.at(3);
+    } catch (const std::out_of_range&) {
         threw = true;
     }
     EXPECT_TRUE(threw);
 }
 
-TEST(MatrixAddition, CompoundAddition) {
-    Matrix m1 = {{1, 2},
-                 {3, 4}};
-    Matrix m2 = {{5, 6},
-                 {7, 8}};
-    Matrix& result = (m1 += m2);
+TEST(Vector, ConversionToAndFromMatrix) {
+    Matrix m = patternMatrix(4, 5, 0.2);
+    Vector row(m.row(2));
+    Vector column(m.col(3));
+    EXPECT_EQ(5, row.size());
+    EXPECT_EQ(m(2, 4), row[4]);
+    EXPECT_EQ(m(3, 3), column[3]);
+    EXPECT_EQ(Matrix(m.col(3)), column.toMatrix());
+    EXPECT_EQ(Matrix(m.col(3)), Matrix(column.view()));
     
-    EXPECT_EQ(&m1, &result);  // Should return reference to self
-    EXPECT_DOUBLE_EQ(6.0, m1(0, 0));
-    EXPECT_DOUBLE_EQ(8.0, m1(0, 1));
-    EXPECT_DOUBLE_EQ(10.0, m1(1, 0));
-    EXPECT_DOUBLE_EQ(12.0, m1(1, 1));
+    bool threw = false;
+    try {
+        Vector bad(m);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
 }
 
-TEST(MatrixAddition, CompoundAdditionChaining) {
-    Matrix m1 = {{1, 1},
-                 {1, 1}};
-    Matrix m2 = {{1, 1},
-                 {1, 1}};
-    Matrix m3 = {{1, 1},
-                 {1, 1}};
+TEST(Vector, ArithmeticAndLevelOne) {
+    Vector x = {1, 2, 3};
+    Vector y = {4, -5, 6};
     
-    m1 += m2 += m3;
+    EXPECT_EQ(Vector({5, -3, 9}), x + y);
+    EXPECT_EQ(Vector({-3, 7, -3}), x - y);
+    EXPECT_EQ(Vector({2, 4, 6}), 2.0 * x);
+    EXPECT_EQ(Vector({0.5, 1, 1.5}), x / 2.0);
+    EXPECT_EQ(Vector({-1, -2, -3}), -x);
+    EXPECT_DOUBLE_EQ(12.0, dot(x, y));
+    EXPECT_DOUBLE_EQ(std::sqrt(14.0), nrm2(x));
     
-    EXPECT_DOUBLE_EQ(3.0, m1(0, 0));
-    EXPECT_DOUBLE_EQ(2.0, m2(0, 0));
+    axpy(2.0, x, y);
+    EXPECT_EQ(Vector({6, -1, 12}), y);
+    
+    bool threw = false;
+    try {
+        x + Vector(2);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
 }
 
-TEST(MatrixAddition, Associativity) {
-    Matrix m1 = {{1, 2},
-                 {3, 4}};
-    Matrix m2 = {{5, 6},
-                 {7, 8}};
-    Matrix m3 = {{9, 10},
-                 {11, 12}};
-    
-    Matrix result1 = (m1 + m2) + m3;
-    Matrix result2 = m1 + (m2 + m3);
+TEST(Vector, LevelOneKernelsHandleEveryLength) {
+    for (size_t n = 0; n < 40; ++n) {
+        std::vector<double> a(n + 1), b(n + 1), y(n + 1);
+        double expected_dot = 0.0;
+        for (size_t i = 0; i < n + 1; ++i) {
+            a[i] = 0.5 * i - 3.0;
+            b[i] = 2.0 * i + 1.0;
+            y[i] = 1.0 - i;
+            if (i > 0) expected_dot += a[i] * b[i];
+        }
+        
+        // Offset by one element so vector loads are misaligned
+        EXPECT_NEAR(expected_dot, kernels::dot(n, a.data() + 1, b.data() + 1), 1e-9);
+        kernels::axpy(n, 0.5, a.data() + 1, y.data() + 1);
+        for (size_t i = 1; i < n + 1; ++i) {
+            EXPECT_DOUBLE_EQ(1.0 - i + 0.5 * a[i], y[i]);
+        }
+    }
+}
+
+TEST(Vector, NormDoesNotOverflow) {
+    EXPECT_DOUBLE_EQ(5e300, nrm2(Vector({3e300, 4e300})));
+    EXPECT_DOUBLE_EQ(5e-300, nrm2(Vector({3e-300, -4e-300})));
+    EXPECT_EQ(0.0, nrm2(Vector(5)));
+}
+
+TEST(Vector, GemvMatchesMatrixProduct) {
+    // Wider than one column block of the transposed kernel
+    size_t shapes[][2] = {{1, 1}, {7, 13}, {50, 3}, {3, 2500}};
+    for (auto& shape : shapes) {
+        size_t m = shape[0], n = shape[1];
+        Matrix a = patternMatrix(m, n, 0.4);
+        Vector x = patternVector(n, 0.1);
+        Vector z = patternVector(m, 0.9);
+        
+        EXPECT_EQ(a * x.toMatrix(), (a * x).toMatrix());
+        EXPECT_EQ(a.transpose() * z.toMatrix(), (z * a).toMatrix());
+    }
+}
+
+TEST(Vector, GemvAlphaBeta) {
+    Matrix a = patternMatrix(6, 4, 0.5);
+    Vector x = patternVector(4, 0.2);
+    Vector y = patternVector(6, 0.8);
+    Vector expected = 2.0 * (a * x) - 0.5 * y;
+    kernels::gemv(6, 4, 2.0, a.data(), 4, x.data(), -0.5, y.data());
+    EXPECT_EQ(expected, y);
     
-    EXPECT_EQ(result1, result2);
+    // beta == 0 must not read y
+    Vector nan_y(4, std::nan(""));
+    kernels::gemvTransposed(6, 4, 1.0, a.data(), 4, expected.data(), 0.0, nan_y.data());
+    EXPECT_EQ(expected * a, nan_y);
 }
 
-TEST(MatrixAddition, Commutativity) {
-    Matrix m1 = {{1, 2},
-                 {3, 4}};
-    Matrix m2 = {{5, 6},
-                 {7, 8}};
+TEST(Vector, GemvOnViews) {
+    Matrix big = patternMatrix(30, 40, 0.3);
+    ConstMatrixView block = big.block(5, 7, 12, 9);
+    Vector x = patternVector(9, 0.6);
+    Matrix expected = Matrix(block) * x.toMatrix();
     
-    Matrix result1 = m1 + m2;
-    Matrix result2 = m2 + m1;
+    EXPECT_EQ(expected, (block * x).toMatrix());
     
-    EXPECT_EQ(result1, result2);
+    // A column-major operand (unit row stride) takes the transposed kernel
+    ConstMatrixView transposed(big.data(), 40, 30, 1, 40);
+    Vector z = patternVector(30, 0.7);
+    EXPECT_EQ(big.transpose() * z.toMatrix(), (transposed * z).toMatrix());
+    EXPECT_EQ(big * patternVector(40, 0.2).toMatrix(),
+              (patternVector(40, 0.2) * transposed).toMatrix());
 }
 
-TEST(MatrixAddition, LargeMatrix) {
-    Matrix m1 = Matrix::ones(100, 100);
-    Matrix m2 = Matrix::ones(100, 100);
-    Matrix result = m1 + m2;
+TEST(Vector, ParallelGemv) {
+    size_t m = 300, n = 400;
+    Matrix a = patternMatrix(m, n, 0.1);
+    Vector x = patternVector(n, 0.3);
+    Vector z = patternVector(m, 0.5);
+    Vector serial = a * x;
+    Vector serial_t = z * a;
     
-    EXPECT_EQ(100, result.rows());
-    EXPECT_EQ(100, result.cols());
-    EXPECT_DOUBLE_EQ(2.0, result(0, 0));
-    EXPECT_DOUBLE_EQ(2.0, result(99, 99));
+    kernels::setNumThreads(4);
+    Vector parallel(m), parallel_t(n);
+    multiply_into(a, x, parallel);
+    multiply_transposed_into(a, z, parallel_t);
+    kernels::setNumThreads(0);
+    
+    EXPECT_EQ(serial, parallel);
+    EXPECT_EQ(serial_t, parallel_t);
+    
+    bool threw = false;
+    try {
+        Vector square_x = patternVector(m, 0.2);
+        multiply_into(Matrix::identity(m), square_x, square_x);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+// ========== COPY-ON-WRITE TESTS ==========
+
+TEST(SharedMatrix, CopiesShareUntilWritten) {
+    SharedMatrix a(patternMatrix(4, 5, 0.1));
+    SharedMatrix b = a;
+    EXPECT_EQ(2, a.useCount());
+    EXPECT_EQ(a.data(), b.data());
+
+    // Reads through const access do not copy
+    const SharedMatrix& cb = b;
+    EXPECT_DOUBLE_EQ(a.get()(1, 2), cb(1, 2));
+    EXPECT_EQ(a.data(), b.data());
+
+    b(1, 2) = 100.0;
+    EXPECT_NE(a.data(), b.data());
+    EXPECT_EQ(1, a.useCount());
+    EXPECT_EQ(1, b.useCount());
+    EXPECT_DOUBLE_EQ(100.0, b.get()(1, 2));
+    EXPECT_EQ(patternMatrix(4, 5, 0.1), a.get());
+
+    // The sole owner writes in place
+    const double* buffer = b.data();
+    b.at(0, 0) = -1.0;
+    EXPECT_EQ(buffer, b.data());
+}
+
+TEST(SharedMatrix, MutatorsDetach) {
+    Matrix m = {{1, 2},
+                {3, 4}};
+    SharedMatrix original(m);
+
+    SharedMatrix filled = original;
+    filled.fill(7.0);
+    EXPECT_EQ(Matrix(2, 2, 7.0), filled.get());
+
+    SharedMatrix sum = original;
+    sum += m;
+    EXPECT_EQ(m * 2.0, sum.get());
+
+    SharedMatrix product = original;
+    product *= m;
+    EXPECT_EQ(m * m, product.get());
+
+    SharedMatrix scaled = original;
+    scaled /= 2.0;
+    EXPECT_EQ(m * 0.5, scaled.get());
+
+    SharedMatrix diff = original;
+    diff.mutate().transposeInPlace();
+    EXPECT_EQ(m.transpose(), diff.get());
+
+    // Operand is the shared value itself
+    SharedMatrix twice = original;
+    twice += twice.get();
+    EXPECT_EQ(m * 2.0, twice.get());
+
+    EXPECT_EQ(m, original.get());
+    EXPECT_EQ(1, original.useCount());
+}
+
+TEST(SharedMatrix, EmptyAndMoved) {
+    SharedMatrix empty;
+    EXPECT_TRUE(empty.isEmpty());
+    EXPECT_EQ(0, empty.useCount());
+
+    SharedMatrix a(Matrix::identity(3));
+    SharedMatrix b = a;
+    SharedMatrix c = std::move(a);
+    EXPECT_TRUE(a.isEmpty());
+    EXPECT_EQ(2, c.useCount());
+    EXPECT_EQ(b, c);
+
+    b = empty;
+    EXPECT_EQ(1, c.useCount());
+    EXPECT_THROW(c.at(3, 0), std::out_of_range);
+    EXPECT_EQ(Matrix::identity(3), static_cast<const Matrix&>(c));
+}
+
+TEST(SharedMatrix, ConcurrentCopiesAndWrites) {
+    SharedMatrix source(patternMatrix(16, 16, 0.2));
+    std::vector<std::thread> threads;
+    std::vector<double> sums(8);
+    for (size_t t = 0; t < sums.size(); ++t) {
+        threads.emplace_back([&source, &sums, t] {
+            for (int iter = 0; iter < 200; ++iter) {
+                SharedMatrix local = source;
+                local(0, 0) += static_cast<double>(t);
+                SharedMatrix again = local;
+                sums[t] = again.get()(0, 0) - source.get()(0, 0);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t t = 0; t < sums.size(); ++t) {
+        EXPECT_DOUBLE_EQ(static_cast<double>(t), sums[t]);
+    }
+    EXPECT_EQ(1, source.useCount());
+    EXPECT_EQ(patternMatrix(16, 16, 0.2), source.get());
 }
 
 // ========== STATIC FACTORY TESTS ==========
@@ -488,6 +3295,66 @@ TEST(MatrixOperations, TransposeRowVector) {
     EXPECT_DOUBLE_EQ(4.0, t(3, 0));
 }
 
+TEST(MatrixOperations, TransposeLargeRectangular) {
+    // Large enough to recurse several levels in the cache-oblivious kernel
+    Matrix m = patternMatrix(137, 70, 0.4);
+    Matrix t = m.transpose();
+    
+    EXPECT_EQ(70, t.rows());
+    EXPECT_EQ(137, t.cols());
+    for (size_t i = 0; i < m.rows(); ++i) {
+        for (size_t j = 0; j < m.cols(); ++j) {
+            EXPECT_DOUBLE_EQ(m(i, j), t(j, i));
+        }
+    }
+}
+
+TEST(MatrixOperations, TransposeInPlaceSquare) {
+    Matrix m = patternMatrix(75, 75, 0.2);
+    Matrix expected = m.transpose();
+    const double* buffer = m.data();
+    m.transposeInPlace();
+    
+    EXPECT_EQ(expected, m);
+    EXPECT_EQ(buffer, m.data());
+}
+
+TEST(MatrixOperations, TransposeInPlaceRectangular) {
+    Matrix m = patternMatrix(41, 13, 0.5);
+    Matrix expected = m.transpose();
+    m.transposeInPlace();
+    
+    EXPECT_EQ(13, m.rows());
+    EXPECT_EQ(41, m.cols());
+    EXPECT_EQ(expected, m);
+    
+    m.transposeInPlace();
+    EXPECT_EQ(expected.transpose(), m);
+}
+
+TEST(MatrixOperations, TransposeInPlaceVector) {
+    Matrix m = {{1, 2, 3, 4}};
+    m.transposeInPlace();
+    
+    EXPECT_EQ(4, m.rows());
+    EXPECT_EQ(1, m.cols());
+    EXPECT_DOUBLE_EQ(3.0, m(2, 0));
+}
+
+TEST(MatrixOperations, TransposeKernelWithStrides) {
+    // Transpose the 3x2 block at (1, 1) of a 5x4 matrix into a 2x3 block
+    Matrix src = patternMatrix(5, 4, 0.3);
+    Matrix dst(6, 6);
+    kernels::transpose(3, 2, &src(1, 1), src.cols(), &dst(2, 3), dst.cols());
+    
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 2; ++j) {
+            EXPECT_DOUBLE_EQ(src(1 + i, 1 + j), dst(2 + j, 3 + i));
+        }
+    }
+    EXPECT_DOUBLE_EQ(0.0, dst(0, 0));
+}
+
 TEST(MatrixOperations, Trace) {
     Matrix m = {{1, 2, 3},
                 {4, 5, 6},
@@ -0,0 +1,304 @@
+#include "vector.h"
+#include "elementwise.h"
+#include "gemv.h"
+#include "reduce.h"
+#include <charconv>
+#include <cmath>
+
+// ========== PRIVATE HELPER METHODS ==========
+
+void Vector::requireSameSize(const Vector& other, const char* message) const {
+    if (size() != other.size()) {
+        throw std::invalid_argument(message);
+    }
+}
+
+// ========== CONSTRUCTORS ==========
+
+Vector::Vector() {}
+
+Vector::Vector(size_t size) : data_(size, 0.0) {}
+
+Vector::Vector(size_t size, double value) : data_(size, value) {}
+
+Vector::Vector(std::initializer_list<double> list) : data_(list.begin(), list.end()) {}
+
+Vector::Vector(const std::vector<double>& values) : data_(values.begin(), values.end()) {}
+
+Vector::Vector(ConstMatrixView m) {
+    if (m.rows() != 1 && m.cols() != 1) {
+        throw std::invalid_argument("Vector requires a single row or column");
+    }
+    bool column = m.cols() == 1;
+    data_.resize(column ? m.rows() : m.cols());
+    for (size_t i = 0; i < data_.size(); ++i) {
+        data_[i] = column ? m(i, 0) : m(0, i);
+    }
+}
+
+// ========== ELEMENT ACCESS ==========
+
+double& Vector::at(size_t i) {
+    if (i >= size()) {
+        throw std::out_of_range("Vector index out of range");
+    }
+    return data_[i];
+}
+
+const double& Vector::at(size_t i) const {
+    if (i >= size()) {
+        throw std::out_of_range("Vector index out of range");
+    }
+    return data_[i];
+}
+
+// ========== CONVERSION ==========
+
+Matrix Vector::toMatrix() const {
+    Matrix result(size(), 1);
+    std::copy(data_.begin(), data_.end(), result.data());
+    return result;
+}
+
+std::vector<double> Vector::toStdVector() const {
+    return std::vector<double>(data_.begin(), data_.end());
+}
+
+ConstMatrixView Vector::view() const {
+    return ConstMatrixView(data_.data(), size(), 1, 1);
+}
+
+MatrixView Vector::view() {
+    return MatrixView(data_.data(), size(), 1, 1);
+}
+
+// ========== ARITHMETIC OPERATORS ==========
+
+Vector Vector::operator+(const Vector& other) const {
+    requireSameSize(other, "Vector sizes must match for addition");
+    Vector result(size());
+    kernels::add(size(), data(), other.data(), result.data());
+    return result;
+}
+
+Vector Vector::operator-(const Vector& other) const {
+    requireSameSize(other, "Vector sizes must match for subtraction");
+    Vector result(size());
+    kernels::subtract(size(), data(), other.data(), result.data());
+    return result;
+}
+
+Vector Vector::operator*(double scalar) const {
+    Vector result(size());
+    kernels::scale(size(), scalar, data(), result.data());
+    return result;
+}
+
+Vector Vector::operator/(double scalar) const {
+    Vector result(*this);
+    result /= scalar;
+    return result;
+}
+
+Vector Vector::operator-() const {
+    return (*this) * -1.0;
+}
+
+Vector operator*(double scalar, const Vector& v) {
+    return v * scalar;
+}
+
+// ========== COMPOUND ASSIGNMENT OPERATORS ==========
+
+Vector& Vector::operator+=(const Vector& other) {
+    requireSameSize(other, "Vector sizes must match for addition");
+    kernels::add(size(), data(), other.data(), data());
+    return *this;
+}
+
+Vector& Vector::operator-=(const Vector& other) {
+    requireSameSize(other, "Vector sizes must match for subtraction");
+    kernels::subtract(size(), data(), other.data(), data());
+    return *this;
+}
+
+Vector& Vector::operator*=(double scalar) {
+    kernels::scale(size(), scalar, data(), data());
+    return *this;
+}
+
+Vector& Vector::operator/=(double scalar) {
+    if (std::abs(scalar) < EPSILON) {
+        throw std::invalid_argument("Division by zero");
+    }
+    return *this *= 1.0 / scalar;
+}
+
+// ========== COMPARISON OPERATORS ==========
+
+bool Vector::operator==(const Vector& other) const {
+    if (size() != other.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < size(); ++i) {
+        if (std::abs(data_[i] - other.data_[i]) >= EPSILON) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Vector::operator!=(const Vector& other) const {
+    return !(*this == other);
+}
+
+// ========== VECTOR OPERATIONS ==========
+
+double Vector::dot(const Vector& other) const {
+    requireSameSize(other, "Vector sizes must match for dot product");
+    return kernels::reduceDot(size(), data(), other.data());
+}
+
+double Vector::norm() const {
+    return kernels::reduceNorm(size(), data());
+}
+
+void Vector::fill(double value) {
+    kernels::fill(size(), value, data());
+}
+
+void Vector::resize(size_t size) {
+    data_.resize(size, 0.0);
+}
+
+// ========== STATIC FACTORY METHODS ==========
+
+Vector Vector::zeros(size_t size) {
+    return Vector(size);
+}
+
+Vector Vector::ones(size_t size) {
+    return Vector(size, 1.0);
+}
+
+// ========== STREAM OPERATORS ==========
+
+std::ostream& operator<<(std::ostream& os, const Vector& v) {
+    // Shortest round-trip form, as Matrix prints
+    char buffer[32];
+    os << "[";
+    for (size_t i = 0; i < v.size(); ++i) {
+        if (i > 0) os << ", ";
+        char* end = std::to_chars(buffer, buffer + sizeof(buffer), v[i]).ptr;
+        os.write(buffer, end - buffer);
+    }
+    os << "]";
+    return os;
+}
+
+// ========== LEVEL-1 ROUTINES ==========
+
+double dot(const Vector& x, const Vector& y) {
+    return x.dot(y);
+}
+
+void axpy(double alpha, const Vector& x, Vector& y) {
+    if (x.size() != y.size()) {
+        throw std::invalid_argument("Vector sizes must match for axpy");
+    }
+    kernels::axpy(x.size(), alpha, x.data(), y.data());
+}
+
+double nrm2(const Vector& x) {
+    return x.norm();
+}
+
+// ========== MATRIX-VECTOR PRODUCTS ==========
+
+namespace {
+
+void requireDistinct(const Vector& x, const Vector& y, const char* message) {
+    if (&x == &y) {
+        throw std::invalid_argument(message);
+    }
+}
+
+// y = A * x for any view layout: row-major views take gemv, column-major
+// ones (unit row stride) are the transpose of a row-major matrix and take
+// gemvTransposed, and anything else falls back to a plain loop
+void multiplyView(ConstMatrixView a, const double* x, double* y) {
+    if (a.colStride() == 1) {
+        kernels::gemv(a.rows(), a.cols(), 1.0, a.data(), a.rowStride(), x, 0.0, y);
+    } else if (a.rowStride() == 1) {
+        kernels::gemvTransposed(a.cols(), a.rows(), 1.0, a.data(), a.colStride(), x, 0.0, y);
+    } else {
+        for (size_t i = 0; i < a.rows(); ++i) {
+            double sum = 0.0;
+            for (size_t j = 0; j < a.cols(); ++j) {
+                sum += a(i, j) * x[j];
+            }
+            y[i] = sum;
+        }
+    }
+}
+
+// y = A^T * x, mirroring multiplyView
+void multiplyTransposedView(ConstMatrixView a, const double* x, double* y) {
+    if (a.colStride() == 1) {
+        kernels::gemvTransposed(a.rows(), a.cols(), 1.0, a.data(), a.rowStride(), x, 0.0, y);
+    } else if (a.rowStride() == 1) {
+        kernels::gemv(a.cols(), a.rows(), 1.0, a.data(), a.colStride(), x, 0.0, y);
+    } else {
+        for (size_t j = 0; j < a.cols(); ++j) {
+            double sum = 0.0;
+            for (size_t i = 0; i < a.rows(); ++i) {
+                sum += a(i, j) * x[i];
+            }
+            y[j] = sum;
+        }
+    }
+}
+
+} // namespace
+
+Vector operator*(ConstMatrixView a, const Vector& x) {
+    Vector y;
+    multiply_into(a, x, y);
+    return y;
+}
+
+Vector operator*(const Vector& x, ConstMatrixView a) {
+    Vector y;
+    multiply_transposed_into(a, x, y);
+    return y;
+}
+
+void multiply_into(ConstMatrixView a, const Vector& x, Vector& y) {
+    if (a.cols() != x.size()) {
+        throw std::invalid_argument("Matrix and vector dimensions incompatible for multiplication");
+    }
+    requireDistinct(x, y, "Output of multiply_into must not alias an input");
+    if (a.span().overlaps(MatrixSpan{y.data(), y.size(), 1, 1, 1})) {
+        throw std::invalid_argument("Output of multiply_into must not alias an input");
+    }
+
+    if (y.size() != a.rows()) {
+        y.resize(a.rows());
+    }
+    multiplyView(a, x.data(), y.data());
+}
+
+void multiply_transposed_into(ConstMatrixView a, const Vector& x, Vector& y) {
+    if (a.rows() != x.size()) {
+        throw std::invalid_argument("Matrix and vector dimensions incompatible for multiplication");
+    }
+    requireDistinct(x, y, "Output of multiply_transposed_into must not alias an input");
+    if (a.span().overlaps(MatrixSpan{y.data(), y.size(), 1, 1, 1})) {
+        throw std::invalid_argument("Output of multiply_transposed_into must not alias an input");
+    }
+
+    if (y.size() != a.cols()) {
+        y.resize(a.cols());
+    }
+    multiplyTransposedView(a, x.data(), y.data());
+}
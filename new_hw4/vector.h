@@ -0,0 +1,146 @@
+#ifndef VECTOR_H
+#define VECTOR_H
+
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <initializer_list>
+#include <cstddef>
+#include "aligned_allocator.h"
+#include "matrix.h"
+#include "matrix_view.h"
+
+// Dense vector of doubles for matrix-vector work and iterative solvers.
+//
+// Storage is 64-byte aligned like Matrix. Arithmetic is eager and runs on
+// the SIMD kernels in elementwise.h; products with a matrix go through the
+// GEMV kernels in gemv.h instead of an N x 1 Matrix product. view() makes a
+// Vector usable wherever a column ConstMatrixView is accepted.
+class Vector {
+private:
+    std::vector<double, AlignedAllocator<double>> data_;
+
+    static constexpr double EPSILON = 1e-9;
+
+    // Helper function for checking operand sizes
+    void requireSameSize(const Vector& other, const char* message) const;
+
+public:
+    // ========== CONSTRUCTORS ==========
+
+    Vector();
+
+    // Zero-initialized vector of the given size
+    explicit Vector(size_t size);
+
+    // Vector filled with value
+    Vector(size_t size, double value);
+
+    Vector(std::initializer_list<double> list);
+    explicit Vector(const std::vector<double>& values);
+
+    // Copy of a single row or column of a matrix or view
+    // (std::invalid_argument for any other shape)
+    explicit Vector(ConstMatrixView m);
+
+    // ========== ELEMENT ACCESS ==========
+
+    double& operator[](size_t i) { return data_[i]; }
+    const double& operator[](size_t i) const { return data_[i]; }
+
+    // Access with bounds checking (throw std::out_of_range)
+    double& at(size_t i);
+    const double& at(size_t i) const;
+
+    double* data() { return data_.data(); }
+    const double* data() const { return data_.data(); }
+
+    // ========== SIZE AND PROPERTIES ==========
+
+    size_t size() const { return data_.size(); }
+    bool isEmpty() const { return data_.empty(); }
+
+    // ========== CONVERSION ==========
+
+    // size() x 1 column matrix
+    Matrix toMatrix() const;
+    std::vector<double> toStdVector() const;
+
+    // The elements as a size() x 1 column, valid until the vector is
+    // resized or destroyed
+    ConstMatrixView view() const;
+    MatrixView view();
+
+    // ========== ARITHMETIC OPERATORS ==========
+
+    Vector operator+(const Vector& other) const;
+    Vector operator-(const Vector& other) const;
+    Vector operator*(double scalar) const;
+    Vector operator/(double scalar) const;
+    Vector operator-() const;
+
+    friend Vector operator*(double scalar, const Vector& v);
+
+    // ========== COMPOUND ASSIGNMENT OPERATORS ==========
+
+    Vector& operator+=(const Vector& other);
+    Vector& operator-=(const Vector& other);
+    Vector& operator*=(double scalar);
+    Vector& operator/=(double scalar);
+
+    // ========== COMPARISON OPERATORS ==========
+
+    bool operator==(const Vector& other) const;
+    bool operator!=(const Vector& other) const;
+
+    // ========== VECTOR OPERATIONS ==========
+
+    // Inner product (sizes must match) and Euclidean norm (overflow-safe).
+    // Both are reproducible pairwise reductions, see reduce.h.
+    double dot(const Vector& other) const;
+    double norm() const;
+
+    void fill(double value);
+
+    // Change the size, keeping the leading elements; new elements are zero
+    void resize(size_t size);
+
+    // ========== STATIC FACTORY METHODS ==========
+
+    static Vector zeros(size_t size);
+    static Vector ones(size_t size);
+
+    // ========== STREAM OPERATORS ==========
+
+    // Prints [1, 2.5, -3]
+    friend std::ostream& operator<<(std::ostream& os, const Vector& v);
+};
+
+// ========== LEVEL-1 ROUTINES ==========
+
+// BLAS-style names for the operations iterative solvers are written in
+
+// x . y
+double dot(const Vector& x, const Vector& y);
+
+// y += alpha * x, in place
+void axpy(double alpha, const Vector& x, Vector& y);
+
+// ||x||_2
+double nrm2(const Vector& x);
+
+// ========== MATRIX-VECTOR PRODUCTS ==========
+
+// A * x
+Vector operator*(ConstMatrixView a, const Vector& x);
+
+// x^T * A, i.e. A^T * x, without forming the transpose
+Vector operator*(const Vector& x, ConstMatrixView a);
+
+// y = A * x, resizing y only if its size differs. y must not be x.
+void multiply_into(ConstMatrixView a, const Vector& x, Vector& y);
+
+// y = A^T * x, resizing y only if its size differs. y must not be x.
+void multiply_transposed_into(ConstMatrixView a, const Vector& x, Vector& y);
+
+#endif // VECTOR_H